@@ -1,19 +1,322 @@
 #include "BoundaryConditionsExtractor.h"
 
+
+/*
+ * Pipeline sizes: the number of timesteps that can be in flight between the
+ * reading and routing stages, and the number and size of the record chunks
+ * of each subdomain file
+ */
+static const unsigned int NumTimestepSlots = 8;
+static const unsigned int NumChunksPerFile = 3;
+static const unsigned int ChunkSize = 1024*1024;
+
+/*
+ * Milliseconds between checkpoints of the subdomain files
+ */
+static const qint64 CheckpointInterval = 60*1000;
+
+/*
+ * A time slab writes its buffered records to its segment file once the
+ * buffers of all subdomains add up to this
+ */
+static const unsigned int SlabBufferSize = 8*1024*1024;
+
+
+/*
+ * A block of one subdomain's records in a time slab's segment file
+ */
+struct SegmentExtent
+{
+		quint64		offset;
+		unsigned int	length;
+};
+
+
+/*
+ * A range of timesteps that is read, routed and written to a segment file on
+ * one thread. The routing table is shared by every slab and only read.
+ */
+struct TimeSlab
+{
+		QString						filePath;
+		unsigned int					linesPerRecord;
+		bool						recordsStartWithNode;
+		bool						binary;
+		quint64						offset;		/**< Offset of the first timestep */
+		unsigned int					numTimesteps;
+		const unsigned int				*routeOffsets;
+		unsigned int					numRoutedNodes;
+		const BoundaryRoute				*routes;
+		unsigned int					numSubdomains;
+		QString						segmentPath;
+		std::vector<std::vector<SegmentExtent> >	extents;	/**< The blocks of each subdomain, in time order */
+		bool						success;
+};
+
+
+/*
+ * Copies one subdomain's blocks from every segment file into its file
+ */
+struct SegmentCopyJob
+{
+		BoundaryWriterRunnable		*writer;
+		unsigned int			subdomain;
+		const std::vector<TimeSlab>	*slabs;
+		bool				success;
+};
+
+
+/*
+ * Appends a record with its node number changed to the subdomain's. Records
+ * either start with the full domain node number (which is replaced) or have
+ * had it removed by the reader (so the subdomain node number is added).
+ */
+static void AppendRecord(std::string &buffer, unsigned int node, const BoundaryRecord &record, bool recordStartsWithNode)
+{
+	unsigned int rest = 0;
+	if (recordStartsWithNode)
+	{
+		while (rest < record.length && (record.data[rest] == ' ' || record.data[rest] == '\t'))
+			++rest;
+		while (rest < record.length && record.data[rest] >= '0' && record.data[rest] <= '9')
+			++rest;
+	}
+
+	char number[16];
+	char *end = number + sizeof(number);
+	char *start = end;
+	do {
+		*--start = '0' + node%10;
+		node /= 10;
+	} while (node);
+
+	buffer.append(start, end - start);
+	buffer.append(record.data + rest, record.length - rest);
+	if (record.length == 0 || record.data[record.length-1] != '\n')
+		buffer.push_back('\n');
+}
+
+
+/*
+ * Appends the time line and routed records of a timestep to the buffer of
+ * every subdomain. Binary timesteps and records are copied as they are, since
+ * the node numbers are only in the header.
+ */
+static void AppendTimestep(const BoundaryTimestep &timestep, bool recordsStartWithNode, bool binary, const unsigned int *routeOffsets,
+			   unsigned int numRoutedNodes, const BoundaryRoute *routes, std::string* const *buffers, unsigned int numBuffers)
+{
+	for (unsigned int i=0; i<numBuffers; ++i)
+	{
+		buffers[i]->append(timestep.timeLine, timestep.timeLineLength);
+		if (!binary)
+			buffers[i]->push_back('\n');
+	}
+
+	for (std::vector<BoundaryRecord>::const_iterator it = timestep.records.begin(); it != timestep.records.end(); ++it)
+	{
+		if (it->node >= numRoutedNodes)
+			continue;
+		for (unsigned int i=routeOffsets[it->node]; i<routeOffsets[it->node+1]; ++i)
+		{
+			if (binary)
+				buffers[routes[i].subdomain]->append(it->data, it->length);
+			else
+				AppendRecord(*buffers[routes[i].subdomain], routes[i].node, *it, recordsStartWithNode);
+		}
+	}
+}
+
+
+static bool WriteSlabBuffers(std::ofstream &segment, quint64 &segmentSize, std::vector<std::string> &buffers,
+			     std::vector<std::vector<SegmentExtent> > &extents)
+{
+	for (unsigned int i=0; i<buffers.size(); ++i)
+	{
+		if (buffers[i].empty())
+			continue;
+
+		SegmentExtent extent;
+		extent.offset = segmentSize;
+		extent.length = buffers[i].size();
+		extents[i].push_back(extent);
+
+		segment.write(buffers[i].data(), buffers[i].size());
+		segmentSize += buffers[i].size();
+		buffers[i].clear();
+	}
+	return segment.good();
+}
+
+
+static void ExtractTimeSlab(TimeSlab &slab)
+{
+	slab.success = false;
+	slab.extents.assign(slab.numSubdomains, std::vector<SegmentExtent>());
+
+	BoundaryRecordReader reader (slab.linesPerRecord, slab.recordsStartWithNode);
+	int numNodes = 0;
+	int numTimesteps = 0;
+	if (!reader.Open(slab.filePath, &numNodes, &numTimesteps) || !reader.SeekOffset(slab.offset))
+		return;
+
+	std::ofstream segment (slab.segmentPath.toStdString().data(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!segment.is_open())
+		return;
+
+	std::vector<std::string> buffers (slab.numSubdomains);
+	std::vector<std::string*> bufferPointers (slab.numSubdomains);
+	for (unsigned int i=0; i<slab.numSubdomains; ++i)
+		bufferPointers[i] = &buffers[i];
+
+	BoundaryTimestep timestep;
+	quint64 segmentSize = 0;
+	for (unsigned int ts=0; ts<slab.numTimesteps; ++ts)
+	{
+		if (!reader.ReadTimestep(numNodes, &timestep))
+			return;
+		AppendTimestep(timestep, slab.recordsStartWithNode, slab.binary, slab.routeOffsets, slab.numRoutedNodes, slab.routes,
+			       &bufferPointers[0], slab.numSubdomains);
+
+		size_t bufferedBytes = 0;
+		for (unsigned int i=0; i<slab.numSubdomains; ++i)
+			bufferedBytes += buffers[i].size();
+		if (bufferedBytes >= SlabBufferSize && !WriteSlabBuffers(segment, segmentSize, buffers, slab.extents))
+			return;
+	}
+
+	slab.success = WriteSlabBuffers(segment, segmentSize, buffers, slab.extents);
+	segment.close();
+	slab.success = slab.success && !segment.fail();
+}
+
+
+static void CopySegments(SegmentCopyJob &job)
+{
+	job.success = true;
+	std::string block;
+	for (std::vector<TimeSlab>::const_iterator slab = job.slabs->begin(); slab != job.slabs->end(); ++slab)
+	{
+		const std::vector<SegmentExtent> &extents = slab->extents[job.subdomain];
+		if (extents.empty())
+			continue;
+
+		std::ifstream segment (slab->segmentPath.toStdString().data(), std::ios::in | std::ios::binary);
+		for (unsigned int i=0; i<extents.size() && job.success; ++i)
+		{
+			block.resize(extents[i].length);
+			segment.seekg(extents[i].offset);
+			segment.read(&block[0], block.size());
+			if (!segment.good())
+				job.success = false;
+			else
+				job.writer->WriteChunk(block);
+		}
+	}
+}
+
+
 BoundaryConditionsExtractor::BoundaryConditionsExtractor() :
 	fullDomain(0),
 	projectFile(0),
-	subDomains()
+	subDomains(),
+	numTimeSlabs(0),
+	routeOffsets(),
+	routes(),
+	subdomainNodes(),
+	buffers()
 {
 }
 
+
+/**
+ * @brief Writes the boundary condition files of every subdomain
+ * @param file The project file
+ * @param full The full domain, which must have finished running
+ * @param subs The subdomains that need boundary conditions
+ * @return true if the files of every subdomain were written
+ */
 bool BoundaryConditionsExtractor::ExtractBoundaryConditions(ProjectFile *file, FullDomain *full, std::vector<SubDomain *> subs)
 {
 	fullDomain = full;
 	projectFile = file;
 	subDomains = subs;
 
-	return true;
+	if (!projectFile || !fullDomain || subDomains.empty())
+		return false;
+
+	if (!AllVersionsCompatible())
+	{
+		std::cout << "The subdomains do not use the same subdomain version as the full domain" << std::endl;
+		return false;
+	}
+
+	int version = fullDomain->GetFort015()->GetSubdomainApproach();
+	if (!CheckFullDomainFinished(version))
+	{
+		std::cout << "The full domain run has not produced its boundary condition output" << std::endl;
+		return false;
+	}
+
+	bool success = false;
+	if (version == 1)
+		success = ExtractFile(Fort065Files);
+	else if (version == 2)
+		success = ExtractFile(Fort066Files) && ExtractFile(Fort067Files);
+
+	routeOffsets.clear();
+	routes.clear();
+	subdomainNodes.clear();
+	buffers.clear();
+
+	return success;
+}
+
+
+/**
+ * @brief Sets the number of time ranges that the full domain files are split
+ * into, each of which is extracted on its own thread
+ * @param numSlabs The number of ranges, or 0 to use the reading, routing and
+ * writing pipeline
+ */
+void BoundaryConditionsExtractor::SetNumTimeSlabs(unsigned int numSlabs)
+{
+	numTimeSlabs = numSlabs;
+}
+
+
+/**
+ * @brief Extracts the boundary conditions with 1, 2, 4, 8, 16 and 32 threads,
+ * splitting the files into one time slab per thread, and prints the time
+ * and speedup of each run
+ * @return true if every run was successful
+ */
+bool BoundaryConditionsExtractor::BenchmarkTimeSlabs(ProjectFile *file, FullDomain *full, std::vector<SubDomain *> subs)
+{
+	QThreadPool *pool = QThreadPool::globalInstance();
+	int savedMaxThreads = pool->maxThreadCount();
+	unsigned int savedSlabs = numTimeSlabs;
+
+	bool success = true;
+	qint64 singleThreadTime = 0;
+	std::cout << "Threads\tTime (ms)\tSpeedup" << std::endl;
+	for (unsigned int numThreads=1; numThreads<=32 && success; numThreads*=2)
+	{
+		pool->setMaxThreadCount(numThreads);
+		numTimeSlabs = numThreads;
+
+		QElapsedTimer timer;
+		timer.start();
+		success = ExtractBoundaryConditions(file, full, subs);
+		qint64 time = std::max(timer.elapsed(), (qint64)1);
+		if (numThreads == 1)
+			singleThreadTime = time;
+
+		std::cout << numThreads << "\t" << time << "\t" << (double)singleThreadTime/time << std::endl;
+	}
+
+	pool->setMaxThreadCount(savedMaxThreads);
+	numTimeSlabs = savedSlabs;
+	return success;
 }
 
 
@@ -40,3 +343,580 @@ bool BoundaryConditionsExtractor::AllVersionsCompatible()
 	}
 	return false;
 }
+
+
+/**
+ * @brief Checks that the full domain output files needed by the subdomain
+ * version exist and aren't empty
+ */
+bool BoundaryConditionsExtractor::CheckFullDomainFinished(int version)
+{
+	QDir fullDirectory (projectFile->GetFullDomainDirectory());
+	if (version == 1)
+	{
+		if (projectFile->GetFullDomainFort065().isEmpty() && fullDirectory.exists("fort.065"))
+			projectFile->SetFullDomainFort065(fullDirectory.absoluteFilePath("fort.065"));
+		return QFileInfo(projectFile->GetFullDomainFort065()).size() > 0;
+	}
+	else if (version == 2)
+	{
+		if (projectFile->GetFullDomainFort066().isEmpty() && fullDirectory.exists("fort.066"))
+			projectFile->SetFullDomainFort066(fullDirectory.absoluteFilePath("fort.066"));
+		if (projectFile->GetFullDomainFort067().isEmpty() && fullDirectory.exists("fort.067"))
+			projectFile->SetFullDomainFort067(fullDirectory.absoluteFilePath("fort.067"));
+		return QFileInfo(projectFile->GetFullDomainFort066()).size() > 0 &&
+		       QFileInfo(projectFile->GetFullDomainFort067()).size() > 0;
+	}
+	return false;
+}
+
+
+/**
+ * @brief Builds the routing table from the bnlist.14 and py.140 files of every subdomain
+ * @param outerNodes true to route the outer boundary nodes, false for the inner ones
+ */
+bool BoundaryConditionsExtractor::BuildRoutes(bool outerNodes)
+{
+	unsigned int numSubdomains = subDomains.size();
+	std::vector<std::vector<std::pair<unsigned int, unsigned int> > > subdomainRoutes (numSubdomains);
+	unsigned int maxNode = 0;
+
+	for (unsigned int i=0; i<numSubdomains; ++i)
+	{
+		Py140 *py140 = subDomains[i]->GetPy140();
+		BNList14 bnList (subDomains[i]->GetDomainName(), projectFile);
+		std::vector<unsigned int> nodes = outerNodes ? bnList.GetOuterBoundaryNodes() : bnList.GetInnerBoundaryNodes();
+		if (!py140 || nodes.empty())
+		{
+			std::cout << "No boundary nodes found for subdomain " << subDomains[i]->GetDomainName().toStdString() << std::endl;
+			return false;
+		}
+
+		std::vector<std::pair<unsigned int, unsigned int> > &pairs = subdomainRoutes[i];
+		pairs.reserve(nodes.size());
+		for (std::vector<unsigned int>::iterator it=nodes.begin(); it != nodes.end(); ++it)
+		{
+			unsigned int fullNode = py140->ConvertNewToOld(*it);
+			if (fullNode == Py140::NoNode)
+			{
+				std::cout << "Boundary node " << *it << " of subdomain " << subDomains[i]->GetDomainName().toStdString() <<
+					     " is not in its py.140 file" << std::endl;
+				return false;
+			}
+			pairs.push_back(std::make_pair(fullNode, *it));
+			maxNode = std::max(maxNode, fullNode);
+		}
+
+		std::sort(pairs.begin(), pairs.end());
+		pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+	}
+
+	routeOffsets.assign(maxNode+2, 0);
+	for (unsigned int i=0; i<numSubdomains; ++i)
+		for (unsigned int j=0; j<subdomainRoutes[i].size(); ++j)
+			++routeOffsets[subdomainRoutes[i][j].first+1];
+	for (unsigned int i=0; i<=maxNode; ++i)
+		routeOffsets[i+1] += routeOffsets[i];
+
+	routes.resize(routeOffsets[maxNode+1]);
+	std::vector<unsigned int> fill (routeOffsets.begin(), routeOffsets.end()-1);
+	for (unsigned int i=0; i<numSubdomains; ++i)
+	{
+		for (unsigned int j=0; j<subdomainRoutes[i].size(); ++j)
+		{
+			BoundaryRoute &route = routes[fill[subdomainRoutes[i][j].first]++];
+			route.subdomain = i;
+			route.node = subdomainRoutes[i][j].second;
+		}
+	}
+
+	subdomainNodes.assign(numSubdomains, std::vector<unsigned int>());
+	return true;
+}
+
+
+/**
+ * @brief Appends the time line and routed records of a timestep to the
+ * current chunk of every subdomain
+ */
+void BoundaryConditionsExtractor::RouteTimestep(const BoundaryTimestep &timestep, bool recordsStartWithNode, bool binary)
+{
+	if (!buffers.empty())
+		AppendTimestep(timestep, recordsStartWithNode, binary, &routeOffsets[0], routeOffsets.size()-1,
+			       routes.empty() ? 0 : &routes[0], &buffers[0], buffers.size());
+}
+
+
+/**
+ * @brief Makes sure the full domain file has a record for every routed node,
+ * and lists the nodes of each subdomain in the order of the records
+ */
+bool BoundaryConditionsExtractor::CheckRoutedRecords(const BoundaryTimestep &timestep, QString fileName)
+{
+	unsigned int numNodes = routeOffsets.size()-1;
+	std::vector<unsigned char> found (numNodes, 0);
+	for (std::vector<BoundaryRecord>::const_iterator it = timestep.records.begin(); it != timestep.records.end(); ++it)
+	{
+		if (it->node < numNodes && !found[it->node])
+		{
+			found[it->node] = 1;
+			for (unsigned int i=routeOffsets[it->node]; i<routeOffsets[it->node+1]; ++i)
+				subdomainNodes[routes[i].subdomain].push_back(routes[i].node);
+		}
+	}
+
+	bool allFound = true;
+	for (unsigned int node=1; node<numNodes; ++node)
+	{
+		if (routeOffsets[node] != routeOffsets[node+1] && !found[node])
+		{
+			for (unsigned int i=routeOffsets[node]; i<routeOffsets[node+1]; ++i)
+				std::cout << "The full domain " << fileName.toStdString() << " file has no record for boundary node " <<
+					     routes[i].node << " of subdomain " << subDomains[routes[i].subdomain]->GetDomainName().toStdString() << std::endl;
+			allFound = false;
+		}
+	}
+	return allFound;
+}
+
+
+/**
+ * @brief Writes the header of every subdomain file, once the order of the
+ * nodes is known
+ * @param binaryHeader The header of the full domain file if it is in the
+ * binary layout, in which case the subdomain files are too, or 0
+ */
+void BoundaryConditionsExtractor::WriteHeaders(std::vector<BoundaryWriterRunnable*> &writers, unsigned int numTimesteps,
+					       const BoundaryBinaryHeader *binaryHeader)
+{
+	for (unsigned int i=0; i<writers.size(); ++i)
+	{
+		if (binaryHeader)
+		{
+			BoundaryBinaryHeader header = *binaryHeader;
+			header.title = "Boundary conditions for subdomain";
+			header.recordFrequency = 1;
+			header.numTimesteps = numTimesteps;
+			header.hasNodeList = true;
+			header.nodes = subdomainNodes[i];
+			writers[i]->WriteBinaryHeader(header);
+		} else {
+			writers[i]->WriteHeader(numTimesteps, subdomainNodes[i]);
+		}
+	}
+}
+
+
+/**
+ * @brief Streams one full domain file into the matching file of every subdomain
+ *
+ * If an earlier extraction of the file was stopped after a checkpoint, the
+ * unfinished subdomain files are cut back to the checkpoint and extraction
+ * continues from its timestep. The files only replace the subdomain files
+ * once they are complete.
+ */
+bool BoundaryConditionsExtractor::ExtractFile(BoundaryFileType type)
+{
+	QString fullName = type == Fort065Files ? "fort.065" : (type == Fort066Files ? "fort.066" : "fort.067");
+	QString subName = type == Fort065Files ? "fort.019" : (type == Fort066Files ? "fort.020" : "fort.021");
+
+	// Version 2 sends the inner boundary nodes to fort.021
+	if (!BuildRoutes(type != Fort067Files))
+		return false;
+
+	BoundaryReaderRunnable reader (type, projectFile);
+	if (!reader.StartReading())
+	{
+		std::cout << "Unable to read the full domain " << fullName.toStdString() << " file" << std::endl;
+		return false;
+	}
+
+	// Time slabs don't write the files in order, so they always start over
+	// The subdomain files are written in the layout of the full domain file
+	bool binary = reader.GetBinaryHeader() != 0;
+
+	unsigned int numTimesteps = reader.GetNumTimesteps();
+	std::vector<quint64> resumeOffsets;
+	unsigned int resumeTimestep = 0;
+	if (numTimeSlabs == 0)
+		resumeTimestep = FindCheckpoint(type, numTimesteps, resumeOffsets);
+	if (resumeTimestep > 0 && resumeTimestep < numTimesteps && !reader.SeekTimestep(resumeTimestep))
+		resumeTimestep = 0;
+
+	// The files are opened here because they record their locations in the project file
+	std::vector<BoundaryWriterRunnable*> writers;
+	for (unsigned int i=0; i<subDomains.size(); ++i)
+		writers.push_back(new BoundaryWriterRunnable(type, subDomains[i]->GetDomainName(), projectFile));
+
+	if (resumeTimestep > 0)
+	{
+		for (unsigned int i=0; i<writers.size(); ++i)
+			if (!writers[i]->ResumeWriting(resumeOffsets[i]))
+				resumeTimestep = 0;
+
+		if (resumeTimestep == numTimesteps)
+		{
+			std::cout << "The " << subName.toStdString() << " files were already complete" << std::endl;
+		}
+		else if (resumeTimestep > 0)
+		{
+			std::cout << "Resuming the " << subName.toStdString() << " files at timestep " << resumeTimestep+1 << std::endl;
+		} else {
+			std::cout << "Unable to resume the " << subName.toStdString() << " files, starting over" << std::endl;
+			for (unsigned int i=0; i<writers.size(); ++i)
+				writers[i]->FinishedWriting();
+			reader.SeekTimestep(0);
+		}
+	}
+
+	bool success = true;
+	if (resumeTimestep == 0)
+	{
+		SaveCheckpoint(type, writers, 0, 0);
+		for (unsigned int i=0; i<writers.size(); ++i)
+		{
+			if (!writers[i]->StartWriting(binary))
+			{
+				std::cout << "Unable to write the " << subName.toStdString() << " file for subdomain " <<
+					     subDomains[i]->GetDomainName().toStdString() << std::endl;
+				success = false;
+			}
+		}
+	}
+
+	// A run stopped after its last checkpoint only has to be committed
+	if (success && numTimeSlabs > 0)
+		success = RunTimeSlabs(type, writers, fullName);
+	else if (success && (resumeTimestep == 0 || resumeTimestep < numTimesteps))
+		success = RunPipeline(&reader, writers, type, fullName, resumeTimestep);
+
+	if (success)
+	{
+		for (unsigned int i=0; i<writers.size(); ++i)
+		{
+			if (!writers[i]->CommitFile())
+			{
+				std::cout << "Unable to move the finished " << subName.toStdString() << " file for subdomain " <<
+					     subDomains[i]->GetDomainName().toStdString() << " into place" << std::endl;
+				success = false;
+			}
+		}
+		if (success)
+			SaveCheckpoint(type, writers, 0, 0);
+	}
+
+	for (unsigned int i=0; i<writers.size(); ++i)
+		delete writers[i];
+	return success;
+}
+
+
+/**
+ * @brief Finds the timestep that an earlier extraction of a file can be resumed from
+ *
+ * The checkpoint file lists the number of timesteps in the full domain file
+ * and the number that were written, followed by the size of each subdomain's
+ * unfinished file. It is only used if it was made from a file with the same
+ * number of timesteps and lists every subdomain being extracted.
+ *
+ * A checkpoint taken after the last timestep means the files were complete
+ * but not yet moved into place.
+ *
+ * @param offsets Set to the size of each subdomain's unfinished file at the checkpoint
+ * @return The number of timesteps that were written, or 0 to start over
+ */
+unsigned int BoundaryConditionsExtractor::FindCheckpoint(BoundaryFileType type, unsigned int numTimesteps, std::vector<quint64> &offsets)
+{
+	std::ifstream file (GetCheckpointPath(type).toStdString().data());
+	unsigned int fileTimesteps = 0;
+	unsigned int timestep = 0;
+	if (!(file >> fileTimesteps >> timestep) || fileTimesteps != numTimesteps || timestep == 0 || timestep > numTimesteps)
+		return 0;
+
+	std::map<std::string, quint64> checkpointOffsets;
+	quint64 offset;
+	std::string domainName;
+	while (file >> offset && std::getline(file >> std::ws, domainName))
+		checkpointOffsets[domainName] = offset;
+
+	offsets.assign(subDomains.size(), 0);
+	for (unsigned int i=0; i<subDomains.size(); ++i)
+	{
+		std::map<std::string, quint64>::iterator it = checkpointOffsets.find(subDomains[i]->GetDomainName().toStdString());
+		if (it == checkpointOffsets.end())
+			return 0;
+		offsets[i] = it->second;
+	}
+	return timestep;
+}
+
+
+/**
+ * @brief Saves a checkpoint of every subdomain file
+ *
+ * The checkpoint is written to a temporary file, synced to disk and then
+ * renamed over the previous one, so a stop at any point leaves either the old
+ * checkpoint or the complete new one.
+ *
+ * @param timestep The number of timesteps before the checkpoint, or 0 to
+ * remove the checkpoint
+ * @param numTimesteps The number of timesteps in the full domain file
+ */
+void BoundaryConditionsExtractor::SaveCheckpoint(BoundaryFileType type, std::vector<BoundaryWriterRunnable*> &writers,
+						 unsigned int timestep, unsigned int numTimesteps)
+{
+	QString checkpointPath = GetCheckpointPath(type);
+	if (timestep == 0)
+	{
+		QFile::remove(checkpointPath);
+		return;
+	}
+
+	std::vector<quint64> offsets (writers.size());
+	for (unsigned int i=0; i<writers.size(); ++i)
+		if (!writers[i]->GetCheckpointOffset(&offsets[i]))
+			return;
+
+	QString tempPath = checkpointPath + ".part";
+	std::ofstream file (tempPath.toStdString().data(), std::ios::out | std::ios::trunc);
+	file << numTimesteps << " " << timestep << "\n";
+	for (unsigned int i=0; i<writers.size(); ++i)
+		file << offsets[i] << " " << subDomains[i]->GetDomainName().toStdString() << "\n";
+	file.close();
+
+	if (file.fail() || !FileSync::SyncFile(tempPath) || !FileSync::ReplaceFile(tempPath, checkpointPath))
+		std::cout << "Unable to save the checkpoint " << checkpointPath.toStdString() << std::endl;
+}
+
+
+/**
+ * @brief The checkpoint of a file is kept next to the full domain files,
+ * named after the subdomain files it is for
+ */
+QString BoundaryConditionsExtractor::GetCheckpointPath(BoundaryFileType type)
+{
+	QString subName = type == Fort065Files ? "fort.019" : (type == Fort066Files ? "fort.020" : "fort.021");
+	return QDir(projectFile->GetFullDomainDirectory()).absoluteFilePath(subName + ".checkpoint");
+}
+
+
+/**
+ * @brief Runs the reading and writing stages on a thread pool and the routing
+ * stage on this thread until the whole file has been written
+ *
+ * Every CheckpointInterval, the writers are asked to sync what they have
+ * written. Once all of them have, the checkpoint is saved.
+ */
+bool BoundaryConditionsExtractor::RunPipeline(BoundaryReaderRunnable *reader, std::vector<BoundaryWriterRunnable*> &writers,
+					      BoundaryFileType type, QString fileName, unsigned int firstTimestep)
+{
+	unsigned int numFiles = writers.size();
+	unsigned int numTimesteps = reader->GetNumTimesteps();
+	bool recordsStartWithNode = type == Fort066Files;
+	const BoundaryBinaryHeader *binaryHeader = reader->GetBinaryHeader();
+
+	std::vector<TimestepSlot> slots (NumTimestepSlots);
+	BoundaryQueue freeSlots (NumTimestepSlots);
+	BoundaryQueue readSlots (NumTimestepSlots);
+	for (unsigned int i=0; i<NumTimestepSlots; ++i)
+		freeSlots.Push(i);
+	reader->SetQueues(&slots, &freeSlots, &readSlots);
+
+	std::vector<std::vector<std::string> > chunks (numFiles, std::vector<std::string>(NumChunksPerFile));
+	std::vector<BoundaryQueue*> fullChunks;
+	std::vector<BoundaryQueue*> freeChunks;
+	std::vector<unsigned int> currentChunks (numFiles, 0);
+	QSemaphore checkpointsDone;
+	buffers.assign(numFiles, 0);
+	for (unsigned int i=0; i<numFiles; ++i)
+	{
+		fullChunks.push_back(new BoundaryQueue(NumChunksPerFile));
+		freeChunks.push_back(new BoundaryQueue(NumChunksPerFile));
+		for (unsigned int j=1; j<NumChunksPerFile; ++j)
+			freeChunks[i]->Push(j);
+		buffers[i] = &chunks[i][0];
+		writers[i]->SetQueues(&chunks[i], fullChunks[i], freeChunks[i], &checkpointsDone);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(numFiles + 1);
+	pool.start(reader);
+	for (unsigned int i=0; i<numFiles; ++i)
+		pool.start(writers[i]);
+
+	// Route every timestep, handing chunks to the writers as they fill up
+	bool success = true;
+	bool firstRead = true;
+	unsigned int timestepsRouted = firstTimestep;
+	unsigned int checkpointTimestep = 0;
+	QElapsedTimer checkpointTimer;
+	checkpointTimer.start();
+	for (unsigned int slot = readSlots.Pop(); slot != BoundaryQueue::EndOfData; slot = readSlots.Pop())
+	{
+		const BoundaryTimestep &timestep = slots[slot].timestep;
+		if (firstRead)
+		{
+			firstRead = false;
+			success = CheckRoutedRecords(timestep, fileName);
+			if (!success)
+				reader->Abort();
+			else if (firstTimestep == 0)
+				WriteHeaders(writers, numTimesteps, binaryHeader);
+		}
+
+		if (success)
+		{
+			RouteTimestep(timestep, recordsStartWithNode, binaryHeader != 0);
+			++timestepsRouted;
+		}
+		freeSlots.Push(slot);
+
+		bool startCheckpoint = success && checkpointTimestep == 0 && checkpointTimer.elapsed() >= CheckpointInterval;
+		for (unsigned int i=0; i<numFiles; ++i)
+		{
+			if (buffers[i]->size() >= ChunkSize || (startCheckpoint && !buffers[i]->empty()))
+			{
+				fullChunks[i]->Push(currentChunks[i]);
+				currentChunks[i] = freeChunks[i]->Pop();
+				buffers[i] = &chunks[i][currentChunks[i]];
+			}
+			if (startCheckpoint)
+				fullChunks[i]->Push(BoundaryQueue::CheckpointMarker);
+		}
+		if (startCheckpoint)
+			checkpointTimestep = timestepsRouted;
+
+		if (checkpointTimestep > 0 && checkpointsDone.tryAcquire(numFiles))
+		{
+			SaveCheckpoint(type, writers, checkpointTimestep, numTimesteps);
+			checkpointTimestep = 0;
+			checkpointTimer.restart();
+		}
+	}
+
+	for (unsigned int i=0; i<numFiles; ++i)
+	{
+		if (!buffers[i]->empty())
+			fullChunks[i]->Push(currentChunks[i]);
+		fullChunks[i]->Push(BoundaryQueue::EndOfData);
+	}
+	pool.waitForDone();
+
+	if (success && reader->ReadFailed())
+	{
+		std::cout << "The full domain " << fileName.toStdString() << " file ended early" << std::endl;
+		success = false;
+	}
+
+	// Keep the last checkpoint of an extraction that can't finish
+	if (!success && checkpointTimestep > 0 && checkpointsDone.tryAcquire(numFiles))
+		SaveCheckpoint(type, writers, checkpointTimestep, numTimesteps);
+
+	// Report how much of the time each stage spent working instead of waiting
+	qint64 totalTime = std::max(timer.nsecsElapsed(), (qint64)1);
+	qint64 readingTime = totalTime - freeSlots.GetPopBlockedTime() - readSlots.GetPushBlockedTime();
+	qint64 routingTime = totalTime - readSlots.GetPopBlockedTime();
+	qint64 writingTime = 0;
+	for (unsigned int i=0; i<numFiles; ++i)
+	{
+		routingTime -= freeChunks[i]->GetPopBlockedTime() + fullChunks[i]->GetPushBlockedTime();
+		writingTime += totalTime - fullChunks[i]->GetPopBlockedTime() - freeChunks[i]->GetPushBlockedTime();
+		delete fullChunks[i];
+		delete freeChunks[i];
+	}
+	writingTime /= std::max(numFiles, 1u);
+	std::cout << fileName.toStdString() << " extraction took " << totalTime/1000000 << " ms. Stage occupancy: reading " <<
+		     100*readingTime/totalTime << "%, routing " << 100*routingTime/totalTime << "%, writing " <<
+		     100*writingTime/totalTime << "% (average of " << numFiles << " files)" << std::endl;
+
+	buffers.clear();
+	return success;
+}
+
+
+/**
+ * @brief Splits the file into time ranges that are extracted in parallel,
+ * then copies the segments of each range into the subdomain files in order
+ */
+bool BoundaryConditionsExtractor::RunTimeSlabs(BoundaryFileType type, std::vector<BoundaryWriterRunnable*> &writers, QString fileName)
+{
+	QString filePath = type == Fort065Files ? projectFile->GetFullDomainFort065() :
+			   (type == Fort066Files ? projectFile->GetFullDomainFort066() : projectFile->GetFullDomainFort067());
+	unsigned int linesPerRecord = type == Fort066Files ? 2 : 1;
+	bool recordsStartWithNode = type == Fort066Files;
+
+	// The first timestep gives the order of the nodes in the headers
+	BoundaryRecordReader reader (linesPerRecord, recordsStartWithNode);
+	BoundaryTimestep firstTimestep;
+	int numNodes = 0;
+	int numTimesteps = 0;
+	if (!reader.Open(filePath, &numNodes, &numTimesteps) || !reader.ReadTimestep(numNodes, &firstTimestep))
+	{
+		std::cout << "Unable to read the first timestep of the full domain " << fileName.toStdString() << " file" << std::endl;
+		return false;
+	}
+	if (!CheckRoutedRecords(firstTimestep, fileName))
+		return false;
+
+	// The offsets of an ASCII file come from its TimestepIndex
+	quint64 lastOffset;
+	if (!reader.GetTimestepOffset(numTimesteps-1, &lastOffset))
+	{
+		std::cout << "The full domain " << fileName.toStdString() << " file ended early" << std::endl;
+		return false;
+	}
+
+	WriteHeaders(writers, numTimesteps, reader.GetBinaryHeader());
+
+	unsigned int numSlabs = std::min(numTimeSlabs, (unsigned int)numTimesteps);
+	std::vector<TimeSlab> slabs (numSlabs);
+	for (unsigned int i=0; i<numSlabs; ++i)
+	{
+		unsigned int first = (quint64)numTimesteps*i/numSlabs;
+		slabs[i].filePath = filePath;
+		slabs[i].linesPerRecord = linesPerRecord;
+		slabs[i].recordsStartWithNode = recordsStartWithNode;
+		slabs[i].binary = reader.IsBinary();
+		reader.GetTimestepOffset(first, &slabs[i].offset);
+		slabs[i].numTimesteps = (quint64)numTimesteps*(i+1)/numSlabs - first;
+		slabs[i].routeOffsets = &routeOffsets[0];
+		slabs[i].numRoutedNodes = routeOffsets.size()-1;
+		slabs[i].routes = routes.empty() ? 0 : &routes[0];
+		slabs[i].numSubdomains = writers.size();
+		slabs[i].segmentPath = filePath + ".slab" + QString::number(i);
+		slabs[i].success = false;
+	}
+	reader.Close();
+	QtConcurrent::blockingMap(slabs, ExtractTimeSlab);
+
+	bool success = true;
+	for (unsigned int i=0; i<numSlabs; ++i)
+		success = success && slabs[i].success;
+
+	if (success)
+	{
+		std::vector<SegmentCopyJob> jobs (writers.size());
+		for (unsigned int i=0; i<jobs.size(); ++i)
+		{
+			jobs[i].writer = writers[i];
+			jobs[i].subdomain = i;
+			jobs[i].slabs = &slabs;
+			jobs[i].success = false;
+		}
+		QtConcurrent::blockingMap(jobs, CopySegments);
+
+		for (unsigned int i=0; i<jobs.size(); ++i)
+			success = success && jobs[i].success;
+	}
+	else
+	{
+		std::cout << "Unable to extract every time range of the full domain " << fileName.toStdString() << " file" << std::endl;
+	}
+
+	for (unsigned int i=0; i<numSlabs; ++i)
+		QFile::remove(slabs[i].segmentPath);
+	return success;
+}
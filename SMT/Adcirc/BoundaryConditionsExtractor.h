@@ -2,13 +2,86 @@
 #define BOUNDARYCONDITIONSEXTRACTOR_H
 
 #include <vector>
+#include <string>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <iostream>
 
 #include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QtConcurrentMap>
 
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/BNList14.h"
+#include "Project/Files/Workers/TimestepIndex.h"
+#include "Project/Files/Workers/FileSync.h"
+#include "Adcirc/BoundaryPipeline.h"
 #include "Project/Domains/FullDomain.h"
 #include "Project/Domains/SubDomain.h"
 
+
+/**
+ * @brief One subdomain that needs the record of a full domain boundary node
+ */
+struct BoundaryRoute
+{
+		unsigned int	subdomain;	/**< Index of the subdomain in the extractor's list */
+		unsigned int	node;		/**< The node number in the subdomain */
+};
+
+
+/**
+ * @brief Turns the boundary output of a full domain run into subdomain boundary
+ * condition files
+ *
+ * The full domain files are streamed one timestep at a time, and each is read
+ * only once no matter how many subdomains there are:
+ *
+ * - Version 1: fort.065 -> fort.019 (subdomain boundary nodes from bnlist.14)
+ * - Version 2: fort.066 -> fort.020 (outer boundary nodes) and
+ *		fort.067 -> fort.021 (inner boundary nodes)
+ *
+ * Before reading, a routing table is built from every subdomain's bnlist.14 and
+ * py.140: for each full domain node number, the list of subdomains that need the
+ * node and the node's number in each of them. Each record of a timestep is
+ * then appended to the buffer of every subdomain on its route, with the node
+ * number changed to the subdomain's.
+ *
+ * Reading, routing and writing run as a pipeline. One thread reads and parses
+ * timesteps into a small pool of slots, the calling thread routes them into
+ * chunks of records for every subdomain, and one thread per subdomain file
+ * writes the chunks. The stages are connected by bounded queues of slot and
+ * chunk numbers (see BoundaryQueue), so the buffers are reused and a stage
+ * that gets ahead waits for the next one. The share of time that each stage
+ * spent working is printed at the end.
+ *
+ * When parsing is the bottleneck, SetNumTimeSlabs() splits the file into time
+ * ranges instead. The ranges are found with a TimestepIndex (or from the
+ * timestep size of a binary file) and each is read, routed and written to a
+ * temporary segment file on its own thread. The parts of each segment are
+ * then copied into the subdomain files in time order.
+ *
+ * The node list in the header of each subdomain file follows the order of the
+ * records in the full domain file, which is found from the first timestep.
+ *
+ * A full domain file in the binary layout (see BoundaryBinaryFormat) gives
+ * binary subdomain files. Its records are copied without being parsed, since
+ * their node numbers are only in the header.
+ *
+ * The subdomain files are written next to their final location and moved into
+ * place once complete. While the pipeline runs, the files are checkpointed
+ * about once a minute: they are synced to disk and the number of timesteps
+ * and size of each file are saved in a checkpoint file next to the full
+ * domain files. An extraction that is stopped picks up from its last
+ * checkpoint the next time it is run.
+ *
+ */
 class BoundaryConditionsExtractor
 {
 	public:
@@ -17,15 +90,40 @@ class BoundaryConditionsExtractor
 		bool	ExtractBoundaryConditions(ProjectFile* file,
 						  FullDomain* full,
 						  std::vector<SubDomain*> subs);
+		void	SetNumTimeSlabs(unsigned int numSlabs);
+		bool	BenchmarkTimeSlabs(ProjectFile* file,
+					   FullDomain* full,
+					   std::vector<SubDomain*> subs);
 
 	private:
 
 		FullDomain*		fullDomain;
 		ProjectFile*	projectFile;
 		std::vector<SubDomain*>	subDomains;
+		unsigned int		numTimeSlabs;	/**< 0 to use the pipeline */
+
+		std::vector<unsigned int>		routeOffsets;	/**< Offsets into routes for each full domain node number */
+		std::vector<BoundaryRoute>		routes;
+		std::vector<std::vector<unsigned int> >	subdomainNodes;	/**< The routed nodes of each subdomain, in record order */
+		std::vector<std::string*>		buffers;	/**< The chunk being filled for each subdomain */
 
 		bool	AllVersionsCompatible();
-		bool	CheckFullDomainFinished();
+		bool	CheckFullDomainFinished(int version);
+
+		bool	BuildRoutes(bool outerNodes);
+		void	RouteTimestep(const BoundaryTimestep &timestep, bool recordsStartWithNode, bool binary);
+		bool	CheckRoutedRecords(const BoundaryTimestep &timestep, QString fileName);
+		void	WriteHeaders(std::vector<BoundaryWriterRunnable*> &writers, unsigned int numTimesteps,
+				     const BoundaryBinaryHeader *binaryHeader);
+
+		bool		ExtractFile(BoundaryFileType type);
+		unsigned int	FindCheckpoint(BoundaryFileType type, unsigned int numTimesteps, std::vector<quint64> &offsets);
+		void		SaveCheckpoint(BoundaryFileType type, std::vector<BoundaryWriterRunnable*> &writers,
+					       unsigned int timestep, unsigned int numTimesteps);
+		QString		GetCheckpointPath(BoundaryFileType type);
+		bool		RunPipeline(BoundaryReaderRunnable *reader, std::vector<BoundaryWriterRunnable*> &writers,
+					    BoundaryFileType type, QString fileName, unsigned int firstTimestep);
+		bool		RunTimeSlabs(BoundaryFileType type, std::vector<BoundaryWriterRunnable*> &writers, QString fileName);
 };
 
 #endif // BOUNDARYCONDITIONSEXTRACTOR_H
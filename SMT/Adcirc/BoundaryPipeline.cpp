@@ -0,0 +1,414 @@
+#include "BoundaryPipeline.h"
+
+const unsigned int BoundaryQueue::EndOfData;
+const unsigned int BoundaryQueue::CheckpointMarker;
+
+
+BoundaryQueue::BoundaryQueue(unsigned int capacity) :
+	values(capacity, 0),
+	head(0),
+	tail(0),
+	freeCount(capacity),
+	usedCount(0),
+	pushBlockedTime(0),
+	popBlockedTime(0)
+{
+}
+
+
+/**
+ * @brief Adds a value to the queue, waiting for a free position if it is full
+ */
+void BoundaryQueue::Push(unsigned int value)
+{
+	if (!freeCount.tryAcquire())
+	{
+		QElapsedTimer timer;
+		timer.start();
+		freeCount.acquire();
+		pushBlockedTime += timer.nsecsElapsed();
+	}
+	values[tail] = value;
+	tail = (tail + 1) % values.size();
+	usedCount.release();
+}
+
+
+/**
+ * @brief Removes the oldest value from the queue, waiting for one if it is empty
+ */
+unsigned int BoundaryQueue::Pop()
+{
+	if (!usedCount.tryAcquire())
+	{
+		QElapsedTimer timer;
+		timer.start();
+		usedCount.acquire();
+		popBlockedTime += timer.nsecsElapsed();
+	}
+	unsigned int value = values[head];
+	head = (head + 1) % values.size();
+	freeCount.release();
+	return value;
+}
+
+
+qint64 BoundaryQueue::GetPushBlockedTime()
+{
+	return pushBlockedTime;
+}
+
+
+qint64 BoundaryQueue::GetPopBlockedTime()
+{
+	return popBlockedTime;
+}
+
+
+BoundaryReaderRunnable::BoundaryReaderRunnable(BoundaryFileType type, ProjectFile *projectFile) :
+	fort065(type == Fort065Files ? new Fort065(projectFile) : 0),
+	fort066(type == Fort066Files ? new Fort066(projectFile) : 0),
+	fort067(type == Fort067Files ? new Fort067(projectFile) : 0),
+	slots(0),
+	freeSlots(0),
+	readSlots(0),
+	aborted(0),
+	failed(false)
+{
+	setAutoDelete(false);
+}
+
+
+BoundaryReaderRunnable::~BoundaryReaderRunnable()
+{
+	if (fort065)
+	{
+		fort065->FinishedReading();
+		delete fort065;
+	}
+	if (fort066)
+	{
+		fort066->FinishedReading();
+		delete fort066;
+	}
+	if (fort067)
+	{
+		fort067->FinishedReading();
+		delete fort067;
+	}
+}
+
+
+bool BoundaryReaderRunnable::StartReading()
+{
+	if (fort065)
+		return fort065->StartReading();
+	if (fort066)
+		return fort066->StartReading();
+	return fort067 && fort067->StartReading();
+}
+
+
+/**
+ * @brief Starts reading at a timestep, counting from 0. Must be called before
+ * the stage is started.
+ */
+bool BoundaryReaderRunnable::SeekTimestep(int timestep)
+{
+	if (fort065)
+		return fort065->SeekTimestep(timestep);
+	if (fort066)
+		return fort066->SeekTimestep(timestep);
+	return fort067 && fort067->SeekTimestep(timestep);
+}
+
+
+int BoundaryReaderRunnable::GetNumTimesteps()
+{
+	if (fort065)
+		return fort065->GetNumTimesteps();
+	if (fort066)
+		return fort066->GetNumTimesteps();
+	return fort067 ? fort067->GetNumTimesteps() : 0;
+}
+
+
+/**
+ * @brief Returns the header of the full domain file if it is in the binary
+ * layout, or 0 if it is ASCII
+ */
+const BoundaryBinaryHeader* BoundaryReaderRunnable::GetBinaryHeader()
+{
+	if (fort065)
+		return fort065->GetBinaryHeader();
+	if (fort066)
+		return fort066->GetBinaryHeader();
+	return fort067 ? fort067->GetBinaryHeader() : 0;
+}
+
+
+/**
+ * @brief Sets the slots that timesteps are read into
+ * @param timestepSlots The slots
+ * @param freeQueue Slots that can be read into
+ * @param readQueue Slots that have been read, followed by EndOfData
+ */
+void BoundaryReaderRunnable::SetQueues(std::vector<TimestepSlot> *timestepSlots, BoundaryQueue *freeQueue, BoundaryQueue *readQueue)
+{
+	slots = timestepSlots;
+	freeSlots = freeQueue;
+	readSlots = readQueue;
+}
+
+
+/**
+ * @brief Reads every timestep of the file, then sends EndOfData
+ */
+void BoundaryReaderRunnable::run()
+{
+	while (HasNextTimestep() && aborted.fetchAndAddOrdered(0) == 0)
+	{
+		unsigned int slotIndex = freeSlots->Pop();
+		const BoundaryTimestep &timestep = GetNextTimestep();
+		if (timestep.records.empty())
+		{
+			failed = true;
+			freeSlots->Push(slotIndex);
+			break;
+		}
+
+		// The records follow the time line in the reader's buffer
+		const BoundaryRecord &lastRecord = timestep.records.back();
+		size_t numBytes = lastRecord.data + lastRecord.length - timestep.timeLine;
+		TimestepSlot &slot = (*slots)[slotIndex];
+		if (slot.bytes.size() < numBytes)
+			slot.bytes.resize(numBytes);
+		memcpy(&slot.bytes[0], timestep.timeLine, numBytes);
+
+		const char *base = &slot.bytes[0];
+		slot.timestep.timeLine = base;
+		slot.timestep.timeLineLength = timestep.timeLineLength;
+		slot.timestep.records.resize(timestep.records.size());
+		for (unsigned int i=0; i<timestep.records.size(); ++i)
+		{
+			slot.timestep.records[i].node = timestep.records[i].node;
+			slot.timestep.records[i].data = base + (timestep.records[i].data - timestep.timeLine);
+			slot.timestep.records[i].length = timestep.records[i].length;
+		}
+
+		readSlots->Push(slotIndex);
+	}
+	readSlots->Push(BoundaryQueue::EndOfData);
+}
+
+
+/**
+ * @brief Stops reading after the current timestep. Can be called from any thread.
+ */
+void BoundaryReaderRunnable::Abort()
+{
+	aborted.fetchAndStoreOrdered(1);
+}
+
+
+/**
+ * @brief Returns true if the file ended before its last timestep
+ */
+bool BoundaryReaderRunnable::ReadFailed()
+{
+	return failed;
+}
+
+
+bool BoundaryReaderRunnable::HasNextTimestep()
+{
+	if (fort065)
+		return fort065->HasNextTimestep();
+	if (fort066)
+		return fort066->HasNextTimestep();
+	return fort067 && fort067->HasNextTimestep();
+}
+
+
+const BoundaryTimestep& BoundaryReaderRunnable::GetNextTimestep()
+{
+	if (fort065)
+		return fort065->GetNextTimestep();
+	if (fort066)
+		return fort066->GetNextTimestep();
+	return fort067->GetNextTimestep();
+}
+
+
+BoundaryWriterRunnable::BoundaryWriterRunnable(BoundaryFileType type, QString domainName, ProjectFile *projectFile) :
+	fort019(type == Fort065Files ? new Fort019(domainName, projectFile) : 0),
+	fort020(type == Fort066Files ? new Fort020(domainName, projectFile) : 0),
+	fort021(type == Fort067Files ? new Fort021(domainName, projectFile) : 0),
+	chunks(0),
+	fullChunks(0),
+	freeChunks(0),
+	checkpoints(0),
+	checkpointOffset(0),
+	checkpointSynced(false)
+{
+	setAutoDelete(false);
+}
+
+
+BoundaryWriterRunnable::~BoundaryWriterRunnable()
+{
+	FinishedWriting();
+	delete fort019;
+	delete fort020;
+	delete fort021;
+}
+
+
+bool BoundaryWriterRunnable::StartWriting(bool binary)
+{
+	if (fort019)
+		return fort019->StartWriting(binary);
+	if (fort020)
+		return fort020->StartWriting(binary);
+	return fort021 && fort021->StartWriting(binary);
+}
+
+
+/**
+ * @brief Continues an unfinished file from the offset of a checkpoint
+ */
+bool BoundaryWriterRunnable::ResumeWriting(quint64 offset)
+{
+	if (fort019)
+		return fort019->ResumeWriting(offset);
+	if (fort020)
+		return fort020->ResumeWriting(offset);
+	return fort021 && fort021->ResumeWriting(offset);
+}
+
+
+/**
+ * @brief Writes the header of the file. Must be called before the first chunk
+ * is queued, so it is never called while the stage is writing.
+ */
+void BoundaryWriterRunnable::WriteHeader(int numTimesteps, std::vector<unsigned int> nodeList)
+{
+	if (fort019)
+		fort019->WriteHeader(numTimesteps, nodeList);
+	else if (fort020)
+		fort020->WriteHeader(numTimesteps, nodeList);
+	else if (fort021)
+		fort021->WriteHeader(numTimesteps, nodeList);
+}
+
+
+/**
+ * @brief Writes the header of a binary file, in place of WriteHeader()
+ */
+void BoundaryWriterRunnable::WriteBinaryHeader(const BoundaryBinaryHeader &header)
+{
+	if (fort019)
+		fort019->WriteBinaryHeader(header);
+	else if (fort020)
+		fort020->WriteBinaryHeader(header);
+	else if (fort021)
+		fort021->WriteBinaryHeader(header);
+}
+
+
+/**
+ * @brief Sets the chunks that are written
+ * @param chunkBuffers The chunks
+ * @param fullQueue Chunks that are ready to be written and checkpoint
+ * markers, followed by EndOfData
+ * @param freeQueue Chunks that have been written and can be refilled
+ * @param checkpointsDone Released once for every checkpoint marker
+ */
+void BoundaryWriterRunnable::SetQueues(std::vector<std::string> *chunkBuffers, BoundaryQueue *fullQueue, BoundaryQueue *freeQueue,
+				       QSemaphore *checkpointsDone)
+{
+	chunks = chunkBuffers;
+	fullChunks = fullQueue;
+	freeChunks = freeQueue;
+	checkpoints = checkpointsDone;
+}
+
+
+/**
+ * @brief Writes chunks until EndOfData is received
+ */
+void BoundaryWriterRunnable::run()
+{
+	for (unsigned int chunkIndex = fullChunks->Pop(); chunkIndex != BoundaryQueue::EndOfData; chunkIndex = fullChunks->Pop())
+	{
+		if (chunkIndex == BoundaryQueue::CheckpointMarker)
+		{
+			checkpointSynced = Checkpoint();
+			checkpoints->release();
+			continue;
+		}
+
+		WriteChunk((*chunks)[chunkIndex]);
+		(*chunks)[chunkIndex].clear();
+		freeChunks->Push(chunkIndex);
+	}
+}
+
+
+/**
+ * @brief Writes a block of records to the file
+ */
+void BoundaryWriterRunnable::WriteChunk(const std::string &chunk)
+{
+	if (fort019)
+		fort019->WriteBytes(chunk.data(), chunk.size());
+	else if (fort020)
+		fort020->WriteBytes(chunk.data(), chunk.size());
+	else if (fort021)
+		fort021->WriteBytes(chunk.data(), chunk.size());
+}
+
+
+/**
+ * @brief Gets the offset of the last checkpoint
+ * @return false if the data before the checkpoint couldn't be synced to disk
+ */
+bool BoundaryWriterRunnable::GetCheckpointOffset(quint64 *offset)
+{
+	*offset = checkpointOffset;
+	return checkpointSynced;
+}
+
+
+void BoundaryWriterRunnable::FinishedWriting()
+{
+	if (fort019)
+		fort019->FinishedWriting();
+	else if (fort020)
+		fort020->FinishedWriting();
+	else if (fort021)
+		fort021->FinishedWriting();
+}
+
+
+/**
+ * @brief Closes the finished file and moves it into place
+ */
+bool BoundaryWriterRunnable::CommitFile()
+{
+	if (fort019)
+		return fort019->CommitFile();
+	if (fort020)
+		return fort020->CommitFile();
+	return fort021 && fort021->CommitFile();
+}
+
+
+bool BoundaryWriterRunnable::Checkpoint()
+{
+	if (fort019)
+		return fort019->Checkpoint(&checkpointOffset);
+	if (fort020)
+		return fort020->Checkpoint(&checkpointOffset);
+	return fort021 && fort021->Checkpoint(&checkpointOffset);
+}
@@ -0,0 +1,166 @@
+#ifndef BOUNDARYPIPELINE_H
+#define BOUNDARYPIPELINE_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QString>
+
+#include "adcData.h"
+#include "Project/Files/ProjectFile.h"
+#include "Project/Files/Fort065.h"
+#include "Project/Files/Fort066.h"
+#include "Project/Files/Fort067.h"
+#include "Project/Files/Fort019.h"
+#include "Project/Files/Fort020.h"
+#include "Project/Files/Fort021.h"
+
+
+/**
+ * @brief A bounded queue of slot numbers between two pipeline stages
+ *
+ * Used by exactly one producer and one consumer thread. The ring positions are
+ * only touched by their own side, and the two semaphores both count the free
+ * and used slots and make the values visible to the other side. A producer
+ * that gets ahead blocks in Push() until the consumer frees a slot, which is
+ * the pipeline's backpressure. The time each side spends blocked is recorded
+ * so stage occupancy can be reported.
+ *
+ * Besides slot numbers, a queue can carry EndOfData and, to the writers,
+ * CheckpointMarker.
+ */
+class BoundaryQueue
+{
+	public:
+		BoundaryQueue(unsigned int capacity);
+
+		static const unsigned int	EndOfData = 0xFFFFFFFF;
+		static const unsigned int	CheckpointMarker = 0xFFFFFFFE;
+
+		void		Push(unsigned int value);
+		unsigned int	Pop();
+		qint64		GetPushBlockedTime();
+		qint64		GetPopBlockedTime();
+
+	private:
+
+		std::vector<unsigned int>	values;
+		unsigned int			head;		/**< Next value to pop, only used by the consumer */
+		unsigned int			tail;		/**< Next free position, only used by the producer */
+		QSemaphore			freeCount;
+		QSemaphore			usedCount;
+		qint64				pushBlockedTime;	/**< Nanoseconds */
+		qint64				popBlockedTime;		/**< Nanoseconds */
+};
+
+
+/**
+ * @brief A timestep that has been read and handed to the router stage
+ *
+ * The bytes of the timestep are copied out of the reader's buffer so several
+ * timesteps can be in flight at once. The byte buffer is reused, so it stops
+ * allocating once it has grown to the size of a timestep.
+ */
+struct TimestepSlot
+{
+		std::vector<char>	bytes;
+		BoundaryTimestep	timestep;	/**< Points into bytes */
+};
+
+
+/**
+ * @brief The full domain file that is read and the subdomain files that are written
+ */
+enum BoundaryFileType {Fort065Files, Fort066Files, Fort067Files};
+
+
+/**
+ * @brief The reading stage: reads and parses full domain timesteps into free slots
+ *
+ * Owns the reader of the full domain file. StartReading() should be called on
+ * the thread that owns the project file, before the stage is started.
+ */
+class BoundaryReaderRunnable : public QRunnable
+{
+	public:
+		BoundaryReaderRunnable(BoundaryFileType type, ProjectFile *projectFile);
+		~BoundaryReaderRunnable();
+
+		bool	StartReading();
+		bool	SeekTimestep(int timestep);
+		int	GetNumTimesteps();
+		const BoundaryBinaryHeader*	GetBinaryHeader();
+		void	SetQueues(std::vector<TimestepSlot> *timestepSlots, BoundaryQueue *freeQueue, BoundaryQueue *readQueue);
+
+		void	run();
+		void	Abort();
+		bool	ReadFailed();
+
+	private:
+
+		Fort065*			fort065;
+		Fort066*			fort066;
+		Fort067*			fort067;
+		std::vector<TimestepSlot>*	slots;
+		BoundaryQueue*			freeSlots;
+		BoundaryQueue*			readSlots;
+		QAtomicInt			aborted;
+		bool				failed;
+
+		bool				HasNextTimestep();
+		const BoundaryTimestep&		GetNextTimestep();
+};
+
+
+/**
+ * @brief The writing stage of one subdomain file: writes the chunks of records
+ * built by the router
+ *
+ * Owns the writer of the subdomain file. StartWriting() or ResumeWriting()
+ * should be called on the thread that owns the project file, before the stage
+ * is started.
+ *
+ * When a CheckpointMarker is received, everything written so far is synced to
+ * disk and the size of the file is kept for GetCheckpointOffset(), then the
+ * checkpoint semaphore is released.
+ */
+class BoundaryWriterRunnable : public QRunnable
+{
+	public:
+		BoundaryWriterRunnable(BoundaryFileType type, QString domainName, ProjectFile *projectFile);
+		~BoundaryWriterRunnable();
+
+		bool	StartWriting(bool binary);
+		bool	ResumeWriting(quint64 offset);
+		void	WriteHeader(int numTimesteps, std::vector<unsigned int> nodeList);
+		void	WriteBinaryHeader(const BoundaryBinaryHeader &header);
+		void	SetQueues(std::vector<std::string> *chunkBuffers, BoundaryQueue *fullQueue, BoundaryQueue *freeQueue,
+				  QSemaphore *checkpointsDone);
+		void	WriteChunk(const std::string &chunk);
+		bool	GetCheckpointOffset(quint64 *offset);
+		void	FinishedWriting();
+		bool	CommitFile();
+
+		void	run();
+
+	private:
+
+		Fort019*			fort019;
+		Fort020*			fort020;
+		Fort021*			fort021;
+		std::vector<std::string>*	chunks;
+		BoundaryQueue*			fullChunks;
+		BoundaryQueue*			freeChunks;
+		QSemaphore*			checkpoints;
+		quint64				checkpointOffset;
+		bool				checkpointSynced;
+
+		bool	Checkpoint();
+};
+
+#endif // BOUNDARYPIPELINE_H
@@ -0,0 +1,285 @@
+#include "MaxeleComparison.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAXELECOMPARISON_SSE2
+#include <emmintrin.h>
+#endif
+
+
+/*
+ * Subdomains are split into chunks of at least this many nodes
+ */
+static const unsigned int MinChunkSize = 16*1024;
+
+/*
+ * The number of full domain values gathered before they are compared
+ */
+static const unsigned int BlockSize = 256;
+
+
+/*
+ * A range of nodes in one subdomain, compared on one thread
+ */
+struct ComparisonChunk
+{
+		const float			*fullMaxele;
+		unsigned int			numFullNodes;
+		const unsigned int		*newToOld;
+		const float			*subMaxele;
+		float				*differences;
+		unsigned int			firstNode;	/**< The subdomain node number of the first node */
+		unsigned int			count;
+		unsigned int			result;		/**< The index of the subdomain's result */
+		unsigned int			numBins;
+		float				binWidth;
+		unsigned int			numWorstNodes;
+
+		bool				valid;
+		double				sumSquares;
+		float				maxAbsError;
+		float				minDifference;
+		float				maxDifference;
+		std::vector<unsigned int>	histogram;
+		std::vector<MaxeleNodeError>	worstNodes;	/**< A heap with the smallest of the worst nodes first */
+};
+
+
+static bool LargerError(const MaxeleNodeError &error1, const MaxeleNodeError &error2)
+{
+	return fabs(error1.difference) > fabs(error2.difference);
+}
+
+
+static void CompareChunk(ComparisonChunk &chunk)
+{
+	chunk.valid = true;
+	chunk.sumSquares = 0.0;
+	chunk.maxAbsError = 0.0;
+	chunk.minDifference = chunk.count ? 1e30f : 0.0f;
+	chunk.maxDifference = chunk.count ? -1e30f : 0.0f;
+	chunk.histogram.assign(chunk.numBins, 0);
+	chunk.worstNodes.clear();
+	float worstThreshold = -1.0;
+
+	float gathered[BlockSize];
+	for (unsigned int start=0; start<chunk.count; start+=BlockSize)
+	{
+		unsigned int n = std::min(BlockSize, chunk.count - start);
+		for (unsigned int i=0; i<n; ++i)
+		{
+			// Node 0 wraps around and fails the test too
+			unsigned int fullIndex = chunk.newToOld[start+i] - 1;
+			if (fullIndex >= chunk.numFullNodes)
+			{
+				chunk.valid = false;
+				return;
+			}
+			gathered[i] = chunk.fullMaxele[fullIndex];
+		}
+
+		const float *sub = chunk.subMaxele + start;
+		float *difference = chunk.differences + start;
+		unsigned int i = 0;
+
+#ifdef MAXELECOMPARISON_SSE2
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		__m128 sumSquares = _mm_setzero_ps();
+		__m128 maxAbs = _mm_set1_ps(chunk.maxAbsError);
+		__m128 minimum = _mm_set1_ps(chunk.minDifference);
+		__m128 maximum = _mm_set1_ps(chunk.maxDifference);
+		for (; i+4 <= n; i += 4)
+		{
+			__m128 d = _mm_sub_ps(_mm_loadu_ps(gathered + i), _mm_loadu_ps(sub + i));
+			_mm_storeu_ps(difference + i, d);
+			sumSquares = _mm_add_ps(sumSquares, _mm_mul_ps(d, d));
+			maxAbs = _mm_max_ps(maxAbs, _mm_and_ps(d, absMask));
+			minimum = _mm_min_ps(minimum, d);
+			maximum = _mm_max_ps(maximum, d);
+		}
+
+		float lanes[4];
+		_mm_storeu_ps(lanes, sumSquares);
+		chunk.sumSquares += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		_mm_storeu_ps(lanes, maxAbs);
+		chunk.maxAbsError = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+		_mm_storeu_ps(lanes, minimum);
+		chunk.minDifference = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+		_mm_storeu_ps(lanes, maximum);
+		chunk.maxDifference = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+#endif
+
+		for (; i<n; ++i)
+		{
+			float d = gathered[i] - sub[i];
+			difference[i] = d;
+			chunk.sumSquares += d*d;
+			chunk.maxAbsError = std::max(chunk.maxAbsError, (float)fabs(d));
+			chunk.minDifference = std::min(chunk.minDifference, d);
+			chunk.maxDifference = std::max(chunk.maxDifference, d);
+		}
+
+		// The histogram and worst nodes are taken from the block while it is still in cache
+		for (i=0; i<n; ++i)
+		{
+			float absError = fabs(difference[i]);
+			float bin = absError / chunk.binWidth;
+			++chunk.histogram[bin < chunk.numBins - 1 ? (unsigned int)bin : chunk.numBins - 1];
+
+			if (chunk.numWorstNodes > 0 && absError > worstThreshold)
+			{
+				MaxeleNodeError error;
+				error.node = chunk.firstNode + start + i;
+				error.difference = difference[i];
+				if (chunk.worstNodes.size() == chunk.numWorstNodes)
+				{
+					std::pop_heap(chunk.worstNodes.begin(), chunk.worstNodes.end(), LargerError);
+					chunk.worstNodes.back() = error;
+				} else {
+					chunk.worstNodes.push_back(error);
+				}
+				std::push_heap(chunk.worstNodes.begin(), chunk.worstNodes.end(), LargerError);
+				if (chunk.worstNodes.size() == chunk.numWorstNodes)
+					worstThreshold = fabs(chunk.worstNodes.front().difference);
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Constructor
+ * @param numWorstNodes The number of nodes with the largest differences to list
+ * @param numBins The number of histogram bins
+ * @param binWidth The width of each histogram bin, in the units of the maxele
+ */
+MaxeleComparison::MaxeleComparison(unsigned int numWorstNodes, unsigned int numBins, float binWidth) :
+	numWorstNodes(numWorstNodes),
+	numBins(std::max(numBins, 1u)),
+	binWidth(binWidth > 0.0 ? binWidth : 0.01)
+{
+}
+
+
+/**
+ * @brief Compares the maxele of one subdomain with the full domain
+ * @return false if py.140 refers to nodes the full domain doesn't have
+ */
+bool MaxeleComparison::Compare(const std::vector<float> &fullMaxele, const MaxeleComparisonInput &input, MaxeleComparisonResult *result)
+{
+	std::vector<MaxeleComparisonInput> inputs (1, input);
+	std::vector<MaxeleComparisonResult> results;
+	bool valid = CompareAll(fullMaxele, inputs, &results);
+	*result = results[0];
+	return valid;
+}
+
+
+/**
+ * @brief Compares the maxele of several subdomains with the full domain at once
+ * @param results Set to one result for each input, in the same order
+ * @return false if any of the subdomains couldn't be compared
+ */
+bool MaxeleComparison::CompareAll(const std::vector<float> &fullMaxele, const std::vector<MaxeleComparisonInput> &inputs,
+				  std::vector<MaxeleComparisonResult> *results)
+{
+	results->assign(inputs.size(), MaxeleComparisonResult());
+
+	std::vector<ComparisonChunk> chunks;
+	unsigned int maxChunks = 4*std::max(QThread::idealThreadCount(), 1);
+	for (unsigned int s=0; s<inputs.size(); ++s)
+	{
+		MaxeleComparisonResult &result = (*results)[s];
+		unsigned int numNodes = std::min(inputs[s].newToOld->size(), inputs[s].maxele->size());
+		result.name = inputs[s].name;
+		result.numNodes = numNodes;
+		result.differences.resize(numNodes);
+
+		unsigned int numChunks = std::min(maxChunks, numNodes/MinChunkSize + 1);
+		for (unsigned int i=0; i<numChunks; ++i)
+		{
+			ComparisonChunk chunk;
+			unsigned int first = (quint64)numNodes*i/numChunks;
+			unsigned int last = (quint64)numNodes*(i+1)/numChunks;
+			chunk.fullMaxele = fullMaxele.empty() ? 0 : &fullMaxele[0];
+			chunk.numFullNodes = fullMaxele.size();
+			chunk.newToOld = numNodes ? &(*inputs[s].newToOld)[first] : 0;
+			chunk.subMaxele = numNodes ? &(*inputs[s].maxele)[first] : 0;
+			chunk.differences = numNodes ? &result.differences[first] : 0;
+			chunk.firstNode = first + 1;
+			chunk.count = last - first;
+			chunk.result = s;
+			chunk.numBins = numBins;
+			chunk.binWidth = binWidth;
+			chunk.numWorstNodes = numWorstNodes;
+			chunks.push_back(chunk);
+		}
+	}
+	QtConcurrent::blockingMap(chunks, CompareChunk);
+
+	for (unsigned int s=0; s<results->size(); ++s)
+	{
+		MaxeleComparisonResult &result = (*results)[s];
+		result.valid = true;
+		result.rmse = 0.0;
+		result.maxAbsError = 0.0;
+		result.minDifference = result.numNodes ? 1e30f : 0.0f;
+		result.maxDifference = result.numNodes ? -1e30f : 0.0f;
+		result.histogram.assign(numBins, 0);
+	}
+
+	for (std::vector<ComparisonChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+	{
+		MaxeleComparisonResult &result = (*results)[it->result];
+		result.valid = result.valid && it->valid;
+		result.rmse += it->sumSquares;
+		result.maxAbsError = std::max(result.maxAbsError, it->maxAbsError);
+		result.minDifference = std::min(result.minDifference, it->minDifference);
+		result.maxDifference = std::max(result.maxDifference, it->maxDifference);
+		for (unsigned int i=0; i<numBins && i<it->histogram.size(); ++i)
+			result.histogram[i] += it->histogram[i];
+		result.worstNodes.insert(result.worstNodes.end(), it->worstNodes.begin(), it->worstNodes.end());
+	}
+
+	bool allValid = true;
+	for (unsigned int s=0; s<results->size(); ++s)
+	{
+		MaxeleComparisonResult &result = (*results)[s];
+		result.rmse = result.numNodes ? sqrt(result.rmse / result.numNodes) : 0.0;
+		std::sort(result.worstNodes.begin(), result.worstNodes.end(), LargerError);
+		if (result.worstNodes.size() > numWorstNodes)
+			result.worstNodes.resize(numWorstNodes);
+
+		if (!result.valid)
+		{
+			std::cout << "The py.140 of " << result.name.toStdString() << " doesn't match the full domain maxele" << std::endl;
+			result.differences.clear();
+			allValid = false;
+		}
+	}
+	return allValid;
+}
+
+
+/**
+ * @brief Prints a result to stdout
+ */
+void MaxeleComparison::PrintSummary(const MaxeleComparisonResult &result)
+{
+	std::cout << "Maxele comparison for " << result.name.toStdString() << ": " << result.numNodes << " nodes" << std::endl;
+	if (!result.valid)
+	{
+		std::cout << "\tNot compared" << std::endl;
+		return;
+	}
+	std::cout << "\tRMSE: " << result.rmse << std::endl;
+	std::cout << "\tMax absolute error: " << result.maxAbsError << std::endl;
+	std::cout << "\tDifference range: " << result.minDifference << " to " << result.maxDifference << std::endl;
+	std::cout << "\tHistogram of absolute errors:";
+	for (unsigned int i=0; i<result.histogram.size(); ++i)
+		std::cout << " " << result.histogram[i];
+	std::cout << std::endl;
+	std::cout << "\tWorst nodes:";
+	for (unsigned int i=0; i<result.worstNodes.size(); ++i)
+		std::cout << " " << result.worstNodes[i].node << " (" << result.worstNodes[i].difference << ")";
+	std::cout << std::endl;
+}
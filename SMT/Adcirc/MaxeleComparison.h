@@ -0,0 +1,86 @@
+#ifndef MAXELECOMPARISON_H
+#define MAXELECOMPARISON_H
+
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include <QString>
+#include <QThread>
+#include <QtConcurrentMap>
+
+
+/**
+ * @brief The maxele of one subdomain and how its nodes map to the full domain
+ */
+struct MaxeleComparisonInput
+{
+		QString				name;
+		const std::vector<unsigned int>	*newToOld;	/**< Full domain number of subdomain node i+1, from py.140 */
+		const std::vector<float>	*maxele;	/**< Subdomain maxele of every node */
+};
+
+
+/**
+ * @brief A subdomain node and the difference between its full domain and
+ * subdomain maxele
+ */
+struct MaxeleNodeError
+{
+		unsigned int	node;		/**< The node number in the subdomain */
+		float		difference;
+};
+
+
+/**
+ * @brief How closely the maxele of a subdomain matches the full domain
+ */
+struct MaxeleComparisonResult
+{
+		QString				name;
+		bool				valid;		/**< false if py.140 refers to nodes the full domain doesn't have */
+		unsigned int			numNodes;
+		double				rmse;
+		float				maxAbsError;
+		float				minDifference;
+		float				maxDifference;
+		std::vector<unsigned int>	histogram;	/**< Counts of absolute differences, the last bin holds everything larger */
+		std::vector<MaxeleNodeError>	worstNodes;	/**< The largest absolute differences, largest first */
+		std::vector<float>		differences;	/**< Full domain minus subdomain maxele of every subdomain node */
+};
+
+
+/**
+ * @brief Compares the maxele of subdomains with the full domain
+ *
+ * The difference at each subdomain node is the full domain maxele minus the
+ * subdomain maxele. The full domain values are gathered through the dense new
+ * to old table of py.140 in small blocks, and each block is subtracted and
+ * summarized with SSE2 where it is available. The RMSE, largest absolute
+ * error, histogram and worst nodes are all gathered in that same pass.
+ *
+ * Every subdomain is split into chunks of nodes, and the chunks of all the
+ * subdomains being compared are run in parallel together, so comparing
+ * several small subdomains keeps every thread busy.
+ *
+ */
+class MaxeleComparison
+{
+	public:
+		MaxeleComparison(unsigned int numWorstNodes=10, unsigned int numBins=20, float binWidth=0.01);
+
+		bool	Compare(const std::vector<float> &fullMaxele, const MaxeleComparisonInput &input, MaxeleComparisonResult *result);
+		bool	CompareAll(const std::vector<float> &fullMaxele, const std::vector<MaxeleComparisonInput> &inputs,
+				   std::vector<MaxeleComparisonResult> *results);
+
+		static void	PrintSummary(const MaxeleComparisonResult &result);
+
+	private:
+
+		unsigned int	numWorstNodes;
+		unsigned int	numBins;
+		float		binWidth;
+};
+
+#endif // MAXELECOMPARISON_H
@@ -1,9 +1,322 @@
 #include "SubdomainCreator.h"
 
+
+/*
+ * Everything needed to write the files of one subdomain. The file objects are
+ * created (and their locations recorded in the project file) before any files
+ * are written, so writing never touches the project file.
+ */
+struct SubdomainJob
+{
+		QString				name;
+		QString				fort14Path;
+		std::vector<Element*>		elements;
+		std::vector<Node*>		nodes;
+		Py140				*py140;
+		Py141				*py141;
+		BNList14			*bnList;
+		Fort13				*fort13;
+		Fort13Carver			*carver;
+		std::vector<unsigned int>	boundaryNodes;
+		NodeOrdering			ordering;
+		unsigned int			bandwidthBefore;
+		unsigned int			bandwidthAfter;
+		QString				error;
+};
+
+
+/*
+ * The files that can be written independently once a subdomain is numbered
+ */
+enum SubdomainFile {Fort14File, Fort13File, Py140File, Py141File, BNListFile};
+
+
+/*
+ * One file of a subdomain, written on a worker thread
+ */
+struct EmissionTask
+{
+		SubdomainJob	*job;
+		SubdomainFile	file;
+		bool		written;
+};
+
+
+/*
+ * A range of elements whose nodes are marked in the node table on one thread.
+ * Every element writes the same pointer into a node's slot, so chunks don't
+ * need to coordinate.
+ */
+struct NodeMarkChunk
+{
+		Element* const		*elements;
+		unsigned int		begin;
+		unsigned int		end;
+		Node			**slots;
+};
+
+
+/*
+ * A range of the node table that is compacted into a list on one thread
+ */
+struct NodeGatherChunk
+{
+		Node* const		*slots;
+		unsigned int		begin;
+		unsigned int		end;
+		std::vector<Node*>	nodes;
+};
+
+
+static void MarkNodes(NodeMarkChunk &chunk)
+{
+	for (unsigned int i=chunk.begin; i<chunk.end; ++i)
+	{
+		Element *currElement = chunk.elements[i];
+		if (currElement)
+		{
+			chunk.slots[currElement->n1->nodeNumber-1] = currElement->n1;
+			chunk.slots[currElement->n2->nodeNumber-1] = currElement->n2;
+			chunk.slots[currElement->n3->nodeNumber-1] = currElement->n3;
+		}
+	}
+}
+
+
+static void GatherNodes(NodeGatherChunk &chunk)
+{
+	for (unsigned int i=chunk.begin; i<chunk.end; ++i)
+		if (chunk.slots[i])
+			chunk.nodes.push_back(chunk.slots[i]);
+}
+
+
+/*
+ * Finds the unique nodes of a list of elements, in full domain node order
+ */
+static std::vector<Node*> FindElementNodes(const std::vector<Element*> &elements)
+{
+	std::vector<Node*> nodes;
+
+	unsigned int numSlots = 0;
+	for (std::vector<Element*>::const_iterator it=elements.begin(); it != elements.end(); ++it)
+		if (*it)
+			numSlots = std::max(numSlots, std::max((*it)->n1->nodeNumber, std::max((*it)->n2->nodeNumber, (*it)->n3->nodeNumber)));
+	if (numSlots == 0)
+		return nodes;
+
+	// Mark every node used by an element in a table indexed by node number - 1
+	std::vector<Node*> slots (numSlots, (Node*)0);
+	unsigned int numThreads = std::max(QThread::idealThreadCount(), 1);
+	unsigned int numChunks = std::min(4*numThreads, (unsigned int)elements.size()/4096 + 1);
+	std::vector<NodeMarkChunk> markChunks (numChunks);
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		markChunks[i].elements = &elements[0];
+		markChunks[i].begin = (quint64)elements.size()*i/numChunks;
+		markChunks[i].end = (quint64)elements.size()*(i+1)/numChunks;
+		markChunks[i].slots = &slots[0];
+	}
+	QtConcurrent::blockingMap(markChunks, MarkNodes);
+
+	// Compact the table, which leaves the nodes in node number order
+	numChunks = std::min(4*numThreads, numSlots/4096 + 1);
+	std::vector<NodeGatherChunk> gatherChunks (numChunks);
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		gatherChunks[i].slots = &slots[0];
+		gatherChunks[i].begin = (quint64)numSlots*i/numChunks;
+		gatherChunks[i].end = (quint64)numSlots*(i+1)/numChunks;
+	}
+	QtConcurrent::blockingMap(gatherChunks, GatherNodes);
+
+	unsigned int numNodes = 0;
+	for (unsigned int i=0; i<numChunks; ++i)
+		numNodes += gatherChunks[i].nodes.size();
+	nodes.reserve(numNodes);
+	for (unsigned int i=0; i<numChunks; ++i)
+		nodes.insert(nodes.end(), gatherChunks[i].nodes.begin(), gatherChunks[i].nodes.end());
+	return nodes;
+}
+
+
+static bool WriteFort14(QString targetPath, QString title, const std::vector<Node*> &selectedNodes,
+			const std::vector<Element*> &selectedElements, Py140 *py140, Py141 *py141,
+			const std::vector<unsigned int> &boundaryNodes)
+{
+	std::ofstream fort14File (targetPath.toStdString().data());
+	if (fort14File.is_open() && py140 && py141)
+	{
+		// Write title line
+		fort14File << title.toStdString().data() << "\n";
+
+		// Write info line
+		fort14File << selectedElements.size() << " " << selectedNodes.size() << "\n";
+
+		// Write nodes
+		Node *currNode = 0;
+		for (std::vector<Node*>::const_iterator it = selectedNodes.begin(); it != selectedNodes.end(); ++it)
+		{
+			currNode = *it;
+			if (currNode)
+			{
+				fort14File << "\t" <<
+					      py140->ConvertOldToNew(currNode->nodeNumber) << "\t" <<
+					      currNode->xDat << "\t" <<
+					      currNode->yDat << "\t" <<
+					      currNode->zDat << "\n";
+			}
+		}
+
+		// Write elements
+		Element *currElement = 0;
+		for (std::vector<Element*>::const_iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
+		{
+			currElement = *it;
+			if (currElement)
+			{
+				fort14File << py141->ConvertOldToNew(currElement->elementNumber) << "\t3\t" <<
+					      py140->ConvertOldToNew(currElement->n1->nodeNumber) << "\t" <<
+					      py140->ConvertOldToNew(currElement->n2->nodeNumber) << "\t" <<
+					      py140->ConvertOldToNew(currElement->n3->nodeNumber) << "\n";
+			}
+		}
+
+		// Write boundaries
+        if (boundaryNodes.size() > 0)
+        {
+            fort14File << "1\t!no. of open boundary segments\n";
+            fort14File << boundaryNodes.size() + 1 << "\t!total no. of open boundary nodes\n";
+            fort14File << boundaryNodes.size() + 1 << "\t!no. of open boundary nodes  in segment 1\n";
+
+            for (std::vector<unsigned int>::const_iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
+            {
+
+                fort14File << py140->ConvertOldToNew(*it) << "\n";
+            }
+            fort14File << py140->ConvertOldToNew(boundaryNodes[0]) << "\n";
+        } else {
+            fort14File << "0\t!no. of open boundary segments\n";
+            fort14File << "0\t!no. of open boundary nodes\n";
+        }
+		fort14File << "0\t!no. of land boundary segments\n";
+		fort14File << "0\t!no. of land boundary nodes\n";
+
+		// Close the file
+		fort14File.close();
+
+		return true;
+	}
+	return false;
+}
+
+
+/*
+ * Fills the py.140 and py.141 tables, which every other file uses to convert
+ * full domain numbers to subdomain numbers. The node and element lists are
+ * reordered first if the job asks for it.
+ */
+static void NumberSubdomain(SubdomainJob &job)
+{
+	job.bandwidthBefore = 0;
+	job.bandwidthAfter = 0;
+	if (job.ordering != FullDomainOrdering)
+	{
+		MeshRenumberer renumberer (&job.nodes, &job.elements);
+		if (renumberer.Renumber(job.ordering))
+		{
+			job.bandwidthBefore = renumberer.GetBandwidthBefore();
+			job.bandwidthAfter = renumberer.GetBandwidthAfter();
+		}
+	}
+
+	std::vector<unsigned int> oldNodes;
+	oldNodes.reserve(job.nodes.size());
+	for (std::vector<Node*>::iterator it=job.nodes.begin(); it != job.nodes.end(); ++it)
+		oldNodes.push_back((*it)->nodeNumber);
+	job.py140->SetNewToOld(oldNodes);
+
+	std::vector<unsigned int> oldElements;
+	oldElements.reserve(job.elements.size());
+	for (std::vector<Element*>::iterator it=job.elements.begin(); it != job.elements.end(); ++it)
+		oldElements.push_back((*it)->elementNumber);
+	job.py141->SetNewToOld(oldElements);
+}
+
+
+/*
+ * Writes one file of a numbered subdomain. Only reads the numbering tables, so
+ * the files of a subdomain can be written at the same time.
+ */
+static bool EmitSubdomainFile(SubdomainJob &job, SubdomainFile file)
+{
+	if (file == Fort14File)
+		return WriteFort14(job.fort14Path, job.name, job.nodes, job.elements, job.py140, job.py141, job.boundaryNodes);
+
+	if (file == Fort13File)
+		return !job.fort13 || !job.carver || job.carver->CarveSubdomain(job.py140, job.fort13->GetFilePath());
+
+	if (file == Py140File)
+		return job.py140->SaveFile();
+
+	if (file == Py141File)
+		return job.py141->SaveFile();
+
+	job.bnList->SetSubdomainVersion(1);
+	job.bnList->SetOuterBoundaryNodes(job.py140->ConvertOldToNew(job.boundaryNodes));
+	return job.bnList->SaveFile();
+}
+
+
+static void EmitTask(EmissionTask &task)
+{
+	task.written = EmitSubdomainFile(*task.job, task.file);
+}
+
+
+static QString FileError(SubdomainFile file)
+{
+	switch (file)
+	{
+		case Fort14File:	return "Error creating the fort.14 file";
+		case Fort13File:	return "Error creating the fort.13 file";
+		case Py140File:		return "Error creating the py.140 file";
+		case Py141File:		return "Error creating the py.141 file";
+		default:		return "Error creating the bnlist.14 file";
+	}
+}
+
+
+/*
+ * Numbers the nodes and elements of one batch subdomain and writes its files.
+ * Runs on a worker thread.
+ */
+static void CreateSubdomainFiles(SubdomainJob &job)
+{
+	job.nodes = FindElementNodes(job.elements);
+
+	// Find the outer boundary of the selection
+	BoundaryFinder finder;
+	Boundaries boundaries;
+	finder.PerformBoundarySearch(job.elements, &boundaries);
+	job.boundaryNodes = boundaries.outerBoundaryNodes;
+
+	NumberSubdomain(job);
+
+	// The subdomains of a batch are already written in parallel, so the
+	// files of each one are written in turn
+	const SubdomainFile files[] = {Fort14File, Fort13File, Py140File, Py141File, BNListFile};
+	for (unsigned int i=0; i<sizeof(files)/sizeof(files[0]); ++i)
+		if (!EmitSubdomainFile(job, files[i]))
+			job.error = FileError(files[i]);
+}
+
+
 SubdomainCreator::SubdomainCreator() :
 	fullDomain(0),
 	projectFile(0),
-	subdomainName()
+	subdomainName(),
+	nodeOrdering(FullDomainOrdering)
 {
 }
 
@@ -14,6 +327,18 @@ SubdomainCreator::~SubdomainCreator()
 }
 
 
+/**
+ * @brief Sets the order that the nodes of new subdomains are numbered in
+ *
+ * Any ordering other than FullDomainOrdering renumbers the nodes for locality
+ * before the files are written, and the elements follow the new node order.
+ */
+void SubdomainCreator::SetNodeOrdering(NodeOrdering ordering)
+{
+	nodeOrdering = ordering;
+}
+
+
 bool SubdomainCreator::CreateSubdomain(QString newName,
 				       ProjectFile *projFile,
 				       QString targetDir,
@@ -40,33 +365,125 @@ bool SubdomainCreator::CreateSubdomain(QString newName,
 
 
 /**
- * @brief Creates a version 1 subdomain
+ * @brief Creates a batch of version 1 subdomains
+ *
+ * Everything that touches the project file (directories, file locations and the
+ * subdomain fort.015 files) is set up one subdomain at a time, along with the
+ * element search. The numbering, boundary search and writing of the py.140, py.141,
+ * bnlist.14, fort.13 and fort.14 files then run for all subdomains in parallel.
+ * Finally, all of the boundary nodes are added to the full domain fort.015, which
+ * is written once.
+ *
+ * @param selections The name, directory and elements of each subdomain
+ * @param projFile The project file
+ * @param fDomain The full domain
+ * @param recordFrequency The record frequency of the full domain fort.015
+ * @return true if every subdomain was created
  */
-bool SubdomainCreator::CreateSubdomainVersion1(QString targetDir, int recordFrequency)
+bool SubdomainCreator::CreateSubdomains(std::vector<SubdomainSelection> selections,
+					ProjectFile *projFile,
+					FullDomain *fDomain,
+					int recordFrequency)
 {
+	fullDomain = fDomain;
+	projectFile = projFile;
 
-	// Make sure the target directory (it will always be the name
-	// of the subdomain) exists.
-	QString newDirPath = targetDir;
-	if (QDir(newDirPath).exists())
+	if (!fullDomain || !projectFile)
 	{
-		// The directory exists. Check for ADCIRC files.
-		if (CheckForExistingSubdomainFiles(newDirPath))
+		std::cout << "Error accessing the full domain" << std::endl;
+		return false;
+	}
+
+	Fort015 *fort015Full = GetFullDomainFort015(1, recordFrequency);
+	if (!fort015Full)
+	{
+		std::cout << "Error getting full domain fort.015 file" << std::endl;
+		return false;
+	}
+
+	QString fullFort13 = projectFile->GetFullDomainFort13();
+	Fort13Carver carver (fullFort13, projectFile->GetProjectDirectory() + QDir::separator() + "fort.13.idx");
+	bool carveFort13 = !fullFort13.isEmpty() && carver.LoadFile();
+
+	bool allCreated = true;
+	std::vector<SubdomainJob> jobs;
+	for (std::vector<SubdomainSelection>::iterator it=selections.begin(); it != selections.end(); ++it)
+	{
+		subdomainName = it->name;
+
+		SubdomainJob job;
+		if (!FindSelectionElements(*it, &job.elements) || job.elements.empty())
 		{
-			// ADCIRC files exist in the directory. Ask the user
-			// if they'd like to overwrite.
-			if (!WarnSubdomainFilesExist(newDirPath))
-				return false;
+			std::cout << "No elements selected for subdomain " << subdomainName.toStdString() << std::endl;
+			allCreated = false;
+			continue;
 		}
-	} else {
-		// The directory doesn't exist, so create it.
-		QDir().mkdir(newDirPath);
+
+		if (!PrepareSubdomainDirectory(it->name, it->targetDir))
+		{
+			std::cout << "Error creating subdomain " << subdomainName.toStdString() << std::endl;
+			allCreated = false;
+			continue;
+		}
+
+		Fort015 fort015Sub (subdomainName, projectFile);
+		fort015Sub.SetSubdomainApproach(1);
+		fort015Sub.SetRecordFrequency(recordFrequency);
+		fort015Sub.WriteFile();
+
+		job.name = subdomainName;
+		job.fort14Path = projectFile->GetSubDomainDirectory(subdomainName) + QDir::separator() + "fort.14";
+		job.py140 = new Py140(subdomainName, projectFile);
+		job.py141 = new Py141(subdomainName, projectFile);
+		job.bnList = new BNList14(subdomainName, projectFile);
+		job.fort13 = carveFort13 ? new Fort13(subdomainName, projectFile) : 0;
+		job.carver = carveFort13 ? &carver : 0;
+		job.ordering = nodeOrdering;
+		projectFile->SetSubDomainFort14(subdomainName, job.fort14Path);
+		jobs.push_back(job);
 	}
 
-	// Create the subdomain in the project file
-	if (!projectFile->AddSubdomain(subdomainName))
+	QtConcurrent::blockingMap(jobs, CreateSubdomainFiles);
+
+	for (std::vector<SubdomainJob>::iterator it=jobs.begin(); it != jobs.end(); ++it)
+	{
+		if (it->error.isEmpty())
+		{
+			if (it->ordering != FullDomainOrdering)
+				std::cout << it->name.toStdString() << ": node bandwidth " << it->bandwidthBefore <<
+					     " before renumbering, " << it->bandwidthAfter << " after" << std::endl;
+			fort015Full->AddBoundaryNodes(it->boundaryNodes);
+		} else {
+			std::cout << it->name.toStdString() << ": " << it->error.toStdString() << std::endl;
+			allCreated = false;
+		}
+		delete it->py140;
+		delete it->py141;
+		delete it->bnList;
+		delete it->fort13;
+	}
+	fort015Full->WriteFile();
+	delete fort015Full;
+
+	return allCreated;
+}
+
+
+/**
+ * @brief Creates a version 1 subdomain
+ *
+ * Once the subdomain is numbered, its files don't depend on each other. The
+ * fort.14, fort.13, py.140, py.141 and bnlist.14 files are written on the thread
+ * pool while the fort.015 files (which update the project file) are written on
+ * this thread, and any failures are reported together at the end.
+ */
+bool SubdomainCreator::CreateSubdomainVersion1(QString targetDir, int recordFrequency)
+{
+
+	// Make sure the target directory exists and create the subdomain
+	// in the project file
+	if (!PrepareSubdomainDirectory(subdomainName, targetDir))
 		return false;
-	projectFile->SetSubDomainDirectory(subdomainName, newDirPath);
 
 
 	// Start creating the subdomain by getting the fort.015 file from the full domain
@@ -81,23 +498,6 @@ bool SubdomainCreator::CreateSubdomainVersion1(QString targetDir, int recordFreq
 	}
 
 
-	// Create the subdomain fort.015 file
-	Fort015 *fort015Sub = new Fort015(subdomainName, projectFile);
-	if (fort015Sub)
-	{
-		// The version 1 subdomain has a very simple fort.015 file.
-		// All we need to do is set the subdomain version and record
-		// frequency, and we are able to write the file and close it.
-		fort015Sub->SetSubdomainApproach(1);
-		fort015Sub->SetRecordFrequency(recordFrequency);
-		fort015Sub->WriteFile();
-		delete fort015Sub;
-	} else {
-		std::cout << "Error creating the subdomain fort.015 file" << std::endl;
-		return false;
-	}
-
-
 	// Get the selected elements from the full domain and determine the selected
 	// set of nodes.
 	if (!fullDomain)
@@ -105,78 +505,87 @@ bool SubdomainCreator::CreateSubdomainVersion1(QString targetDir, int recordFreq
 		std::cout << "Error accessing the full domain" << std::endl;
 		return false;
 	}
-	std::vector<Element*> selectedElements = fullDomain->GetSelectedElements();
-	std::vector<Node*> selectedNodes = GetSelectedNodes(selectedElements);
-
-
-	// Map the subdomain nodes/elements to the full domain nodes/elements
-	// This process creates the py.140 and py.141 files
-	Py140 *py140 = CreatePy140(selectedNodes);
-	Py141 *py141 = CreatePy141(selectedElements);
-	if (!py140)
+	SubdomainJob job;
+	job.name = subdomainName;
+	job.elements = fullDomain->GetSelectedElements();
+	job.nodes = GetSelectedNodes(job.elements);
+	job.boundaryNodes = fullDomain->GetOuterBoundaryNodes();
+	if (job.elements.empty() || job.nodes.empty())
 	{
-		std::cout << "Error creating the py.140 file for the new subdomain" << std::endl;
-		return false;
-	}
-	if (!py141)
-	{
-		std::cout << "Error creating the py.141 file for the new subdomain" << std::endl;
+		std::cout << "Error creating the new subdomain: no elements are selected" << std::endl;
 		return false;
 	}
 
 
-	// Get the boundary nodes from the selection and create the bnlist.14 file
-	std::vector<unsigned int> boundaryNodes = fullDomain->GetOuterBoundaryNodes();
-	bool bnListCreated = CreateBNListVersion1(boundaryNodes, py140);
-	if (!bnListCreated)
+	// Create the file objects, which records every file location in the project
+	// file, and number the subdomain nodes/elements. The py.140 and py.141 tables
+	// are shared by all of the files that are written below.
+	QString fullFort13 = projectFile->GetFullDomainFort13();
+	Fort13Carver carver (fullFort13, projectFile->GetProjectDirectory() + QDir::separator() + "fort.13.idx");
+	job.fort14Path = projectFile->GetSubDomainDirectory(subdomainName) + QDir::separator() + "fort.14";
+	job.py140 = new Py140(subdomainName, projectFile);
+	job.py141 = new Py141(subdomainName, projectFile);
+	job.bnList = new BNList14(subdomainName, projectFile);
+	job.fort13 = fullFort13.isEmpty() ? 0 : new Fort13(subdomainName, projectFile);
+	job.carver = &carver;
+	job.ordering = nodeOrdering;
+	projectFile->SetSubDomainFort14(subdomainName, job.fort14Path);
+	NumberSubdomain(job);
+	if (job.ordering != FullDomainOrdering)
+		std::cout << "Subdomain node bandwidth: " << job.bandwidthBefore <<
+			     " before renumbering, " << job.bandwidthAfter << " after" << std::endl;
+
+
+	// Write the fort.14, fort.13, py.140, py.141 and bnlist.14 files at the
+	// same time, largest first
+	const SubdomainFile files[] = {Fort14File, Fort13File, Py140File, Py141File, BNListFile};
+	std::vector<EmissionTask> tasks;
+	for (unsigned int i=0; i<sizeof(files)/sizeof(files[0]); ++i)
 	{
-		std::cout << "Error creating the bnlist.14 file for the new subdomain" << std::endl;
-		return false;
+		EmissionTask task;
+		task.job = &job;
+		task.file = files[i];
+		task.written = false;
+		tasks.push_back(task);
 	}
+	QFuture<void> emission = QtConcurrent::map(tasks, EmitTask);
+
 
+	// The fort.015 files update the project file when they are written, so they
+	// are written on this thread while the other files are being written.
+	// The version 1 subdomain has a very simple fort.015 file.
+	// All we need to do is set the subdomain version and record
+	// frequency, and we are able to write the file and close it.
+	Fort015 fort015Sub (subdomainName, projectFile);
+	fort015Sub.SetSubdomainApproach(1);
+	fort015Sub.SetRecordFrequency(recordFrequency);
+	fort015Sub.WriteFile();
 
 	// Add the boundary nodes to the full domain fort.015 file
-	fort015Full->AddBoundaryNodes(boundaryNodes);
+	fort015Full->AddBoundaryNodes(job.boundaryNodes);
 	fort015Full->WriteFile();
+	delete fort015Full;
 
-	// Create a fort.13 file for the subdomain (if it's needed)
-	Fort13 *fort13 = CreateFort13(py140);
-	if (fort13)
-		std::cout << "Subdomain fort.13 file created" << std::endl;
-
-
-	// Create a fort.14 file for the subdomain
-    if (!CreateFort14(selectedNodes, selectedElements, py140, py141, boundaryNodes))
-	{
-		std::cout << "Error creating the fort.14 file for the new subdomain" << std::endl;
-		return false;
-	}
+	emission.waitForFinished();
 
-	return true;
-}
 
-
-bool SubdomainCreator::CreateBNListVersion1(std::vector<unsigned int> boundaryNodes, Py140 *py140)
-{
-	// Version 1 boundary list only needs outer boundaries
-	BNList14 *file = new BNList14(subdomainName, projectFile);
-
-	if (file && py140)
+	// Report every file that couldn't be written
+	bool allWritten = true;
+	for (std::vector<EmissionTask>::iterator it=tasks.begin(); it != tasks.end(); ++it)
 	{
-		file->SetSubdomainVersion(1);
-
-		std::vector<unsigned int> boundaries;
-		for (std::vector<unsigned int>::iterator it=boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
+		if (!it->written)
 		{
-			boundaries.push_back(py140->ConvertOldToNew(*it));
+			std::cout << FileError(it->file).toStdString() << " for the new subdomain" << std::endl;
+			allWritten = false;
 		}
-
-		file->SetOuterBoundaryNodes(boundaries);
-		file->SaveFile();
-		delete file;
-		return true;
 	}
-	return false;
+
+	delete job.py140;
+	delete job.py141;
+	delete job.bnList;
+	delete job.fort13;
+
+	return allWritten;
 }
 
 
@@ -386,63 +795,40 @@ Fort015* SubdomainCreator::GetFullDomainFort015(int version, int recordFrequency
 }
 
 
+/**
+ * @brief Finds the unique nodes of the selected elements
+ *
+ * The nodes are marked in a table indexed by node number and then collected in
+ * table order, both in parallel, so the list is in full domain node order and
+ * the py.140 numbering is the same every time.
+ */
 std::vector<Node*> SubdomainCreator::GetSelectedNodes(std::vector<Element*> selectedElements)
 {
-	//
-	// Use a standard library set to find the unique set of selected nodes
-	//
-	std::set<Node*> selectedSet;
-	Element *currElement = 0;
-	for (std::vector<Element*>::iterator it=selectedElements.begin(); it != selectedElements.end(); ++it)
-	{
-		currElement = *it;
-		if (currElement)
-		{
-			selectedSet.insert(currElement->n1);
-			selectedSet.insert(currElement->n2);
-			selectedSet.insert(currElement->n3);
-		}
-	}
-
-	//
-	// Transfer the items of the set into a vector
-	//
-	std::vector<Node*> selectedNodes;
-	selectedNodes.reserve(selectedSet.size());
-	for (std::set<Node*>::iterator it=selectedSet.begin(); it != selectedSet.end(); ++it)
-	{
-		selectedNodes.push_back(*it);
-	}
-
-	// Return the list of nodes
-	return selectedNodes;
+	return FindElementNodes(selectedElements);
 }
 
 
+/**
+ * @brief Carves the subdomain fort.13 file out of the full domain fort.13 file
+ *
+ * The full domain file is streamed straight into the subdomain file by a
+ * Fort13Carver, so none of the attribute lines are loaded into a Fort13 object.
+ * The carver's index of the full domain file is kept in the project directory
+ * and reused by every subdomain created after the first one.
+ */
 Fort13* SubdomainCreator::CreateFort13(Py140 *py140)
 {
-	// Create the full domain fort.13 object
 	QString fullFort13 = projectFile->GetFullDomainFort13();
-	if (!fullFort13.isEmpty())
+	if (!fullFort13.isEmpty() && py140)
 	{
-		Fort13 *full = new Fort13(projectFile);
-		if (full && py140)
+		// Create the subdomain fort.13 object, which sets the file location
+		Fort13 *sub = new Fort13(subdomainName, projectFile);
+		if (sub)
 		{
-			// Get the full domain attributes
-			QString fullHdr = full->GetHeaderLine();
-			std::vector<NodalAttribute> fullAttr = full->GetNodalAttributes();
-
-			// Create the subdomain fort.13 object
-			Fort13 *sub = new Fort13(subdomainName, projectFile);
-			if (sub)
-			{
-				sub->SetHeaderLine(fullHdr);
-				sub->SetNodalAttributes(fullAttr, py140);
-				sub->SaveFile();
-				delete full;
+			Fort13Carver carver (fullFort13, projectFile->GetProjectDirectory() + QDir::separator() + "fort.13.idx");
+			if (carver.CarveSubdomain(py140, sub->GetFilePath()))
 				return sub;
-			}
-			delete full;
+			delete sub;
 		}
 	}
 	return 0;
@@ -452,73 +838,12 @@ Fort13* SubdomainCreator::CreateFort13(Py140 *py140)
 bool SubdomainCreator::CreateFort14(std::vector<Node*> selectedNodes, std::vector<Element*> selectedElements, Py140 *py140, Py141 *py141, std::vector<unsigned int> boundaryNodes)
 {
 	QString targetPath = projectFile->GetSubDomainDirectory(subdomainName) + QDir::separator() + "fort.14";
-	std::ofstream fort14File (targetPath.toStdString().data());
-	if (fort14File.is_open() && py140 && py141)
+	if (WriteFort14(targetPath, subdomainName, selectedNodes, selectedElements, py140, py141, boundaryNodes))
 	{
-		// Write title line
-		fort14File << subdomainName.toStdString().data() << "\n";
-
-		// Write info line
-		fort14File << selectedElements.size() << " " << selectedNodes.size() << "\n";
-
-		// Write nodes
-		Node *currNode = 0;
-		for (std::vector<Node*>::iterator it = selectedNodes.begin(); it != selectedNodes.end(); ++it)
-		{
-			currNode = *it;
-			if (currNode)
-			{
-				fort14File << "\t" <<
-					      py140->ConvertOldToNew(currNode->nodeNumber) << "\t" <<
-					      currNode->xDat << "\t" <<
-					      currNode->yDat << "\t" <<
-					      currNode->zDat << "\n";
-			}
-		}
-
-		// Write elements
-		Element *currElement = 0;
-		for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
-		{
-			currElement = *it;
-			if (currElement)
-			{
-				fort14File << py141->ConvertOldToNew(currElement->elementNumber) << "\t3\t" <<
-					      py140->ConvertOldToNew(currElement->n1->nodeNumber) << "\t" <<
-					      py140->ConvertOldToNew(currElement->n2->nodeNumber) << "\t" <<
-					      py140->ConvertOldToNew(currElement->n3->nodeNumber) << "\n";
-			}
-		}
-
-		// Write boundaries
-        if (boundaryNodes.size() > 0)
-        {
-            fort14File << "1\t!no. of open boundary segments\n";
-            fort14File << boundaryNodes.size() + 1 << "\t!total no. of open boundary nodes\n";
-            fort14File << boundaryNodes.size() + 1 << "\t!no. of open boundary nodes  in segment 1\n";
-
-            for (std::vector<unsigned int>::iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
-            {
-
-                fort14File << py140->ConvertOldToNew(*it) << "\n";
-            }
-            fort14File << py140->ConvertOldToNew(boundaryNodes[0]) << "\n";
-        } else {
-            fort14File << "0\t!no. of open boundary segments\n";
-            fort14File << "0\t!no. of open boundary nodes\n";
-        }
-		fort14File << "0\t!no. of land boundary segments\n";
-		fort14File << "0\t!no. of land boundary nodes\n";
-
-		// Close the file
-		fort14File.close();
-
 		projectFile->SetSubDomainFort14(subdomainName, targetPath);
-
 		return true;
-	} else {
-		return false;
 	}
+	return false;
 }
 
 
@@ -530,17 +855,17 @@ Py140* SubdomainCreator::CreatePy140(std::vector<Node*> selectedNodes)
 		if (selectedNodes.size())
 		{
 			Node *currNode = 0;
-			unsigned int nextNewNode = 1;
-			std::map<unsigned int, unsigned int> oldToNew;
+			std::vector<unsigned int> newToOld;
+			newToOld.reserve(selectedNodes.size());
 			for (std::vector<Node*>::iterator it=selectedNodes.begin(); it != selectedNodes.end(); ++it)
 			{
 				currNode = *it;
 				if (currNode)
 				{
-					oldToNew[currNode->nodeNumber] = nextNewNode++;
+					newToOld.push_back(currNode->nodeNumber);
 				}
 			}
-			newFile->SetOldToNew(oldToNew);
+			newFile->SetNewToOld(newToOld);
 			newFile->SaveFile();
 			return newFile;
 		}
@@ -557,17 +882,17 @@ Py141* SubdomainCreator::CreatePy141(std::vector<Element*> selectedElements)
 		if (selectedElements.size())
 		{
 			Element *currElement = 0;
-			unsigned int nextNewElement = 1;
-			std::map<unsigned int, unsigned int> oldToNew;
+			std::vector<unsigned int> newToOld;
+			newToOld.reserve(selectedElements.size());
 			for (std::vector<Element*>::iterator it=selectedElements.begin(); it != selectedElements.end(); ++it)
 			{
 				currElement = *it;
 				if (currElement)
 				{
-					oldToNew[currElement->elementNumber] = nextNewElement++;
+					newToOld.push_back(currElement->elementNumber);
 				}
 			}
-			newFile->SetOldToNew(oldToNew);
+			newFile->SetNewToOld(newToOld);
 			newFile->SaveFile();
 			return newFile;
 		}
@@ -576,6 +901,85 @@ Py141* SubdomainCreator::CreatePy141(std::vector<Element*> selectedElements)
 }
 
 
+/**
+ * @brief Makes sure the subdomain directory exists and adds the subdomain to
+ * the project file
+ */
+bool SubdomainCreator::PrepareSubdomainDirectory(QString name, QString targetDir)
+{
+	// Make sure the target directory (it will always be the name
+	// of the subdomain) exists.
+	QString newDirPath = targetDir;
+	if (QDir(newDirPath).exists())
+	{
+		// The directory exists. Check for ADCIRC files.
+		if (CheckForExistingSubdomainFiles(newDirPath))
+		{
+			// ADCIRC files exist in the directory. Ask the user
+			// if they'd like to overwrite.
+			if (!WarnSubdomainFilesExist(newDirPath))
+				return false;
+		}
+	} else {
+		// The directory doesn't exist, so create it.
+		QDir().mkdir(newDirPath);
+	}
+
+	// Create the subdomain in the project file
+	if (!projectFile->AddSubdomain(name))
+		return false;
+	projectFile->SetSubDomainDirectory(name, newDirPath);
+
+	return true;
+}
+
+
+/**
+ * @brief Finds the full domain elements of one subdomain in a batch
+ *
+ * Element pointers point into the Quadtree's element list, like the ones
+ * returned by the selection tools.
+ */
+bool SubdomainCreator::FindSelectionElements(const SubdomainSelection &selection, std::vector<Element*> *elements)
+{
+	Fort14 *fort14 = fullDomain->GetFort14();
+	if (!fort14)
+		return false;
+
+	if (selection.selectionFile.isEmpty())
+	{
+		std::vector<Point> normalizedPolygon;
+		for (std::vector<Point>::const_iterator it = selection.polygon.begin(); it != selection.polygon.end(); ++it)
+			normalizedPolygon.push_back(Point(fort14->GetNormalizedX(it->x), fort14->GetNormalizedY(it->y)));
+		if (normalizedPolygon.size() < 3)
+			return false;
+		*elements = fort14->FindElementsInPolygon(normalizedPolygon);
+		return true;
+	}
+
+	std::vector<Element> *allElements = fort14->GetQuadtreeElements();
+	std::ifstream file (selection.selectionFile.toStdString().data());
+	if (!allElements || !file.is_open())
+		return false;
+
+	std::vector<unsigned int> elementNumbers;
+	unsigned int currElement = 0;
+	while (file >> currElement)
+		if (currElement > 0 && currElement <= allElements->size())
+			elementNumbers.push_back(currElement);
+	file.close();
+
+	std::sort(elementNumbers.begin(), elementNumbers.end());
+	elementNumbers.erase(std::unique(elementNumbers.begin(), elementNumbers.end()), elementNumbers.end());
+
+	elements->clear();
+	elements->reserve(elementNumbers.size());
+	for (std::vector<unsigned int>::iterator it=elementNumbers.begin(); it != elementNumbers.end(); ++it)
+		elements->push_back(&(*allElements)[*it-1]);
+	return true;
+}
+
+
 bool SubdomainCreator::CheckForExistingSubdomainFiles(QString targetDir)
 {
 	if (QFile(targetDir + QDir::separator() + "fort.14").exists())
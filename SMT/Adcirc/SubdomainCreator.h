@@ -3,6 +3,12 @@
 
 #include <QString>
 #include <QObject>
+#include <QFuture>
+#include <QtConcurrentMap>
+
+#include <vector>
+#include <fstream>
+#include <algorithm>
 
 #include "Project/Domains/FullDomain.h"
 #include "Project/Domains/SubDomain.h"
@@ -10,6 +16,25 @@
 #include "Project/Files/BNList14.h"
 #include "Project/Files/Py140.h"
 #include "Project/Files/Py141.h"
+#include "Project/Files/Workers/Fort13Carver.h"
+#include "SubdomainTools/BoundaryFinder.h"
+#include "SubdomainTools/MeshRenumberer.h"
+
+
+/**
+ * @brief One subdomain in a batch created by SubdomainCreator::CreateSubdomains()
+ *
+ * The subdomain is made of the full domain elements inside the polygon (in the
+ * coordinate system of the fort.14 file) or, if selectionFile is set, the
+ * elements listed in that file (one full domain element number per line).
+ */
+struct SubdomainSelection
+{
+		QString			name;
+		QString			targetDir;
+		std::vector<Point>	polygon;
+		QString			selectionFile;
+};
 
 
 /**
@@ -43,6 +68,15 @@
  * similar but making modifications to each will be more simple moving forward
  * if they are separated.
  *
+ * CreateSubdomains() creates a whole batch of version 1 subdomains at once. The
+ * elements of every subdomain are found up front, the files of all subdomains are
+ * written in parallel (sharing one indexed copy of the full domain fort.13), and
+ * the full domain fort.015 is written once with every new boundary.
+ *
+ * SetNodeOrdering() can renumber the nodes and elements of new subdomains for
+ * locality (see MeshRenumberer). Every file is numbered from the same py.140 and
+ * py.141 tables, so they all follow the new numbering.
+ *
  * Note: Will probably rethink fort.015 process. It seems it would probably be
  *	 more useful to set the subdomain version and record frequency at the
  *	 start of a project and then never ask the user again for those values.
@@ -54,22 +88,28 @@ class SubdomainCreator
 		SubdomainCreator();
 		~SubdomainCreator();
 
+		void	SetNodeOrdering(NodeOrdering ordering);
+
 		bool	CreateSubdomain(QString newName,
 					ProjectFile *projFile,
 					QString targetDir,
 					FullDomain *fDomain,
 					int version,
 					int recordFrequency);
+		bool	CreateSubdomains(std::vector<SubdomainSelection> selections,
+					 ProjectFile *projFile,
+					 FullDomain *fDomain,
+					 int recordFrequency);
 
 	private:
 
 		FullDomain*				fullDomain;
 		ProjectFile*				projectFile;
 		QString					subdomainName;
+		NodeOrdering				nodeOrdering;
 
 		// Methods for creating version 1 subdomains
 		bool	CreateSubdomainVersion1(QString targetDir, int recordFrequency);
-		bool	CreateBNListVersion1(std::vector<unsigned int> boundaryNodes, Py140 *py140);
 
 		// Methods for creating version 2 subdomains
 		bool	CreateSubdomainVersion2(QString targetDir, int recordFrequency);
@@ -84,6 +124,10 @@ class SubdomainCreator
 		Py140*			CreatePy140(std::vector<Node*> selectedNodes);
 		Py141*			CreatePy141(std::vector<Element*> selectedElements);
 
+		// Methods for creating batches of subdomains
+		bool	PrepareSubdomainDirectory(QString name, QString targetDir);
+		bool	FindSelectionElements(const SubdomainSelection &selection, std::vector<Element*> *elements);
+
 		// Older methods
 		bool	CheckForExistingSubdomainFiles(QString targetDir);
 
@@ -0,0 +1,103 @@
+#include "AttributeSelectionDialog.h"
+#include "ui_AttributeSelectionDialog.h"
+
+AttributeSelectionDialog::AttributeSelectionDialog(QWidget *parent) :
+	QDialog(parent),
+	ui(new Ui::AttributeSelectionDialog)
+{
+	ui->setupUi(this);
+
+	ui->minValue->setValidator(new QDoubleValidator(this));
+	ui->maxValue->setValidator(new QDoubleValidator(this));
+
+	connect(ui->source, SIGNAL(currentIndexChanged(int)), this, SLOT(sourceChanged(int)));
+	connect(ui->attributeName, SIGNAL(currentIndexChanged(int)), this, SLOT(attributeChanged(int)));
+
+	sourceChanged(ui->source->currentIndex());
+}
+
+AttributeSelectionDialog::~AttributeSelectionDialog()
+{
+	delete ui;
+}
+
+
+/**
+ * @brief Lists the fort.13 nodal attributes that can be tested
+ */
+void AttributeSelectionDialog::SetNodalAttributes(std::vector<NodalAttribute> attributes)
+{
+	valuesPerNode.clear();
+	ui->attributeName->clear();
+	for (std::vector<NodalAttribute>::iterator it = attributes.begin(); it != attributes.end(); ++it)
+	{
+		valuesPerNode.push_back(std::max((*it).valuesPerNode.trimmed().toUInt(), 1u));
+		ui->attributeName->addItem((*it).attributeName.trimmed());
+	}
+	sourceChanged(ui->source->currentIndex());
+}
+
+
+AttributeSource AttributeSelectionDialog::GetSource()
+{
+	return (AttributeSource)ui->source->currentIndex();
+}
+
+
+QString AttributeSelectionDialog::GetAttributeName()
+{
+	return ui->attributeName->currentText();
+}
+
+
+/**
+ * @brief The attribute value to test, counting from 0
+ */
+unsigned int AttributeSelectionDialog::GetColumn()
+{
+	return (unsigned int)ui->column->value() - 1;
+}
+
+
+/**
+ * @brief The smallest value that passes, or -FLT_MAX if none was given
+ */
+float AttributeSelectionDialog::GetMinValue()
+{
+	if (ui->minValue->text().isEmpty())
+		return -FLT_MAX;
+	return ui->minValue->text().toFloat();
+}
+
+
+/**
+ * @brief The largest value that passes, or FLT_MAX if none was given
+ */
+float AttributeSelectionDialog::GetMaxValue()
+{
+	if (ui->maxValue->text().isEmpty())
+		return FLT_MAX;
+	return ui->maxValue->text().toFloat();
+}
+
+
+ElementMatch AttributeSelectionDialog::GetElementMatch()
+{
+	return (ElementMatch)ui->elementMatch->currentIndex();
+}
+
+
+void AttributeSelectionDialog::sourceChanged(int index)
+{
+	bool nodalAttribute = (index == NodalAttributeValue);
+	ui->attributeName->setEnabled(nodalAttribute && ui->attributeName->count() > 0);
+	ui->column->setEnabled(nodalAttribute && ui->attributeName->count() > 0);
+	ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!nodalAttribute || ui->attributeName->count() > 0);
+}
+
+
+void AttributeSelectionDialog::attributeChanged(int index)
+{
+	unsigned int numValues = (index >= 0 && index < (int)valuesPerNode.size()) ? valuesPerNode[index] : 1;
+	ui->column->setMaximum(numValues);
+}
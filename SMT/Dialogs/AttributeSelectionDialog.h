@@ -0,0 +1,50 @@
+#ifndef ATTRIBUTESELECTIONDIALOG_H
+#define ATTRIBUTESELECTIONDIALOG_H
+
+#include <QDialog>
+#include <QDoubleValidator>
+#include <QPushButton>
+
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+#include "SubdomainTools/AttributeTool.h"
+#include "Project/Files/Fort13.h"
+
+namespace Ui {
+	class AttributeSelectionDialog;
+}
+
+/**
+ * @brief Sets up the test that an AttributeTool selects or deselects elements with
+ */
+class AttributeSelectionDialog : public QDialog
+{
+		Q_OBJECT
+
+	public:
+		explicit AttributeSelectionDialog(QWidget *parent = 0);
+		~AttributeSelectionDialog();
+
+		void	SetNodalAttributes(std::vector<NodalAttribute> attributes);
+
+		AttributeSource	GetSource();
+		QString		GetAttributeName();
+		unsigned int	GetColumn();
+		float		GetMinValue();
+		float		GetMaxValue();
+		ElementMatch	GetElementMatch();
+
+	private:
+		Ui::AttributeSelectionDialog *ui;
+
+		std::vector<unsigned int>	valuesPerNode;	/**< The number of values of each listed attribute */
+
+	private slots:
+
+		void	sourceChanged(int index);
+		void	attributeChanged(int index);
+};
+
+#endif // ATTRIBUTESELECTIONDIALOG_H
@@ -0,0 +1,149 @@
+#include "CreateSubdomainBatchDialog.h"
+#include "ui_CreateSubdomainBatchDialog.h"
+
+CreateSubdomainBatchDialog::CreateSubdomainBatchDialog(QWidget *parent) :
+	QDialog(parent),
+	ui(new Ui::CreateSubdomainBatchDialog)
+{
+	ui->setupUi(this);
+
+	connect(ui->addFilesButton, SIGNAL(clicked()), this, SLOT(addFiles()));
+	connect(ui->removeFilesButton, SIGNAL(clicked()), this, SLOT(removeFiles()));
+
+	updateOkButton();
+}
+
+CreateSubdomainBatchDialog::~CreateSubdomainBatchDialog()
+{
+	delete ui;
+}
+
+
+/**
+ * @brief Returns a selection for every listed file, built when the dialog was accepted
+ */
+std::vector<SubdomainSelection> CreateSubdomainBatchDialog::GetSelections()
+{
+	return selections;
+}
+
+
+/**
+ * @brief Returns the selected node ordering, in the order of the NodeOrdering enum
+ */
+int CreateSubdomainBatchDialog::GetNodeOrdering()
+{
+	return ui->nodeOrdering->currentIndex();
+}
+
+
+int CreateSubdomainBatchDialog::GetRecordFrequency()
+{
+	return ui->recordFrequency->value();
+}
+
+
+void CreateSubdomainBatchDialog::SetFullDomainDirectory(QString dir)
+{
+	fullDir = QDir::cleanPath(dir) + QDir::separator();
+	ui->locationMessage->setText(fullDir);
+}
+
+
+/**
+ * @brief Builds a selection for every listed file
+ *
+ * Each subdomain is named after its file and is created in a directory of
+ * the same name next to the full domain.
+ *
+ * @return false if a polygon file couldn't be read or a subdomain directory
+ * already exists
+ */
+bool CreateSubdomainBatchDialog::BuildSelections()
+{
+	selections.clear();
+	bool polygonFiles = (ui->fileContents->currentIndex() == 1);
+	for (int i=0; i<ui->selectionFiles->count(); ++i)
+	{
+		QString filePath = ui->selectionFiles->item(i)->text();
+
+		SubdomainSelection selection;
+		selection.name = QFileInfo(filePath).completeBaseName();
+		selection.targetDir = fullDir + selection.name;
+		if (QDir(selection.targetDir).exists())
+		{
+			QMessageBox::warning(this, tr("Create Subdomains"),
+					     tr("Subdomain already exists. Please rename the file:\n") + filePath,
+					     QMessageBox::Ok);
+			return false;
+		}
+
+		if (polygonFiles)
+		{
+			if (!ReadPolygonFile(filePath, &selection.polygon))
+			{
+				QMessageBox::warning(this, tr("Create Subdomains"),
+						     tr("Unable to read a polygon from:\n") + filePath,
+						     QMessageBox::Ok);
+				return false;
+			}
+		} else {
+			selection.selectionFile = filePath;
+		}
+		selections.push_back(selection);
+	}
+	return !selections.empty();
+}
+
+
+/**
+ * @brief Reads the x y points of a polygon, one point per line
+ * @return false if the file has fewer than 3 points
+ */
+bool CreateSubdomainBatchDialog::ReadPolygonFile(QString filePath, std::vector<Point> *polygon)
+{
+	polygon->clear();
+	std::ifstream file (filePath.toStdString().data());
+	if (!file.is_open())
+		return false;
+
+	float x, y;
+	while (file >> x >> y)
+		polygon->push_back(Point(x, y));
+	file.close();
+
+	return polygon->size() >= 3;
+}
+
+
+/**
+ * @brief Only closes the dialog once every file has been turned into a selection
+ */
+void CreateSubdomainBatchDialog::accept()
+{
+	if (BuildSelections())
+		QDialog::accept();
+}
+
+
+void CreateSubdomainBatchDialog::addFiles()
+{
+	QStringList files = QFileDialog::getOpenFileNames(this, "Choose Selection Files", fullDir);
+	for (int i=0; i<files.size(); ++i)
+		if (ui->selectionFiles->findItems(files.at(i), Qt::MatchExactly).isEmpty())
+			ui->selectionFiles->addItem(files.at(i));
+	updateOkButton();
+}
+
+
+void CreateSubdomainBatchDialog::removeFiles()
+{
+	qDeleteAll(ui->selectionFiles->selectedItems());
+	updateOkButton();
+}
+
+
+void CreateSubdomainBatchDialog::updateOkButton()
+{
+	ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(ui->selectionFiles->count() > 0);
+}
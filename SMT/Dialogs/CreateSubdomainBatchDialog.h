@@ -0,0 +1,61 @@
+#ifndef CREATESUBDOMAINBATCHDIALOG_H
+#define CREATESUBDOMAINBATCHDIALOG_H
+
+#include <QDialog>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QPushButton>
+#include <QMessageBox>
+#include <QDir>
+
+#include <vector>
+#include <fstream>
+
+#include "Adcirc/SubdomainCreator.h"
+
+namespace Ui {
+	class CreateSubdomainBatchDialog;
+}
+
+/**
+ * @brief Asks for a list of selection files, each of which becomes a new
+ * subdomain named after the file
+ *
+ * A selection file either lists full domain element numbers, or the x y
+ * points of a polygon (one point per line, in fort.14 coordinates).
+ */
+class CreateSubdomainBatchDialog : public QDialog
+{
+		Q_OBJECT
+
+	public:
+		explicit CreateSubdomainBatchDialog(QWidget *parent = 0);
+		~CreateSubdomainBatchDialog();
+
+		std::vector<SubdomainSelection>	GetSelections();
+		int				GetNodeOrdering();
+		int				GetRecordFrequency();
+
+		void	SetFullDomainDirectory(QString dir);
+
+	public slots:
+
+		void	accept();
+
+	private:
+		Ui::CreateSubdomainBatchDialog *ui;
+
+		QString				fullDir;
+		std::vector<SubdomainSelection>	selections;
+
+		bool	BuildSelections();
+		bool	ReadPolygonFile(QString filePath, std::vector<Point> *polygon);
+
+	private slots:
+
+		void	addFiles();
+		void	removeFiles();
+		void	updateOkButton();
+};
+
+#endif // CREATESUBDOMAINBATCHDIALOG_H
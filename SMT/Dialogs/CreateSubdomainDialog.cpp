@@ -40,6 +40,15 @@ bool CreateSubdomainDialog::CreateTargetDir()
 }
 
 
+/**
+ * @brief Returns the selected node ordering, in the order of the NodeOrdering enum
+ */
+int CreateSubdomainDialog::GetNodeOrdering()
+{
+	return ui->nodeOrdering->currentIndex();
+}
+
+
 int CreateSubdomainDialog::GetRecordFrequency()
 {
 	bool check;
@@ -23,6 +23,7 @@ class CreateSubdomainDialog : public QDialog
 
 		bool	CreateTargetDir();
 
+		int	GetNodeOrdering();
 		int	GetRecordFrequency();
 		QString	GetSubdomainName();
 		QString GetSubdomainDirectory();
@@ -0,0 +1,51 @@
+#include "ExtractBoundaryConditionsDialog.h"
+#include "ui_ExtractBoundaryConditionsDialog.h"
+
+ExtractBoundaryConditionsDialog::ExtractBoundaryConditionsDialog(QWidget *parent) :
+	QDialog(parent),
+	ui(new Ui::ExtractBoundaryConditionsDialog)
+{
+	ui->setupUi(this);
+}
+
+ExtractBoundaryConditionsDialog::~ExtractBoundaryConditionsDialog()
+{
+	delete ui;
+}
+
+
+/**
+ * @brief Lists the subdomains of the project, all of them selected
+ */
+void ExtractBoundaryConditionsDialog::SetSubdomainNames(QStringList names)
+{
+	ui->subdomainList->clear();
+	ui->subdomainList->addItems(names);
+	ui->subdomainList->selectAll();
+}
+
+
+QStringList ExtractBoundaryConditionsDialog::GetSelectedSubdomains()
+{
+	QStringList names;
+	for (int i=0; i<ui->subdomainList->count(); ++i)
+		if (ui->subdomainList->item(i)->isSelected())
+			names.append(ui->subdomainList->item(i)->text());
+	return names;
+}
+
+
+/**
+ * @brief The number of time ranges to extract on their own threads, or 0 to
+ * use the reading, routing and writing pipeline
+ */
+unsigned int ExtractBoundaryConditionsDialog::GetNumTimeSlabs()
+{
+	return (unsigned int)ui->numTimeSlabs->value();
+}
+
+
+bool ExtractBoundaryConditionsDialog::GetBenchmark()
+{
+	return ui->benchmarkCheckBox->isChecked();
+}
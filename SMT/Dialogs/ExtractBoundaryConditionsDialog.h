@@ -0,0 +1,34 @@
+#ifndef EXTRACTBOUNDARYCONDITIONSDIALOG_H
+#define EXTRACTBOUNDARYCONDITIONSDIALOG_H
+
+#include <QDialog>
+#include <QListWidget>
+#include <QStringList>
+
+namespace Ui {
+	class ExtractBoundaryConditionsDialog;
+}
+
+/**
+ * @brief Asks which subdomains to extract boundary conditions for, and how
+ * the full domain files are split up while they are extracted
+ */
+class ExtractBoundaryConditionsDialog : public QDialog
+{
+		Q_OBJECT
+
+	public:
+		explicit ExtractBoundaryConditionsDialog(QWidget *parent = 0);
+		~ExtractBoundaryConditionsDialog();
+
+		void		SetSubdomainNames(QStringList names);
+
+		QStringList	GetSelectedSubdomains();
+		unsigned int	GetNumTimeSlabs();
+		bool		GetBenchmark();
+
+	private:
+		Ui::ExtractBoundaryConditionsDialog *ui;
+};
+
+#endif // EXTRACTBOUNDARYCONDITIONSDIALOG_H
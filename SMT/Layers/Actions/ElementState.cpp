@@ -24,6 +24,33 @@ ElementState::ElementState(std::vector<Element *> elementsList)
 }
 
 
+/**
+ * @brief Creates a state along with the changes made to the previous state
+ *
+ * The lists of added and removed elements allow a BoundaryFinder that tracks
+ * the selection to move between this state and the previous one without
+ * looking at the rest of the selection.
+ *
+ * @param elementsList The full list of selected elements
+ * @param added The elements that were not selected in the previous state
+ * @param removed The elements that were selected in the previous state
+ */
+ElementState::ElementState(std::vector<Element *> elementsList,
+			   std::vector<Element *> added,
+			   std::vector<Element *> removed)
+{
+	elements.clear();
+	boundaryData = new Boundaries();
+	numNodes = 0;
+	numElements = 0;
+	minZ = 99999;
+	maxZ = -99999;
+	elements = elementsList;
+	addedElements = added;
+	removedElements = removed;
+}
+
+
 ElementState::~ElementState()
 {
 	if (boundaryData)
@@ -45,6 +72,18 @@ std::vector<Element*>* ElementState::GetState()
 }
 
 
+std::vector<Element*>* ElementState::GetAddedElements()
+{
+	return &addedElements;
+}
+
+
+std::vector<Element*>* ElementState::GetRemovedElements()
+{
+	return &removedElements;
+}
+
+
 Boundaries* ElementState::GetBoundaries()
 {
 	if (!boundaryData->boundariesFound)
@@ -56,6 +95,28 @@ Boundaries* ElementState::GetBoundaries()
 }
 
 
+/**
+ * @brief Gets the boundaries from a BoundaryFinder that is tracking the selection
+ *
+ * The tracker must currently hold this state's selection. If no tracker is
+ * provided, the boundaries are traced from the full list of elements.
+ *
+ * @param selectionTracker A BoundaryFinder that is tracking the selection
+ */
+Boundaries* ElementState::GetBoundaries(BoundaryFinder *selectionTracker)
+{
+	if (!boundaryData->boundariesFound)
+	{
+		if (selectionTracker && selectionTracker->IsTracking())
+			selectionTracker->FindBoundaries(boundaryData);
+		else
+			FindBoundaries();
+	}
+
+	return boundaryData;
+}
+
+
 void ElementState::FindBoundaries()
 {
 	BoundaryFinder searchTool;
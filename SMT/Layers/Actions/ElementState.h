@@ -11,16 +11,24 @@ class ElementState
 		// Constructors
 		ElementState();
 		ElementState(std::vector<Element*> elementsList);
+		ElementState(std::vector<Element*> elementsList,
+			     std::vector<Element*> added,
+			     std::vector<Element*> removed);
 		~ElementState();
 
 		// Access Function
 		bool			BoundariesFound();
 		std::vector<Element*>*	GetState();
+		std::vector<Element*>*	GetAddedElements();
+		std::vector<Element*>*	GetRemovedElements();
 		Boundaries*		GetBoundaries();
+		Boundaries*		GetBoundaries(BoundaryFinder *selectionTracker);
 
 	protected:
 
 		std::vector<Element*>	elements;
+		std::vector<Element*>	addedElements;		/**< Elements added since the previous state */
+		std::vector<Element*>	removedElements;	/**< Elements removed since the previous state */
 		Boundaries*		boundaryData;
 		int			numNodes;
 		int			numElements;
@@ -1,5 +1,13 @@
 #include "FullDomainSelectionLayer.h"
 
+const GLuint FullDomainSelectionLayer::UnselectedIndex;
+
+/**
+ * Changed elements that are separated by fewer than this many unchanged
+ * elements are uploaded with a single glBufferSubData call
+ */
+static const unsigned int MergeGap = 256;
+
 FullDomainSelectionLayer::FullDomainSelectionLayer(Fort14 *fort14, QObject *parent) :
 	SelectionLayer(parent),
 	fort14(fort14),
@@ -10,10 +18,17 @@ FullDomainSelectionLayer::FullDomainSelectionLayer(Fort14 *fort14, QObject *pare
 	circleTool(0),
 	rectangleTool(0),
 	polygonTool(0),
+	attributeTool(0),
 	boundaryFinder(0),
+	regionGrower(0),
+	floodFillUseDepth(false),
+	floodFillDepth(0.0),
 	selectedState(0),
 	outerBoundaryNodes(),
 	innerBoundaryNodes(),
+	boundaryIBOId(0),
+	elementIndices(),
+	changedElements(),
 	undoStack(),
 	redoStack(),
 	outlineShader(0),
@@ -39,8 +54,12 @@ FullDomainSelectionLayer::~FullDomainSelectionLayer()
 		delete rectangleTool;
 	if (polygonTool)
 		delete polygonTool;
+	if (attributeTool)
+		delete attributeTool;
 	if (boundaryFinder)
 		delete boundaryFinder;
+	if (regionGrower)
+		delete regionGrower;
 
 	if (selectedState)
 		delete selectedState;
@@ -56,45 +75,62 @@ FullDomainSelectionLayer::~FullDomainSelectionLayer()
 		delete innerBoundaryShader;
 	if (outerBoundaryShader)
 		delete outerBoundaryShader;
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	if (boundaryIBOId)
+		glDeleteBuffers(1, &boundaryIBOId);
 }
 
 
+/**
+ * @brief Draws the selected elements and the selection boundary
+ *
+ * The index buffer always holds every element of the mesh. Elements that are
+ * not selected are made of the primitive restart index, so they are dropped
+ * before rasterization and the same draw call works for any selection.
+ */
 void FullDomainSelectionLayer::Draw()
 {
-	if (glLoaded && selectedState)
+	if (glLoaded && selectedState && !elementIndices.empty())
 	{
-		unsigned int numElements = selectedState->GetState()->size();
+		unsigned int numIndices = elementIndices.size();
 
 		glBindVertexArray(VAOId);
 
+		glEnable(GL_PRIMITIVE_RESTART);
+		glPrimitiveRestartIndex(UnselectedIndex);
+
 		if (fillShader)
 		{
 			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 			if (fillShader->Use())
-				glDrawElements(GL_TRIANGLES, numElements*3, GL_UNSIGNED_INT, (GLvoid*)0);
+				glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, (GLvoid*)0);
 		}
 
 		if (outlineShader)
 		{
 			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 			if (outlineShader->Use())
-				glDrawElements(GL_TRIANGLES, numElements*3, GL_UNSIGNED_INT, (GLvoid*)0);
+				glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, (GLvoid*)0);
 		}
 
+		glDisable(GL_PRIMITIVE_RESTART);
+
+		/* The boundary nodes live in their own index buffer */
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boundaryIBOId);
+
 		if (outerBoundaryShader && outerBoundaryNodes.size())
 		{
 			/* Draw points to smooth out the ends of the lines */
 			glPolygonMode(GL_FRONT_AND_BACK, GL_POINT);
 			glPointSize(5.0);
 			if (outerBoundaryShader->Use())
-				glDrawElements(GL_POINTS, outerBoundaryNodes.size(), GL_UNSIGNED_INT,
-					       (GLvoid*)(0 + sizeof(GLuint)*numElements*3));
+				glDrawElements(GL_POINTS, outerBoundaryNodes.size(), GL_UNSIGNED_INT, (GLvoid*)0);
 
 			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 			glLineWidth(5.0);
 			if (outerBoundaryShader->Use())
-				glDrawElements(GL_LINE_LOOP, outerBoundaryNodes.size(), GL_UNSIGNED_INT,
-					       (GLvoid*)(0 + sizeof(GLuint)*numElements*3));
+				glDrawElements(GL_LINE_LOOP, outerBoundaryNodes.size(), GL_UNSIGNED_INT, (GLvoid*)0);
 			glLineWidth(1.0);
 		}
 
@@ -105,16 +141,17 @@ void FullDomainSelectionLayer::Draw()
 			glPointSize(5.0);
 			if (innerBoundaryShader->Use())
 				glDrawElements(GL_POINTS, innerBoundaryNodes.size(), GL_UNSIGNED_INT,
-					       (GLvoid*)(0 + sizeof(GLuint)*(numElements*3 + outerBoundaryNodes.size())));
+					       (GLvoid*)(0 + sizeof(GLuint)*outerBoundaryNodes.size()));
 
 //			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 //			glLineWidth(3.0);
 //			if (innerBoundaryShader->Use())
 //				glDrawElements(GL_LINE_LOOP, innerBoundaryNodes.size(), GL_UNSIGNED_INT,
-//					       (GLvoid*)(0 + sizeof(GLuint)*(numElements*3 + outerBoundaryNodes.size())));
+//					       (GLvoid*)(0 + sizeof(GLuint)*outerBoundaryNodes.size()));
 //			glLineWidth(1.0);
 		}
 
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
 		glBindVertexArray(0);
 		glUseProgram(0);
 	}
@@ -124,6 +161,14 @@ void FullDomainSelectionLayer::Draw()
 }
 
 
+/**
+ * @brief Sends the selection to the GPU
+ *
+ * The first call uploads the indices of the whole mesh. After that, only the
+ * ranges of elements that changed since the last call are rewritten, so the
+ * cost of a selection change depends on the number of elements that were
+ * added or removed rather than on the size of the selection.
+ */
 void FullDomainSelectionLayer::LoadDataToGPU()
 {
 	/* Make sure we've got all of the necessary Buffer Objects created */
@@ -133,46 +178,33 @@ void FullDomainSelectionLayer::LoadDataToGPU()
 	/* Make sure initialization succeeded */
 	if (glLoaded && selectedState)
 	{
-		/* Load the connectivity data (elements) to the GPU, getting rid of any data that's already there */
-		std::vector<Element*> *currSelection = selectedState->GetState();
-		const size_t IndexBufferSize = 3*sizeof(GLuint)*currSelection->size() + sizeof(GLuint)*(outerBoundaryNodes.size() + innerBoundaryNodes.size());
-		if (IndexBufferSize && VAOId && IBOId)
+		if (VAOId && IBOId && boundaryIBOId)
 		{
+			glBindVertexArray(VAOId);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexBufferSize, NULL, GL_STATIC_DRAW);
-			GLuint* glElementData = (GLuint*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
-			if (glElementData)
+			if (elementIndices.empty())
 			{
-				Element* currElement;
-				unsigned int i=0;
-				unsigned int currSelectionSize = currSelection->size();
-				for (std::vector<Element*>::iterator it=currSelection->begin(); it != currSelection->end(); ++it, ++i)
-				{
-					currElement = *it;
-					glElementData[3*i+0] = (GLuint)currElement->n1->nodeNumber-1;
-					glElementData[3*i+1] = (GLuint)currElement->n2->nodeNumber-1;
-					glElementData[3*i+2] = (GLuint)currElement->n3->nodeNumber-1;
-				}
-				for (i=0; i<outerBoundaryNodes.size(); ++i)
-				{
-					glElementData[3*currSelectionSize+i] = outerBoundaryNodes[i]-1;
-				}
-				for (i=0; i<innerBoundaryNodes.size(); ++i)
-				{
-					glElementData[3*currSelectionSize+outerBoundaryNodes.size()+i] = innerBoundaryNodes[i]-1;
-				}
+				BuildElementIndices();
+				if (!elementIndices.empty())
+					glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*elementIndices.size(), &elementIndices[0], GL_DYNAMIC_DRAW);
 			} else {
-				glLoaded = false;
-				DEBUG("ERROR: Mapping index buffer for Subdomain Creation Selection Layer " << GetID());
-				emit emitMessage("<p style:color='red'><strong>Error: Unable to load index data to GPU (Subdomain Creation Selection Layer)</strong>");
-				return;
+				UploadChangedElements();
 			}
+			glBindVertexArray(0);
+
+			/* The boundary is rebuilt from scratch, but it is only as large as the outline of the selection */
+			std::vector<GLuint> boundaryIndices;
+			boundaryIndices.reserve(outerBoundaryNodes.size() + innerBoundaryNodes.size());
+			for (unsigned int i=0; i<outerBoundaryNodes.size(); ++i)
+				boundaryIndices.push_back(outerBoundaryNodes[i]-1);
+			for (unsigned int i=0; i<innerBoundaryNodes.size(); ++i)
+				boundaryIndices.push_back(innerBoundaryNodes[i]-1);
 
-			if (glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_FALSE)
+			if (!boundaryIndices.empty())
 			{
-				glLoaded = false;
-				DEBUG("ERROR: Unmapping index buffer for Subdomain Creation Selection Layer " << GetID());
-				return;
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boundaryIBOId);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint)*boundaryIndices.size(), &boundaryIndices[0], GL_DYNAMIC_DRAW);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 			}
 		}
 
@@ -192,7 +224,7 @@ void FullDomainSelectionLayer::LoadDataToGPU()
 		}
 
 		emit Refreshed();
-		emit NumElementsSelected(currSelection->size());
+		emit NumElementsSelected(selectedState->GetState()->size());
 	}
 }
 
@@ -211,7 +243,11 @@ bool FullDomainSelectionLayer::DataLoaded()
 
 void FullDomainSelectionLayer::ClearSelection()
 {
-	ElementState *emptyState = new ElementState();
+	std::vector<Element*> noElements;
+	std::vector<Element*> removed;
+	if (selectedState)
+		removed = *selectedState->GetState();
+	ElementState *emptyState = new ElementState(noElements, noElements, removed);
 	UseNewState(emptyState);
 }
 
@@ -284,6 +320,19 @@ void FullDomainSelectionLayer::UseTool(ToolType tool, SelectionType selection, S
 			CreatePolygonTool();
 		activeTool = polygonTool;
 	}
+	else if (activeToolType == AttributeToolType)
+	{
+		if (!attributeTool)
+			CreateAttributeTool();
+		activeTool = attributeTool;
+	}
+	else if (activeToolType == FloodFillToolType)
+	{
+		/* The click tool picks the seed element of the flood fill */
+		if (!clickTool)
+			CreateClickTool();
+		activeTool = clickTool;
+	}
 
 	if (activeTool)
 		activeTool->UseTool();
@@ -345,6 +394,14 @@ void FullDomainSelectionLayer::Undo()
 	if (!undoStack.empty() && selectedState)
 	{
 		redoStack.push(selectedState);
+		if (boundaryFinder)
+		{
+			/* Reverse the changes made by the state we are leaving */
+			boundaryFinder->RemoveElements(*selectedState->GetAddedElements());
+			boundaryFinder->AddElements(*selectedState->GetRemovedElements());
+		}
+		SetElementIndices(*selectedState->GetAddedElements(), false);
+		SetElementIndices(*selectedState->GetRemovedElements(), true);
 		UseState(undoStack.top());
 		undoStack.pop();
 		emit RedoAvailable(true);
@@ -365,7 +422,15 @@ void FullDomainSelectionLayer::Redo()
 	if (!redoStack.empty() && selectedState)
 	{
 		undoStack.push(selectedState);
-		UseState(redoStack.top());
+		ElementState *nextState = redoStack.top();
+		if (boundaryFinder)
+		{
+			boundaryFinder->RemoveElements(*nextState->GetRemovedElements());
+			boundaryFinder->AddElements(*nextState->GetAddedElements());
+		}
+		SetElementIndices(*nextState->GetRemovedElements(), false);
+		SetElementIndices(*nextState->GetAddedElements(), true);
+		UseState(nextState);
 		redoStack.pop();
 		emit UndoAvailable(true);
 		if (redoStack.empty())
@@ -401,6 +466,17 @@ std::vector<Element*> FullDomainSelectionLayer::GetSelectedElements()
 }
 
 
+/**
+ * @brief Returns the attribute tool so that its test can be set up before it is used
+ */
+AttributeTool* FullDomainSelectionLayer::GetAttributeTool()
+{
+	if (!attributeTool)
+		CreateAttributeTool();
+	return attributeTool;
+}
+
+
 void FullDomainSelectionLayer::AttachToFort14()
 {
 	connect(fort14, SIGNAL(DataLoadedToGPU(GLuint)), this, SLOT(UseVBOId(GLuint)));
@@ -459,6 +535,7 @@ void FullDomainSelectionLayer::InitializeGL()
 
 		glGenVertexArrays(1, &VAOId);
 		glGenBuffers(1, &IBOId);
+		glGenBuffers(1, &boundaryIBOId);
 
 		/* Bind the VBO and IBO to the VAO */
 		glBindVertexArray(VAOId);
@@ -548,6 +625,19 @@ void FullDomainSelectionLayer::CreatePolygonTool()
 }
 
 
+void FullDomainSelectionLayer::CreateAttributeTool()
+{
+	attributeTool = new AttributeTool();
+	attributeTool->SetFort14(fort14);
+	attributeTool->SetCamera(camera);
+
+	connect(attributeTool, SIGNAL(Message(QString)), this, SIGNAL(Message(QString)));
+	connect(attributeTool, SIGNAL(Instructions(QString)), this, SIGNAL(Instructions(QString)));
+	connect(attributeTool, SIGNAL(ToolFinishedDrawing()), this, SLOT(GetSelectionFromTool()));
+	connect(attributeTool, SIGNAL(ToolFinishedDrawing()), this, SIGNAL(ToolFinishedDrawing()));
+}
+
+
 void FullDomainSelectionLayer::UseNewState(ElementState *newState)
 {
 	/* A new selection has been made, so redo is no longer available */
@@ -557,6 +647,15 @@ void FullDomainSelectionLayer::UseNewState(ElementState *newState)
 	undoStack.push(selectedState);
 	emit UndoAvailable(true);
 
+	/* Only the changed elements need to be passed to the boundary tracker */
+	if (boundaryFinder)
+	{
+		boundaryFinder->RemoveElements(*newState->GetRemovedElements());
+		boundaryFinder->AddElements(*newState->GetAddedElements());
+	}
+	SetElementIndices(*newState->GetRemovedElements(), false);
+	SetElementIndices(*newState->GetAddedElements(), true);
+
 	UseState(newState);
 }
 
@@ -566,7 +665,7 @@ void FullDomainSelectionLayer::UseState(ElementState *state)
 	/* Set the current state to the new one */
 	selectedState = state;
 
-	Boundaries *currentBoundaries = selectedState->GetBoundaries();
+	Boundaries *currentBoundaries = selectedState->GetBoundaries(boundaryFinder);
 	outerBoundaryNodes = currentBoundaries->outerBoundaryNodes;
 	innerBoundaryNodes = currentBoundaries->innerBoundaryNodes;
 
@@ -586,57 +685,245 @@ void FullDomainSelectionLayer::GetSelectionFromActiveTool()
 		selectedState = new ElementState();
 	if (activeTool)
 	{
-		/* Create the new state object */
-		ElementState *newState = new ElementState(activeTool->GetSelectedElements());
+		std::vector<Element*> toolList = activeTool->GetSelectedElements();
+
+		/* For a flood fill, the clicked element is the seed of the region */
+		if (activeToolType == FloodFillToolType && toolList.size() > 0)
+		{
+			if (!regionGrower)
+				CreateRegionGrower();
+			if (regionGrower)
+				toolList = regionGrower->FloodFill(toolList[0], *selectedState->GetState(), floodFillUseDepth, floodFillDepth);
+			else
+				toolList.clear();
+		}
 
-		/* Get pointers to new list of selected elements and current list of selected elements */
-		std::vector<Element*> *newList = newState->GetState();
-		std::vector<Element*> *currList = selectedState->GetState();
+		ApplyElementSelection(toolList, currentSelectionMode);
+	}
+}
+
+
+/**
+ * @brief Adds elements to or removes elements from the selection as a new,
+ * undoable state
+ * @param toolList The elements to add or remove
+ * @param mode Select to add the elements, Deselect to remove them
+ */
+void FullDomainSelectionLayer::ApplyElementSelection(std::vector<Element *> toolList, SelectionMode mode)
+{
+	if (!selectedState)
+		selectedState = new ElementState();
 
-		if (newList->size() > 0)
+	if (!boundaryFinder)
+		CreateBoundaryFinder();
+
+	/* Get the elements as a sorted list with no duplicates */
+	std::sort(toolList.begin(), toolList.end());
+	toolList.erase(std::unique(toolList.begin(), toolList.end()), toolList.end());
+
+	/* The current list of selected elements is always sorted */
+	std::vector<Element*> *currList = selectedState->GetState();
+
+	if (toolList.size() > 0)
+	{
+		unsigned int oldNumSelected = currList->size();
+		std::vector<Element*> newList;
+		std::vector<Element*> added;
+		std::vector<Element*> removed;
+
+		if (mode == Select)
 		{
-			unsigned int oldNumSelected = currList->size();
-			if (currList->size() > 0)
-			{
-				if (currentSelectionMode == Select)
-				{
-					/* There are currently selected elements, so combine the lists */
-					newList->reserve(newList->size() + currList->size());
-					newList->insert(newList->end(), currList->begin(), currList->end());
-				} else {
-					/* Create a unique set of the current selection */
-					std::set<Element*> currentSet;
-					currentSet.insert(currList->begin(), currList->end());
-
-					/* Remove the selection just made */
-					for (std::vector<Element*>::iterator it = newList->begin(); it != newList->end(); ++it)
-					{
-						currentSet.erase(*it);
-					}
-
-					/* Add everything that's left to the new list */
-					newList->clear();
-					newList->insert(newList->end(), currentSet.begin(), currentSet.end());
-				}
+			/* Only elements that aren't already selected are added */
+			std::set_difference(toolList.begin(), toolList.end(),
+					    currList->begin(), currList->end(),
+					    std::back_inserter(added));
+			newList.reserve(currList->size() + added.size());
+			std::merge(currList->begin(), currList->end(),
+				   added.begin(), added.end(),
+				   std::back_inserter(newList));
+		} else {
+			/* Only elements that are currently selected are removed */
+			std::set_intersection(toolList.begin(), toolList.end(),
+					      currList->begin(), currList->end(),
+					      std::back_inserter(removed));
+			newList.reserve(currList->size() - removed.size());
+			std::set_difference(currList->begin(), currList->end(),
+					    removed.begin(), removed.end(),
+					    std::back_inserter(newList));
+		}
+
+		emit Message(QString::number(newList.size() - oldNumSelected).append(" new elements selected. <b>").append(QString::number(newList.size()).append("</b> total elements selected.")));
+
+		UseNewState(new ElementState(newList, added, removed));
+	}
+}
+
+
+/**
+ * @brief Adds every element within a number of node rings of the selection
+ *
+ * Useful for padding a subdomain with a buffer of elements. The change can be
+ * undone like any other selection.
+ *
+ * @param numRings The number of element rings to add
+ */
+void FullDomainSelectionLayer::GrowSelection(unsigned int numRings)
+{
+	if (!selectedState || !numRings)
+		return;
+
+	if (!regionGrower)
+		CreateRegionGrower();
+
+	if (regionGrower)
+		ApplyElementSelection(regionGrower->GrowRings(*selectedState->GetState(), numRings), Select);
+}
 
-			}
 
-			/* Sort the new list */
-			std::sort(newList->begin(), newList->end());
+/**
+ * @brief Sets whether a flood fill stops at a depth contour
+ * @param useLimit true to stop at the contour
+ * @param depth The depth of the contour
+ */
+void FullDomainSelectionLayer::SetFloodFillDepthLimit(bool useLimit, float depth)
+{
+	floodFillUseDepth = useLimit;
+	floodFillDepth = depth;
+}
 
-			/* Get rid of any duplicates in the newly created list */
-			std::vector<Element*>::iterator it;
-			it = std::unique(newList->begin(), newList->end());
-			newList->resize(std::distance(newList->begin(), it));
 
-			emit Message(QString::number(newList->size() - oldNumSelected).append(" new elements selected. <b>").append(QString::number(newList->size()).append("</b> total elements selected.")));
+/**
+ * @brief Creates the BoundaryFinder that tracks the selection as it changes
+ *
+ * Requires the fort.14 file to be fully read. If a selection already exists,
+ * it is loaded into the new tracker.
+ */
+void FullDomainSelectionLayer::CreateBoundaryFinder()
+{
+	if (!boundaryFinder && fort14)
+	{
+		MeshAdjacency *adjacency = fort14->GetMeshAdjacency();
+		if (adjacency)
+		{
+			boundaryFinder = new BoundaryFinder(fort14->GetElements(), adjacency);
+			if (selectedState)
+				boundaryFinder->AddElements(*selectedState->GetState());
+		}
+	}
+}
+
+
+/**
+ * @brief Marks elements as selected or unselected in the copy of the index buffer
+ *
+ * The indices come from the mesh's flat adjacency tables when they are
+ * available. The changes are sent to the GPU on the next call to LoadDataToGPU().
+ *
+ * @param elements The elements that changed
+ * @param selected true if the elements are now selected
+ */
+void FullDomainSelectionLayer::SetElementIndices(const std::vector<Element *> &elements, bool selected)
+{
+	/* The whole buffer gets built on the first upload */
+	if (elementIndices.empty())
+		return;
+
+	MeshAdjacency *adjacency = fort14 ? fort14->GetMeshAdjacency() : 0;
+	const unsigned int *meshIndices = adjacency ? adjacency->GetElementNodes() : 0;
+	const unsigned int numMeshElements = elementIndices.size()/3;
 
-			UseNewState(newState);
+	for (std::vector<Element*>::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		if (!*it)
+			continue;
 
+		unsigned int element = (*it)->elementNumber-1;
+		if (element >= numMeshElements)
+			continue;
+
+		GLuint *indices = &elementIndices[3*element];
+		if (!selected)
+		{
+			indices[0] = indices[1] = indices[2] = UnselectedIndex;
+		}
+		else if (meshIndices)
+		{
+			indices[0] = meshIndices[3*element+0];
+			indices[1] = meshIndices[3*element+1];
+			indices[2] = meshIndices[3*element+2];
 		} else {
-			/* No elements were selected, so just go ahead and delete the new list */
-			delete newState;
+			indices[0] = (*it)->n1->nodeNumber-1;
+			indices[1] = (*it)->n2->nodeNumber-1;
+			indices[2] = (*it)->n3->nodeNumber-1;
 		}
+		changedElements.push_back(element);
+	}
+}
+
+
+/**
+ * @brief Fills the copy of the index buffer from the current selection
+ */
+void FullDomainSelectionLayer::BuildElementIndices()
+{
+	changedElements.clear();
+	elementIndices.clear();
+
+	if (!fort14 || !selectedState || fort14->GetNumElements() <= 0)
+		return;
+
+	elementIndices.assign(3*fort14->GetNumElements(), UnselectedIndex);
+	SetElementIndices(*selectedState->GetState(), true);
+	changedElements.clear();
+}
+
+
+/**
+ * @brief Uploads the indices of the elements that changed since the last upload
+ *
+ * Changed elements are sorted and grouped into runs so that nearby changes
+ * (e.g. everything under a circle tool) go out in a single call.
+ */
+void FullDomainSelectionLayer::UploadChangedElements()
+{
+	if (changedElements.empty())
+		return;
+
+	std::sort(changedElements.begin(), changedElements.end());
+	changedElements.erase(std::unique(changedElements.begin(), changedElements.end()), changedElements.end());
+
+	unsigned int i = 0;
+	while (i < changedElements.size())
+	{
+		unsigned int first = changedElements[i];
+		unsigned int last = first;
+		while (++i < changedElements.size() && changedElements[i] - last <= MergeGap)
+			last = changedElements[i];
+
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+				3*sizeof(GLuint)*first,
+				3*sizeof(GLuint)*(last-first+1),
+				&elementIndices[3*first]);
+	}
+
+	changedElements.clear();
+}
+
+
+/**
+ * @brief Creates the RegionGrower used for ring growth and flood fills
+ *
+ * Requires the fort.14 file to be fully read and its Quadtree to be built,
+ * because the results need to point into the same elements as the other tools'.
+ */
+void FullDomainSelectionLayer::CreateRegionGrower()
+{
+	if (!regionGrower && fort14)
+	{
+		MeshAdjacency *adjacency = fort14->GetMeshAdjacency();
+		std::vector<Element> *quadtreeElements = fort14->GetQuadtreeElements();
+		if (adjacency && quadtreeElements)
+			regionGrower = new RegionGrower(adjacency, quadtreeElements);
 	}
 }
 
@@ -4,6 +4,7 @@
 #include <vector>
 #include <stack>
 #include <algorithm>
+#include <iterator>
 
 #include "adcData.h"
 
@@ -17,7 +18,9 @@
 #include "SubdomainTools/CircleTool.h"
 #include "SubdomainTools/RectangleTool.h"
 #include "SubdomainTools/PolygonTool.h"
+#include "SubdomainTools/AttributeTool.h"
 #include "SubdomainTools/BoundaryFinder.h"
+#include "SubdomainTools/RegionGrower.h"
 
 class FullDomainSelectionLayer : public SelectionLayer
 {
@@ -53,6 +56,10 @@ class FullDomainSelectionLayer : public SelectionLayer
 		std::vector<unsigned int>	GetInnerBoundaryNodes();
 		std::vector<unsigned int>	GetOuterBoundaryNodes();
 		std::vector<Element*>		GetSelectedElements();
+		AttributeTool*			GetAttributeTool();
+
+		void	GrowSelection(unsigned int numRings);
+		void	SetFloodFillDepthLimit(bool useLimit, float depth);
 
 	private:
 
@@ -66,7 +73,13 @@ class FullDomainSelectionLayer : public SelectionLayer
 		CircleTool*	circleTool;
 		RectangleTool*	rectangleTool;
 		PolygonTool*	polygonTool;
+		AttributeTool*	attributeTool;
 		BoundaryFinder*	boundaryFinder;
+		RegionGrower*	regionGrower;
+
+		/* Flood Fill Settings */
+		bool	floodFillUseDepth;	/**< Whether a flood fill stops at a depth contour */
+		float	floodFillDepth;		/**< The depth of the contour that stops a flood fill */
 
 		/* Selected Elements */
 		ElementState*	selectedState;
@@ -75,6 +88,12 @@ class FullDomainSelectionLayer : public SelectionLayer
 		std::vector<unsigned int>	outerBoundaryNodes;
 		std::vector<unsigned int>	innerBoundaryNodes;
 
+		/* Index Buffer Contents */
+		static const GLuint		UnselectedIndex = 0xFFFFFFFF;
+		GLuint				boundaryIBOId;		/**< Index buffer holding the boundary nodes */
+		std::vector<GLuint>		elementIndices;		/**< Copy of the IBO, 3 indices per mesh element */
+		std::vector<unsigned int>	changedElements;	/**< Elements whose indices haven't been uploaded yet */
+
 		/* Undo and Redo Stacks */
 		std::stack<ElementState*, std::vector<ElementState*> >	undoStack;
 		std::stack<ElementState*, std::vector<ElementState*> >	redoStack;
@@ -96,11 +115,20 @@ class FullDomainSelectionLayer : public SelectionLayer
 		void	CreateCircleTool();
 		void	CreateRectangleTool();
 		void	CreatePolygonTool();
+		void	CreateAttributeTool();
+		void	CreateBoundaryFinder();
+		void	CreateRegionGrower();
 
 		/* State Functions */
 		void	UseNewState(ElementState* newState);
 		void	UseState(ElementState* state);
 		void	GetSelectionFromActiveTool();
+		void	ApplyElementSelection(std::vector<Element*> toolList, SelectionMode mode);
+
+		/* Index Buffer Functions */
+		void	SetElementIndices(const std::vector<Element*> &elements, bool selected);
+		void	BuildElementIndices();
+		void	UploadChangedElements();
 
 	private slots:
 
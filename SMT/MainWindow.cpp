@@ -318,6 +318,7 @@ void MainWindow::ConnectProject(Project *proj)
 
 	/* Subdomain Creation */
 	connect(ui->createSubdomainButton, SIGNAL(clicked()), proj, SLOT(CreateNewSubdomain()));
+	connect(ui->actionCreate_Subdomains_From_Files, SIGNAL(triggered()), proj, SLOT(CreateNewSubdomainBatch()));
 
 	/* Selection Tools */
 	connect(ui->selectNodesCircle, SIGNAL(clicked()), proj, SLOT(SelectFullDomainCircleElements()));
@@ -328,6 +329,13 @@ void MainWindow::ConnectProject(Project *proj)
 	connect(ui->deselectElementPolygon, SIGNAL(clicked()), proj, SLOT(DeselectFullDomainPolygonElements()));
 	connect(ui->deselectElementSingle, SIGNAL(clicked()), proj, SLOT(DeselectFullDomainClickElements()));
 	connect(ui->deselectElementSquare, SIGNAL(clicked()), proj, SLOT(DeselectFullDomainRectangleElements()));
+	connect(ui->selectElementAttribute, SIGNAL(clicked()), proj, SLOT(SelectFullDomainAttributeElements()));
+	connect(ui->deselectElementAttribute, SIGNAL(clicked()), proj, SLOT(DeselectFullDomainAttributeElements()));
+	connect(ui->selectElementFloodFill, SIGNAL(clicked()), proj, SLOT(SelectFullDomainFloodFillElements()));
+	connect(ui->deselectElementFloodFill, SIGNAL(clicked()), proj, SLOT(DeselectFullDomainFloodFillElements()));
+	connect(ui->growSelection, SIGNAL(clicked()), proj, SLOT(GrowFullDomainSelection()));
+	connect(ui->actionGrow_Selection, SIGNAL(triggered()), proj, SLOT(GrowFullDomainSelection()));
+	connect(ui->actionFlood_Fill_Depth_Limit, SIGNAL(triggered()), proj, SLOT(EditFloodFillDepthLimit()));
 	connect(ui->selectNodeButton, SIGNAL(clicked()), proj, SLOT(SelectSingleSubdomainNode()));
 
 	connect(ui->undoButton, SIGNAL(clicked()), proj, SLOT(Undo()));
@@ -354,6 +362,7 @@ void MainWindow::ConnectProject(Project *proj)
 	/* Running ADCIRC */
 	connect(ui->actionFull_Domain, SIGNAL(triggered()), proj, SLOT(RunFullDomain()));
 	connect(ui->runFullDomainButton, SIGNAL(clicked()), proj, SLOT(RunFullDomain()));
+	connect(ui->actionExtract_Boundary_Conditions, SIGNAL(triggered()), proj, SLOT(ShowExtractBoundaryConditionsDialog()));
 	connect(proj, SIGNAL(subdomainCreated(QString)), this, SLOT(addSubdomainToList(QString)));
 
 	/* Color Options Action Bar */
@@ -681,12 +690,56 @@ void MainWindow::on_visualizeGridButton1_clicked()
     }
 
     // display grid
+    ui->animateFort63Button->setChecked(false);
+    ui->animateFort64Button->setChecked(false);
     if (currentProject!=0){
         currentProject->setDisplay("default",domainIndex, "","");
     }
 }
 
 
+void MainWindow::on_animateFort63Button_clicked(bool checked)
+{
+    int domainIndex = ui->visualizeDomainComboBox->currentIndex();
+
+    if (ui->visualizeDomainComboBox->count()==0 ) {
+        QMessageBox::warning(this,"Project!","No domain is avaliable to visualize. Open or create a project.");
+        ui->animateFort63Button->setChecked(false);
+        return;
+    }
+
+    // play the water levels of the domain, or go back to the grid
+    ui->animateFort64Button->setChecked(false);
+    if (currentProject!=0){
+        if (checked)
+            currentProject->setDisplay("animateFort63",domainIndex, currentProject->GetDomainPath(domainIndex)+"/fort.63","");
+        else
+            currentProject->setDisplay("default",domainIndex, "","");
+    }
+}
+
+
+void MainWindow::on_animateFort64Button_clicked(bool checked)
+{
+    int domainIndex = ui->visualizeDomainComboBox->currentIndex();
+
+    if (ui->visualizeDomainComboBox->count()==0 ) {
+        QMessageBox::warning(this,"Project!","No domain is avaliable to visualize. Open or create a project.");
+        ui->animateFort64Button->setChecked(false);
+        return;
+    }
+
+    // play the velocities of the domain, or go back to the grid
+    ui->animateFort63Button->setChecked(false);
+    if (currentProject!=0){
+        if (checked)
+            currentProject->setDisplay("animateFort64",domainIndex, currentProject->GetDomainPath(domainIndex)+"/fort.64","");
+        else
+            currentProject->setDisplay("default",domainIndex, "","");
+    }
+}
+
+
 void MainWindow::on_visualizeMaxeleButton_clicked()
 {
     int domainIndex = ui->visualizeDomainComboBox->currentIndex();
@@ -703,6 +756,8 @@ void MainWindow::on_visualizeMaxeleButton_clicked()
     }
 
     // set display
+    ui->animateFort63Button->setChecked(false);
+    ui->animateFort64Button->setChecked(false);
     if (currentProject!=0){
         currentProject->setDisplay("maxele",domainIndex, maxeleFileName,"");
     }
@@ -796,3 +851,100 @@ void MainWindow::on_visualizeMaxeleComparisonButton_clicked()
 
 
 }
+
+
+void MainWindow::on_actionCompare_Subdomain_Maxele_triggered()
+{
+    if (currentProject==0 || currentProject->GetNumberOfSubdomains()==0) {
+        QMessageBox::warning(this,"Project!","No subdomain is avaliable to compare. Open or create a project.");
+        return;
+    }
+
+    QString fullMaxeleFileName = ui->fullMaxeleLineEdit->text();
+    if (fullMaxeleFileName.isEmpty()) {
+        fullMaxeleFileName = QFileDialog::getOpenFileName(this,"Open File",QString(),"Full Maxele File (*.63)");
+        if (fullMaxeleFileName.isEmpty())
+            return;
+        ui->fullMaxeleLineEdit->setText(fullMaxeleFileName);
+    }
+
+    // compare every subdomain at once
+    std::vector<MaxeleComparisonResult> results;
+    bool allCompared = currentProject->CompareSubdomainMaxeles(fullMaxeleFileName, &results);
+    if (results.empty()) {
+        QMessageBox::warning(this,"Maxele!","No subdomain maxele could be compared with the full domain maxele.");
+        return;
+    }
+
+    QString summary;
+    for (unsigned int i=0; i<results.size(); i++){
+        summary.append(results[i].name).append(": ");
+        if (results[i].valid){
+            summary.append("RMSE ").append(QString::number(results[i].rmse));
+            summary.append(", max error ").append(QString::number(results[i].maxAbsError)).append("\n");
+        }
+        else{
+            summary.append("not compatible with the full domain\n");
+        }
+    }
+    if (!allCompared){
+        summary.append("\nSome subdomains could not be compared. See the output for details.");
+    }
+    QMessageBox::information(this,"Maxele Comparison",summary);
+}
+
+
+void MainWindow::on_actionConvert_Boundary_File_triggered()
+{
+    QString inFileName = QFileDialog::getOpenFileName(this,"Open File",QString(),"Boundary Condition File (fort.0*)");
+    if (inFileName.isEmpty())
+        return;
+
+    std::ifstream inFile(inFileName.toStdString().data(), std::ios::in | std::ios::binary);
+    if (!inFile.is_open()) {
+        QMessageBox::warning(this,"Boundary File!","Unable to open "+inFileName);
+        return;
+    }
+    bool binary = BoundaryBinaryFormat::IsBinaryFile(inFile);
+    inFile.close();
+
+    // the layout of an ASCII file depends on which file it is
+    unsigned int linesPerRecord = 1;
+    bool hasNodeList = false;
+    unsigned int valueSize = 8;
+    if (!binary) {
+        QString fileType = QFileInfo(inFileName).fileName().left(8);
+        if (fileType == "fort.066" || fileType == "fort.020")
+            linesPerRecord = 2;
+        if (fileType == "fort.019" || fileType == "fort.020" || fileType == "fort.021")
+            hasNodeList = true;
+        else if (fileType != "fort.065" && fileType != "fort.066" && fileType != "fort.067") {
+            QMessageBox::warning(this,"Boundary File!","Choose a fort.065, fort.066, fort.067, fort.019, fort.020 or fort.021 file.");
+            return;
+        }
+
+        QStringList sizes;
+        sizes << "float64" << "float32";
+        bool ok = false;
+        QString size = QInputDialog::getItem(this,"Binary Values","Store the values as:",sizes,0,false,&ok);
+        if (!ok)
+            return;
+        valueSize = (size == "float32") ? 4 : 8;
+    }
+
+    QString outFileName = QFileDialog::getSaveFileName(this,"Save File",inFileName + (binary ? ".txt" : ".bin"));
+    if (outFileName.isEmpty())
+        return;
+
+    bool converted;
+    if (binary)
+        converted = BoundaryBinaryFormat::BinaryToAscii(inFileName, outFileName);
+    else
+        converted = BoundaryBinaryFormat::AsciiToBinary(inFileName, outFileName, linesPerRecord, hasNodeList, valueSize);
+
+    if (!converted) {
+        QMessageBox::warning(this,"Boundary File!","Unable to convert "+inFileName+". See the output for details.");
+        return;
+    }
+    ui->statusBar->showMessage("Converted "+inFileName+" to "+outFileName, 10000);
+}
@@ -9,6 +9,7 @@
 #include "Project/Project.h"
 #include "Dialogs/DisplayOptionsDialog.h"
 #include "Dialogs/CreateProjectDialog.h"
+#include "Project/Files/Workers/BoundaryBinaryFormat.h"
 
 namespace Ui {
 	class MainWindow;
@@ -111,6 +112,10 @@ class MainWindow : public QMainWindow
 
         void on_visualizeGridButton1_clicked();
 
+        void on_animateFort63Button_clicked(bool checked);
+
+        void on_animateFort64Button_clicked(bool checked);
+
         void on_openFullMaxeleButton_clicked();
 
         void on_openSubMaxeleButton_clicked();
@@ -121,6 +126,10 @@ class MainWindow : public QMainWindow
 
         void on_visualizeMaxeleComparisonButton_clicked();
 
+        void on_actionCompare_Subdomain_Maxele_triggered();
+
+        void on_actionConvert_Boundary_File_triggered();
+
 signals:
 
 		void	quit();
@@ -15,17 +15,20 @@ GradientShader::GradientShader()
 	vertexSource =	"#version 110"
 			"\n"
 			"attribute vec4 in_Position;"
+			"attribute float in_Value;"
 			"varying vec4 ex_Color;"
 			"uniform mat4 MVPMatrix;"
 			"uniform int stopCount;"
 			"uniform float values[10];"
 			"uniform vec4 colors[10];"
+			"uniform int useValue;"
 			"void main(void)"
 			"{"
+			"	float value = useValue != 0 ? in_Value : in_Position.z;"
 			"	ex_Color = colors[0];"
 			"	for (int i=1; i<stopCount; ++i)"
 			"	{"
-            "		float t = clamp((in_Position.z - values[i-1]) / (values[i]-values[i-1]), 0.0, 1.0);"
+            "		float t = clamp((value - values[i-1]) / (values[i]-values[i-1]), 0.0, 1.0);"
             "		ex_Color = mix(ex_Color, colors[i], t*t*(3.0 - 2.0*t));"
 			"	}"
 			"	gl_Position = MVPMatrix*in_Position;"
@@ -42,6 +45,7 @@ GradientShader::GradientShader()
 
 	lowValue = 0.0;
 	highValue = 1.0;
+	valueAttribute = false;
 
 	CompileShader();
 	UpdateUniforms();
@@ -68,6 +72,17 @@ void GradientShader::SetGradientRange(float newLow, float newHigh)
 }
 
 
+/**
+ * @brief Sets whether the height comes from the scalar attribute at
+ * ValueLocation instead of the z coordinate of each vertex
+ */
+void GradientShader::SetValueAttribute(bool useAttribute)
+{
+	valueAttribute = useAttribute;
+	UpdateUniforms();
+}
+
+
 QGradientStops GradientShader::GetGradientStops()
 {
 	return gradientStops;
@@ -95,6 +110,7 @@ void GradientShader::CompileShader()
 	{
 		programID = glCreateProgram();
 		glBindAttribLocation(programID, 0, "in_Position");
+		glBindAttribLocation(programID, ValueLocation, "in_Value");
 		glAttachShader(programID, vertexShaderID);
 		glAttachShader(programID, fragmentShaderID);
 		glLinkProgram(programID);
@@ -122,6 +138,7 @@ void GradientShader::UpdateUniforms()
 		GLint StopCountUniform = glGetUniformLocation(programID, "stopCount");
 		GLint ValuesUniform = glGetUniformLocation(programID, "values");
 		GLint ColorsUniform = glGetUniformLocation(programID, "colors");
+		GLint UseValueUniform = glGetUniformLocation(programID, "useValue");
 
 		GLint stopCount = gradientStops.size();
 
@@ -145,6 +162,7 @@ void GradientShader::UpdateUniforms()
 			glUniform1fv(ValuesUniform, stopCount, stopValues);
 			glUniform4fv(ColorsUniform, stopCount, colorValues);
 		}
+		glUniform1i(UseValueUniform, valueAttribute ? 1 : 0);
 
 
 		GLenum errVal = glGetError();
@@ -15,6 +15,10 @@
  * using the low color and height values above the high value are drawn using the
  * high value.
  *
+ * By default the height is the z coordinate of each vertex. A shader can
+ * instead read a separate scalar attribute at ValueLocation, so the values
+ * being colored can change without touching the vertex positions.
+ *
  */
 class GradientShader : public GLShader
 {
@@ -24,9 +28,12 @@ class GradientShader : public GLShader
 		GradientShader();
 		~GradientShader();
 
+		static const GLuint	ValueLocation = 1;
+
 		// Modification Functions
 		void	SetGradientStops(const QGradientStops &newStops);
 		void	SetGradientRange(float lowValue, float newHigh);
+		void	SetValueAttribute(bool useAttribute);
 
 		// Query Functions
 		QGradientStops	GetGradientStops();
@@ -42,6 +49,7 @@ class GradientShader : public GLShader
 		QGradientStops	gradientStops;
 		float		lowValue;
 		float		highValue;
+		bool		valueAttribute;
 
 		// Override virtual functions
 		void	CompileShader();
@@ -7,6 +7,7 @@ Domain::Domain(ProjectFile *projectFile, QObject *parent) :
 	progressBar(0),
 	projectFile(projectFile),
 	selectionLayer(0),
+	animation(0),
 	mapLayer(0),
 	currentMode(DisplayAction),
 	oldx(0.0),
@@ -30,6 +31,9 @@ Domain::Domain(ProjectFile *projectFile, QObject *parent) :
 
 Domain::~Domain()
 {
+	// The animation has to stop before the file it reads is deleted
+	StopAnimation();
+
 	if (camera)
 		delete camera;
 
@@ -331,6 +335,37 @@ float Domain::GetTerrainMaxZ()
 }
 
 
+/**
+ * @brief Plays a time series over the mesh, replacing any animation already playing
+ * @param reader An open reader, which must stay open until StopAnimation() is called
+ */
+bool Domain::StartAnimation(TimeSeriesReader *reader)
+{
+	StopAnimation();
+	if (!fort14 || !reader || reader->GetNumNodes() != (unsigned int)fort14->GetNumNodes())
+		return false;
+
+	animation = new TimeSeriesAnimation(reader, fort14, this);
+	connect(animation, SIGNAL(FrameShown(int,double)), this, SIGNAL(updateGL()));
+	if (!animation->Start())
+	{
+		StopAnimation();
+		return false;
+	}
+	return true;
+}
+
+
+void Domain::StopAnimation()
+{
+	if (animation)
+	{
+		delete animation;
+		animation = 0;
+	}
+}
+
+
 void Domain::Zoom(float zoomAmount)
 {
 	if (camera)
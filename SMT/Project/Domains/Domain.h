@@ -9,6 +9,7 @@
 
 #include "Project/Files/ProjectFile.h"
 #include "Project/Files/Fort14.h"
+#include "Project/Files/Workers/TimeSeriesAnimation.h"
 
 #include "OpenGL/GLCamera.h"
 
@@ -64,6 +65,9 @@ class Domain : public QObject
 		float		GetTerrainMinZ();
 		float		GetTerrainMaxZ();
 
+		bool		StartAnimation(TimeSeriesReader *reader);
+		void		StopAnimation();
+
 	protected:
 
 		GLCamera*		camera;
@@ -71,6 +75,7 @@ class Domain : public QObject
 		QProgressBar*		progressBar;
 		ProjectFile*		projectFile;
 		SelectionLayer*		selectionLayer;
+		TimeSeriesAnimation*	animation;
 //		OpenStreetMapLayer*	mapLayer;
 
 		OSMTileLayer*		mapLayer;
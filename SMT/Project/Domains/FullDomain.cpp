@@ -19,6 +19,7 @@ FullDomain::FullDomain(ProjectFile *projectFile, QObject *parent) :
 	selectionLayerFullDomain = new FullDomainSelectionLayer(fort14, this);
 	selectionLayer = selectionLayerFullDomain;
 	selectionLayer->SetCamera(camera);
+	selectionLayerFullDomain->GetAttributeTool()->SetFort13(fort13);
 
 	connect(selectionLayer, SIGNAL(ToolFinishedDrawing()), this, SLOT(EnterDisplayMode()));
 	connect(selectionLayer, SIGNAL(UndoAvailable(bool)), this, SIGNAL(undoAvailable(bool)));
@@ -45,6 +46,12 @@ bool FullDomain::IsFullDomain()
 }
 
 
+Fort13* FullDomain::GetFort13()
+{
+	return fort13;
+}
+
+
 Fort015* FullDomain::GetFort015()
 {
 	return fort015;
@@ -76,6 +83,30 @@ std::vector<Element*> FullDomain::GetSelectedElements()
 	return selectionLayerFullDomain->GetSelectedElements();
 }
 
+/**
+ * @brief Returns the tool used to select elements by depth, nodal attribute or maxele
+ *
+ * Set up the test on the returned tool, then call UseTool(AttributeToolType, ...)
+ * to apply it to the selection.
+ */
+AttributeTool* FullDomain::GetAttributeTool()
+{
+	return selectionLayerFullDomain->GetAttributeTool();
+}
+
+
+void FullDomain::GrowSelection(unsigned int numRings)
+{
+	selectionLayerFullDomain->GrowSelection(numRings);
+}
+
+
+void FullDomain::SetFloodFillDepthLimit(bool useLimit, float depth)
+{
+	selectionLayerFullDomain->SetFloodFillDepthLimit(useLimit, depth);
+}
+
+
 void FullDomain::CreateAllFiles()
 {
 	fort13 = new Fort13(projectFile, this);
@@ -97,6 +128,8 @@ void FullDomain::CreateAllFiles()
 
 void FullDomain::visualizeDomain(QString displayMode, QString FileName){
 
+    StopAnimation();
+
     if (displayMode == "maxele"){
 
         maxele63 = new Maxele63(FileName, "Full Domain", projectFile,  this);
@@ -120,8 +153,20 @@ void FullDomain::visualizeDomain(QString displayMode, QString FileName){
             return;
         }
     }
+    else if (displayMode == "animateFort63"){
+        if ( !fort63->StartReading(FileName) || !StartAnimation(fort63->GetReader()) ){
+            QMessageBox::warning(0,"Fort.63!","Fort.63 file can't be animated on the domain");
+            return;
+        }
+    }
+    else if (displayMode == "animateFort64"){
+        if ( !fort64->StartReading(FileName) || !StartAnimation(fort64->GetReader()) ){
+            QMessageBox::warning(0,"Fort.64!","Fort.64 file can't be animated on the domain");
+            return;
+        }
+    }
     else if (displayMode =="default"){
-        fort14->RefreshGL();
+        fort14->ShowBathymetryGL();
         updateGL();
     }
 
@@ -36,11 +36,15 @@ class FullDomain : public Domain
 
 		virtual bool	IsFullDomain();
 
+		Fort13*				GetFort13();
 		Fort015*			GetFort015();
 		std::vector<unsigned int>	GetInnerBoundaryNodes();
 		std::vector<unsigned int>	GetOuterBoundaryNodes();
         QString			GetPath();
 		std::vector<Element*>		GetSelectedElements();
+		AttributeTool*			GetAttributeTool();
+		void				GrowSelection(unsigned int numRings);
+		void				SetFloodFillDepthLimit(bool useLimit, float depth);
         void visualizeDomain(QString displayMode, QString FileName);
 
 	private:
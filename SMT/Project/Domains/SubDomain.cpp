@@ -164,17 +164,28 @@ void SubDomain::CreateAllFiles()
 }
 
 
-void SubDomain::setMaxeleDif(Maxele63 * fullMaxele63){
-
-    for (int i=0; i<fort14->GetNumNodes();i++){
-        unsigned int old = py140->ConvertNewToOld(i+1);
-        fort14->setMaxeleDif( fullMaxele63->GetMaxele(old-1), i );
+bool SubDomain::setMaxeleDif(Maxele63 * fullMaxele63){
+
+    MaxeleComparisonInput input;
+    input.name = domainName;
+    input.newToOld = &py140->GetNewToOld();
+    input.maxele = &maxele63->GetMaxeles();
+
+    MaxeleComparison comparison;
+    MaxeleComparisonResult result;
+    bool compared = comparison.Compare(fullMaxele63->GetMaxeles(), input, &result);
+    MaxeleComparison::PrintSummary(result);
+    if (compared){
+        fort14->setMaxeleDif(result.differences, result.minDifference, result.maxDifference);
     }
+    return compared;
 }
 
 
 void SubDomain::visualizeDomain(QString displayMode, QString FileName,Maxele63 * fullMaxele63){
 
+    StopAnimation();
+
     if (displayMode == "maxele"){
 
         maxele63 = new Maxele63(FileName, "Subdomain", projectFile,  this);
@@ -191,8 +202,7 @@ void SubDomain::visualizeDomain(QString displayMode, QString FileName,Maxele63 *
     }
     else if (displayMode == "compareMaxele"){
         maxele63 = new Maxele63(FileName, "Subdomain", projectFile,  this);
-        if ( fort14->setMaxele( maxele63 ) ){
-            setMaxeleDif(fullMaxele63);
+        if ( fort14->setMaxele( maxele63 ) && setMaxeleDif(fullMaxele63) ){
             float minMaxele = fort14->GetMinDif();
             float maxMaxele = fort14->GetMaxDif();
             fort14->maxeleGL(minMaxele,maxMaxele);
@@ -204,9 +214,21 @@ void SubDomain::visualizeDomain(QString displayMode, QString FileName,Maxele63 *
         }
 
 
+    }
+    else if (displayMode == "animateFort63"){
+        if ( !fort63->StartReading(FileName) || !StartAnimation(fort63->GetReader()) ){
+            QMessageBox::warning(0,"Fort.63!","Fort.63 file can't be animated on the domain");
+            return;
+        }
+    }
+    else if (displayMode == "animateFort64"){
+        if ( !fort64->StartReading(FileName) || !StartAnimation(fort64->GetReader()) ){
+            QMessageBox::warning(0,"Fort.64!","Fort.64 file can't be animated on the domain");
+            return;
+        }
     }
     else if (displayMode =="default"){
-        fort14->RefreshGL();
+        fort14->ShowBathymetryGL();
         updateGL();
     }
 
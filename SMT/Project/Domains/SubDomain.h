@@ -3,10 +3,13 @@
 
 #include <iostream>
 #include <set>
+#include <algorithm>
 
 #include <QObject>
 #include <QProgressBar>
 
+#include "Adcirc/MaxeleComparison.h"
+
 #include "Project/Domains/Domain.h"
 
 #include "Layers/SelectionLayers/SubDomainSelectionLayer.h"
@@ -50,7 +53,7 @@ class SubDomain : public Domain
 		void	SaveAllChanges();
 		void	SetNodalValues(unsigned int nodeNumber, QString x, QString y, QString z);
         void    visualizeDomain(QString displayMode, QString FileName, Maxele63 * fullMaxele63);
-        void    setMaxeleDif(Maxele63 * fullMaxele63);
+        bool    setMaxeleDif(Maxele63 * fullMaxele63);
 	private:
 
 		SubDomainSelectionLayer*	selectionLayerSubdomain;
@@ -59,9 +59,15 @@ void BNList14::SetSubdomainVersion(int v)
 }
 
 
-void BNList14::SaveFile()
+/**
+ * @brief Writes the file
+ *
+ * The file location was recorded in the project file by the constructor, so
+ * saving doesn't touch the project file and can be done from a worker thread.
+ */
+bool BNList14::SaveFile()
 {
-	if (projectFile && !domainName.isNull())
+	if (projectFile && !domainName.isNull() && !targetFile.isEmpty())
 	{
 		std::ofstream file (targetFile.toStdString().data());
 		if (file.is_open())
@@ -95,10 +101,10 @@ void BNList14::SaveFile()
 				// Throw warning that version isn't set
 			}
 			file.close();
-
-			projectFile->SetSubDomainBNList(domainName, targetFile);
+			return !file.fail();
 		}
 	}
+	return false;
 }
 
 
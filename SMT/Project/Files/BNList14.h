@@ -21,7 +21,7 @@ class BNList14 : public QObject
 		void	SetInnerBoundaryNodes(std::vector<unsigned int> newNodes);
 		void	SetOuterBoundaryNodes(std::vector<unsigned int> newNodes);
 		void	SetSubdomainVersion(int v);
-		void	SaveFile();
+		bool	SaveFile();
 
 		QString				GetFilePath();
 		std::vector<unsigned int>	GetInnerBoundaryNodes();
@@ -1,5 +1,124 @@
 #include "Fort015.h"
 
+
+/*
+ * Text helpers for the reader and writer
+ */
+
+static const char* ReadNumber(const char *pos, const char *end, unsigned int *value)
+{
+	while (pos < end && (*pos < '0' || *pos > '9'))
+		++pos;
+	if (pos == end)
+		return 0;
+
+	unsigned int result = 0;
+	while (pos < end && *pos >= '0' && *pos <= '9')
+		result = 10*result + (*pos++ - '0');
+	*value = result;
+	return pos;
+}
+
+
+/*
+ * Reads the number at the start of a line and moves past the end of the line
+ */
+static const char* ReadLineNumber(const char *pos, const char *end, int *value)
+{
+	if (!pos)
+		return 0;
+	const char *lineEnd = (const char*)memchr(pos, '\n', end - pos);
+	lineEnd = lineEnd ? lineEnd+1 : end;
+	unsigned int result = 0;
+	if (ReadNumber(pos, lineEnd, &result))
+		*value = result;
+	return lineEnd;
+}
+
+
+static const char* ReadNodeList(const char *pos, const char *end, int numNodes, std::vector<unsigned int> *nodes)
+{
+	nodes->reserve(nodes->size() + std::max(numNodes, 0));
+	unsigned int currNode;
+	for (int i=0; i<numNodes && pos; ++i)
+		if ((pos = ReadNumber(pos, end, &currNode)))
+			nodes->push_back(currNode);
+	return pos;
+}
+
+
+static char* WriteNumber(char *out, unsigned int value)
+{
+	char digits[10];
+	int numDigits = 0;
+	do {
+		digits[numDigits++] = '0' + value%10;
+		value /= 10;
+	} while (value);
+	while (numDigits)
+		*out++ = digits[--numDigits];
+	return out;
+}
+
+
+/*
+ * Sorts a list and removes duplicates
+ */
+static void SortUnique(std::vector<unsigned int> *nodes)
+{
+	std::sort(nodes->begin(), nodes->end());
+	nodes->erase(std::unique(nodes->begin(), nodes->end()), nodes->end());
+}
+
+
+/*
+ * Merges any number of lists into a sorted list without duplicates, taking the
+ * smallest front value of all of the lists at each step. Returns true if nodes
+ * were added to the list.
+ */
+static bool MergeNodeLists(std::vector<unsigned int> *nodes, std::vector<std::vector<unsigned int> > *newLists)
+{
+	if (newLists->empty())
+		return false;
+
+	std::vector<std::vector<unsigned int> > lists;
+	lists.reserve(newLists->size() + 1);
+	lists.push_back(std::vector<unsigned int>());
+	lists.back().swap(*nodes);
+	unsigned int totalSize = lists.back().size();
+	for (std::vector<std::vector<unsigned int> >::iterator it = newLists->begin(); it != newLists->end(); ++it)
+	{
+		lists.push_back(std::vector<unsigned int>());
+		lists.back().swap(*it);
+		SortUnique(&lists.back());
+		totalSize += lists.back().size();
+	}
+	newLists->clear();
+
+	typedef std::pair<unsigned int, unsigned int> HeapEntry;	// (node, list)
+	std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > heap;
+	std::vector<unsigned int> positions (lists.size(), 0);
+	for (unsigned int i=0; i<lists.size(); ++i)
+		if (!lists[i].empty())
+			heap.push(HeapEntry(lists[i][0], i));
+
+	unsigned int oldSize = lists[0].size();
+	nodes->reserve(totalSize);
+	while (!heap.empty())
+	{
+		HeapEntry smallest = heap.top();
+		heap.pop();
+		if (nodes->empty() || nodes->back() != smallest.first)
+			nodes->push_back(smallest.first);
+
+		unsigned int list = smallest.second;
+		if (++positions[list] < lists[list].size())
+			heap.push(HeapEntry(lists[list][positions[list]], list));
+	}
+
+	return nodes->size() != oldSize;
+}
+
 /*
  * Default empty constructor
  */
@@ -14,7 +133,11 @@ Fort015::Fort015(QObject *parent) :
 	projectFile(0),
 	recordFrequency(0),
 	subdomainApproach(0),
-	targetFile()
+	targetFile(),
+	modified(true),
+	newBoundaryNodes(),
+	newInnerBoundaryNodes(),
+	newOuterBoundaryNodes()
 {
 }
 
@@ -33,7 +156,11 @@ Fort015::Fort015(ProjectFile *projectFile, QObject *parent) :
 	projectFile(projectFile),
 	recordFrequency(0),
 	subdomainApproach(0),
-	targetFile()
+	targetFile(),
+	modified(true),
+	newBoundaryNodes(),
+	newInnerBoundaryNodes(),
+	newOuterBoundaryNodes()
 {
 	targetFile = projectFile->GetFullDomainFort015();
 	if (targetFile.isEmpty())
@@ -59,7 +186,11 @@ Fort015::Fort015(QString domainName, ProjectFile *projectFile, QObject *parent)
 	projectFile(projectFile),
 	recordFrequency(0),
 	subdomainApproach(0),
-	targetFile()
+	targetFile(),
+	modified(true),
+	newBoundaryNodes(),
+	newInnerBoundaryNodes(),
+	newOuterBoundaryNodes()
 {
 	if (projectFile && !domainName.isEmpty())
 	{
@@ -87,27 +218,30 @@ Fort015::Fort015(QString domainName, ProjectFile *projectFile, QObject *parent)
 
 void Fort015::AddBoundaryNodes(std::vector<unsigned int> newNodes)
 {
-	for (std::vector<unsigned int>::iterator it = newNodes.begin(); it != newNodes.end(); ++it)
+	if (!newNodes.empty())
 	{
-		boundaryNodes.insert(*it);
+		newBoundaryNodes.push_back(std::vector<unsigned int>());
+		newBoundaryNodes.back().swap(newNodes);
 	}
 }
 
 
 void Fort015::AddInnerBoundaryNodes(std::vector<unsigned int> newNodes)
 {
-	for (std::vector<unsigned int>::iterator it = newNodes.begin(); it != newNodes.end(); ++it)
+	if (!newNodes.empty())
 	{
-		innerBoundaryNodes.insert(*it);
+		newInnerBoundaryNodes.push_back(std::vector<unsigned int>());
+		newInnerBoundaryNodes.back().swap(newNodes);
 	}
 }
 
 
 void Fort015::AddOuterBoundaryNodes(std::vector<unsigned int> newNodes)
 {
-	for (std::vector<unsigned int>::iterator it = newNodes.begin(); it != newNodes.end(); ++it)
+	if (!newNodes.empty())
 	{
-		outerBoundaryNodes.insert(*it);
+		newOuterBoundaryNodes.push_back(std::vector<unsigned int>());
+		newOuterBoundaryNodes.back().swap(newNodes);
 	}
 }
 
@@ -118,20 +252,23 @@ bool Fort015::FileExists()
 }
 
 
-std::set<unsigned int> Fort015::GetBoundaryNodes()
+const std::vector<unsigned int>& Fort015::GetBoundaryNodes()
 {
+	MergeNewNodes();
 	return boundaryNodes;
 }
 
 
-std::set<unsigned int> Fort015::GetInnerBoundaryNodes()
+const std::vector<unsigned int>& Fort015::GetInnerBoundaryNodes()
 {
+	MergeNewNodes();
 	return innerBoundaryNodes;
 }
 
 
-std::set<unsigned int> Fort015::GetOuterBoundaryNodes()
+const std::vector<unsigned int>& Fort015::GetOuterBoundaryNodes()
 {
+	MergeNewNodes();
 	return outerBoundaryNodes;
 }
 
@@ -150,33 +287,45 @@ int Fort015::GetSubdomainApproach()
 
 void Fort015::SetSubdomainApproach(int approach)
 {
+	if (approach != subdomainApproach)
+		modified = true;
 	subdomainApproach = approach;
 }
 
 
 void Fort015::SetRecordFrequency(int frequency)
 {
+	if (frequency != recordFrequency)
+		modified = true;
 	recordFrequency = frequency;
 }
 
 
+/**
+ * @brief Writes the file if anything has changed since it was read or written
+ */
 void Fort015::WriteFile()
 {
-	std::ofstream file (targetFile.toStdString().data());
+	MergeNewNodes();
+	if (!modified && FileExists())
+		return;
+
+	std::ofstream file (targetFile.toStdString().data(), std::ios::out | std::ios::binary);
 	if (file.is_open())
 	{
 		if (isFullDomainFile)
 		{
-			file << subdomainApproach << "\t!NOUTGS\n";
-			file << recordFrequency << "\t!NSPOOLGS\n";
-			file << "0\t!enforceBN\n";
-			file << boundaryNodes.size() << "\t!ncbnr\n";
-			for (std::set<unsigned int>::iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
+			std::vector<char> buffer (128 + 11*boundaryNodes.size());
+			char *out = &buffer[0];
+			out += sprintf(out, "%d\t!NOUTGS\n%d\t!NSPOOLGS\n0\t!enforceBN\n%u\t!ncbnr\n",
+				       subdomainApproach, recordFrequency, (unsigned int)boundaryNodes.size());
+			for (std::vector<unsigned int>::iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
 			{
-				file << *it << "\n";
+				out = WriteNumber(out, *it);
+				*out++ = '\n';
 			}
-			file << "0\t!nobnr\n";
-			file << "0\t!nibnr\n";
+			out += sprintf(out, "0\t!nobnr\n0\t!nibnr\n");
+			file.write(&buffer[0], out - &buffer[0]);
 			file.close();
 			projectFile->SetFullDomainFort015(targetFile);
 		} else {
@@ -189,70 +338,90 @@ void Fort015::WriteFile()
 			file.close();
 			projectFile->SetSubDomainFort015(domainName, targetFile);
 		}
+		modified = false;
 	} else {
 		std::cout << "Unable to write fort.015 file" << std::endl;
 	}
 }
 
 
+/**
+ * @brief Merges all of the nodes added since the last merge into the sorted lists
+ */
+void Fort015::MergeNewNodes()
+{
+	if (MergeNodeLists(&boundaryNodes, &newBoundaryNodes))
+		modified = true;
+	if (MergeNodeLists(&innerBoundaryNodes, &newInnerBoundaryNodes))
+		modified = true;
+	if (MergeNodeLists(&outerBoundaryNodes, &newOuterBoundaryNodes))
+		modified = true;
+}
+
+
+/**
+ * @brief Reads the whole file into memory and parses the node lists directly
+ */
 void Fort015::ReadFile()
 {
-	std::ifstream file (targetFile.toStdString().data());
-	if (file.is_open() && isFullDomainFile)
+	std::ifstream file (targetFile.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return;
+
+	file.seekg(0, std::ios::end);
+	std::streamoff fileSize = file.tellg();
+	file.seekg(0, std::ios::beg);
+	if (fileSize <= 0)
+		return;
+
+	std::vector<char> contents (fileSize);
+	file.read(&contents[0], fileSize);
+	file.close();
+
+	const char *pos = &contents[0];
+	const char *end = pos + file.gcount();
+
+	if (isFullDomainFile)
 	{
+		boundaryNodes.clear();
 		innerBoundaryNodes.clear();
 		outerBoundaryNodes.clear();
 
-		std::string line;
-		std::getline(file, line);
-		std::stringstream(line) >> subdomainApproach;
-		std::getline(file, line);
-		std::stringstream(line) >> recordFrequency;
-		std::getline(file, line);
-		std::stringstream(line) >> enforceBN;
+		pos = ReadLineNumber(pos, end, &subdomainApproach);
+		pos = ReadLineNumber(pos, end, &recordFrequency);
+		pos = ReadLineNumber(pos, end, &enforceBN);
 
 		if (subdomainApproach == 1)
 		{
-			std::getline(file, line);
-			int numBN;
-			std::stringstream(line) >> numBN;
-			int currNode;
-			for (int i=0; i<numBN; ++i)
-			{
-				file >> currNode;
-				boundaryNodes.insert(currNode);
-			}
+			int numBN = 0;
+			pos = ReadLineNumber(pos, end, &numBN);
+			ReadNodeList(pos, end, numBN, &boundaryNodes);
 		}
 		else if (subdomainApproach == 2)
 		{
-			std::getline(file, line);
-			int numOuterBN;
-			std::stringstream(line) >> numOuterBN;
-			int currNode;
-			for (int i=0; i<numOuterBN; ++i)
-			{
-				file >> currNode;
-				outerBoundaryNodes.insert(currNode);
-			}
-			std::getline(file, line);
-			std::getline(file, line);
-			int numInnerBN;
-			std::stringstream(line) >> numInnerBN;
-			for (int i=0; i<numInnerBN; ++i)
+			int numOuterBN = 0;
+			pos = ReadLineNumber(pos, end, &numOuterBN);
+			pos = ReadNodeList(pos, end, numOuterBN, &outerBoundaryNodes);
+			if (pos)
 			{
-				file >> currNode;
-				innerBoundaryNodes.insert(currNode);
+				// Move past the end of the last node line
+				const char *lineEnd = (const char*)memchr(pos, '\n', end - pos);
+				pos = lineEnd ? lineEnd+1 : end;
 			}
+			int numInnerBN = 0;
+			pos = ReadLineNumber(pos, end, &numInnerBN);
+			ReadNodeList(pos, end, numInnerBN, &innerBoundaryNodes);
 		}
 
-		file.close();
-	}
-	else if (file.is_open() && !isFullDomainFile)
-	{
-		std::string line;
-		std::getline(file, line);
-		std::getline(file, line);
-		file >> subdomainApproach;
-		file.close();
+		// Files written by older versions weren't always sorted
+		SortUnique(&boundaryNodes);
+		SortUnique(&innerBoundaryNodes);
+		SortUnique(&outerBoundaryNodes);
+	} else {
+		pos = ReadLineNumber(pos, end, &recordFrequency);
+		pos = ReadLineNumber(pos, end, &recordFrequency);
+		ReadLineNumber(pos, end, &subdomainApproach);
 	}
+
+	modified = false;
 }
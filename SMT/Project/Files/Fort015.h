@@ -1,7 +1,12 @@
 #ifndef FORT015_NEW_H
 #define FORT015_NEW_H
 
-#include <set>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <ostream>
 #include <sstream>
@@ -10,6 +15,15 @@
 
 #include "Project/Files/ProjectFile.h"
 
+/**
+ * @brief The fort.015 file, which tells ADCIRC which nodes to record for subdomains
+ *
+ * Boundary node lists are kept as sorted vectors. Nodes added with the Add functions
+ * are held back until the lists are needed, and then all of them are merged into
+ * the sorted list in one k-way merge. WriteFile() only rewrites the file when the
+ * merge added new nodes or one of the settings changed.
+ *
+ */
 class Fort015 : public QObject
 {
 		Q_OBJECT
@@ -23,9 +37,9 @@ class Fort015 : public QObject
 		void			AddInnerBoundaryNodes(std::vector<unsigned int> newNodes);
 		void			AddOuterBoundaryNodes(std::vector<unsigned int> newNodes);
 		bool			FileExists();
-		std::set<unsigned int>	GetBoundaryNodes();
-		std::set<unsigned int>	GetInnerBoundaryNodes();
-		std::set<unsigned int>	GetOuterBoundaryNodes();
+		const std::vector<unsigned int>&	GetBoundaryNodes();
+		const std::vector<unsigned int>&	GetInnerBoundaryNodes();
+		const std::vector<unsigned int>&	GetOuterBoundaryNodes();
 		int			GetRecordFrequency();
 		int			GetSubdomainApproach();
 		void			SetSubdomainApproach(int approach);
@@ -36,17 +50,22 @@ class Fort015 : public QObject
 
 
 		QString			domainName;
-		std::set<unsigned int>	boundaryNodes;
+		std::vector<unsigned int>	boundaryNodes;		/**< Sorted, without duplicates */
 		int			enforceBN;
-		std::set<unsigned int>	innerBoundaryNodes;
+		std::vector<unsigned int>	innerBoundaryNodes;	/**< Sorted, without duplicates */
 		bool			isFullDomainFile;
-		std::set<unsigned int>	outerBoundaryNodes;
+		std::vector<unsigned int>	outerBoundaryNodes;	/**< Sorted, without duplicates */
 		ProjectFile*		projectFile;
 		int			recordFrequency;
 		int			subdomainApproach;
 		QString			targetFile;
+		bool			modified;		/**< The file needs to be written */
 
+		std::vector<std::vector<unsigned int> >	newBoundaryNodes;	/**< Lists waiting to be merged into boundaryNodes */
+		std::vector<std::vector<unsigned int> >	newInnerBoundaryNodes;
+		std::vector<std::vector<unsigned int> >	newOuterBoundaryNodes;
 
+		void	MergeNewNodes();
 		void	ReadFile();
 };
 
@@ -0,0 +1,110 @@
+#include "Fort019.h"
+
+
+static const char Title[] = "Boundary conditions for subdomain\n";
+
+
+Fort019::Fort019(QObject *parent) :
+	QObject(parent),
+	domainName(),
+	writer(),
+	projectFile(0)
+{
+}
+
+
+Fort019::Fort019(QString domainName, ProjectFile *projectFile, QObject *parent) :
+	QObject(parent),
+	domainName(domainName),
+	writer(),
+	projectFile(projectFile)
+{
+
+}
+
+
+/**
+ * @brief Starts a new file
+ * @param binary true to write the binary layout, which starts with
+ * WriteBinaryHeader() instead of a title and WriteHeader()
+ */
+bool Fort019::StartWriting(bool binary)
+{
+	if (!writer.StartWriting(GetFilePath()))
+		return false;
+
+	if (!binary)
+		writer.WriteBytes(Title, sizeof(Title) - 1);
+	return true;
+}
+
+
+bool Fort019::ResumeWriting(quint64 offset)
+{
+	return writer.ResumeWriting(GetFilePath(), offset);
+}
+
+
+void Fort019::WriteHeader(int numTS, std::vector<unsigned int> nodeList)
+{
+	writer.WriteHeader(numTS, nodeList);
+}
+
+
+void Fort019::WriteBinaryHeader(const BoundaryBinaryHeader &header)
+{
+	writer.WriteBinaryHeader(header);
+}
+
+
+void Fort019::WriteTimestep(const std::vector<std::string> &tsData)
+{
+	for (std::vector<std::string>::const_iterator it = tsData.begin(); it != tsData.end(); ++it)
+	{
+		writer.WriteBytes(it->data(), it->size());
+	}
+}
+
+
+void Fort019::WriteBytes(const char *data, size_t length)
+{
+	writer.WriteBytes(data, length);
+}
+
+
+bool Fort019::Checkpoint(quint64 *offset)
+{
+	return writer.Checkpoint(offset);
+}
+
+
+void Fort019::FinishedWriting()
+{
+	writer.FinishedWriting();
+}
+
+
+bool Fort019::CommitFile()
+{
+	return writer.CommitFile();
+}
+
+
+QString Fort019::GetFilePath()
+{
+	if (projectFile && !domainName.isEmpty())
+	{
+		QString targetFile = projectFile->GetSubDomainFort019(domainName);
+		if (targetFile.isEmpty())
+		{
+			QDir targetDirectory (projectFile->GetSubDomainDirectory(domainName));
+			if (targetDirectory.exists())
+			{
+				targetFile = targetDirectory.absolutePath() + QDir::separator() + "fort.019";
+				projectFile->SetSubDomainFort019(domainName, targetFile);
+			}
+		}
+		return targetFile;
+	}
+	return QString("");
+}
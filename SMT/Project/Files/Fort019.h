@@ -0,0 +1,43 @@
+#ifndef FORT019_H
+#define FORT019_H
+
+#include <QObject>
+
+#include <vector>
+#include <string>
+
+#include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/BoundaryFileWriter.h"
+
+/**
+ * @brief Writes the fort.019 boundary condition file of a subdomain
+ *
+ * The records are written through a BoundaryFileWriter.
+ */
+class Fort019 : public QObject
+{
+		Q_OBJECT
+	public:
+		explicit Fort019(QObject *parent=0);
+		Fort019(QString domainName, ProjectFile *projectFile, QObject *parent=0);
+
+		bool	StartWriting(bool binary = false);
+		bool	ResumeWriting(quint64 offset);
+		void	WriteHeader(int numTS, std::vector<unsigned int> nodeList);
+		void	WriteBinaryHeader(const BoundaryBinaryHeader &header);
+		void	WriteTimestep(const std::vector<std::string> &tsData);
+		void	WriteBytes(const char *data, size_t length);
+		bool	Checkpoint(quint64 *offset);
+		void	FinishedWriting();
+		bool	CommitFile();
+
+	private:
+
+		QString			domainName;
+		BoundaryFileWriter	writer;
+		ProjectFile*	projectFile;
+
+		QString	GetFilePath();
+};
+
+#endif // FORT019_H
@@ -1,9 +1,13 @@
 #include "Fort020.h"
 
+
+static const char Title[] = "Boundary conditions for subdomain\n";
+
+
 Fort020::Fort020(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	file(),
+	writer(),
 	projectFile(0)
 {
 }
@@ -12,58 +16,77 @@ Fort020::Fort020(QObject *parent) :
 Fort020::Fort020(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	file(),
+	writer(),
 	projectFile(projectFile)
 {
 
 }
 
 
-bool Fort020::StartWriting()
+/**
+ * @brief Starts a new file
+ * @param binary true to write the binary layout, which starts with
+ * WriteBinaryHeader() instead of a title and WriteHeader()
+ */
+bool Fort020::StartWriting(bool binary)
 {
-	QString targetFile = GetFilePath();
-	if (!targetFile.isEmpty())
-	{
-		file.open(targetFile.toStdString().data());
-		if (file.is_open())
-		{
-			file << "Boundary conditions for subdomain\n";
-			return true;
-		}
-	}
-	return false;
+	if (!writer.StartWriting(GetFilePath()))
+		return false;
+
+	if (!binary)
+		writer.WriteBytes(Title, sizeof(Title) - 1);
+	return true;
+}
+
+
+bool Fort020::ResumeWriting(quint64 offset)
+{
+	return writer.ResumeWriting(GetFilePath(), offset);
 }
 
 
 void Fort020::WriteHeader(int numTS, std::vector<unsigned int> nodeList)
 {
-	if (file.is_open())
-	{
-		file << "1\t" << nodeList.size() << "\t" << numTS << "\n";
-		for (std::vector<unsigned int>::iterator it = nodeList.begin(); it != nodeList.end(); ++it)
-		{
-			file << *it << "\n";
-		}
-	}
+	writer.WriteHeader(numTS, nodeList);
+}
+
+
+void Fort020::WriteBinaryHeader(const BoundaryBinaryHeader &header)
+{
+	writer.WriteBinaryHeader(header);
 }
 
 
-void Fort020::WriteTimestep(std::vector<std::string> tsData)
+void Fort020::WriteTimestep(const std::vector<std::string> &tsData)
 {
-	if (file.is_open())
+	for (std::vector<std::string>::const_iterator it = tsData.begin(); it != tsData.end(); ++it)
 	{
-		for (std::vector<std::string>::iterator it = tsData.begin(); it != tsData.end(); ++it)
-		{
-			file << *it;
-		}
+		writer.WriteBytes(it->data(), it->size());
 	}
 }
 
 
+void Fort020::WriteBytes(const char *data, size_t length)
+{
+	writer.WriteBytes(data, length);
+}
+
+
+bool Fort020::Checkpoint(quint64 *offset)
+{
+	return writer.Checkpoint(offset);
+}
+
+
 void Fort020::FinishedWriting()
 {
-	if (file.is_open())
-		file.close();
+	writer.FinishedWriting();
+}
+
+
+bool Fort020::CommitFile()
+{
+	return writer.CommitFile();
 }
 
 
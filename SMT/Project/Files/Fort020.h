@@ -3,11 +3,17 @@
 
 #include <QObject>
 
-#include <fstream>
-#include <ostream>
+#include <vector>
+#include <string>
 
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/BoundaryFileWriter.h"
 
+/**
+ * @brief Writes the fort.020 boundary condition file of a subdomain
+ *
+ * The records are written through a BoundaryFileWriter.
+ */
 class Fort020 : public QObject
 {
 		Q_OBJECT
@@ -15,15 +21,20 @@ class Fort020 : public QObject
 		explicit Fort020(QObject *parent=0);
 		Fort020(QString domainName, ProjectFile *projectFile, QObject *parent=0);
 
-		bool	StartWriting();
+		bool	StartWriting(bool binary = false);
+		bool	ResumeWriting(quint64 offset);
 		void	WriteHeader(int numTS, std::vector<unsigned int> nodeList);
-		void	WriteTimestep(std::vector<std::string> tsData);
+		void	WriteBinaryHeader(const BoundaryBinaryHeader &header);
+		void	WriteTimestep(const std::vector<std::string> &tsData);
+		void	WriteBytes(const char *data, size_t length);
+		bool	Checkpoint(quint64 *offset);
 		void	FinishedWriting();
+		bool	CommitFile();
 
 	private:
 
 		QString			domainName;
-		std::ofstream		file;
+		BoundaryFileWriter	writer;
 		ProjectFile*	projectFile;
 
 		QString	GetFilePath();
@@ -1,9 +1,13 @@
 #include "Fort021.h"
 
+
+static const char Title[] = "Boundary conditions for subdomain\n";
+
+
 Fort021::Fort021(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	file(),
+	writer(),
 	projectFile(0)
 {
 }
@@ -12,57 +16,77 @@ Fort021::Fort021(QObject *parent) :
 Fort021::Fort021(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	file(),
+	writer(),
 	projectFile(projectFile)
 {
+
 }
 
 
-bool Fort021::StartWriting()
+/**
+ * @brief Starts a new file
+ * @param binary true to write the binary layout, which starts with
+ * WriteBinaryHeader() instead of a title and WriteHeader()
+ */
+bool Fort021::StartWriting(bool binary)
 {
-	QString targetFile = GetFilePath();
-	if (!targetFile.isEmpty())
-	{
-		file.open(targetFile.toStdString().data());
-		if (file.is_open())
-		{
-			file << "Boundary conditions for subdomain\n";
-			return true;
-		}
-	}
-	return false;
+	if (!writer.StartWriting(GetFilePath()))
+		return false;
+
+	if (!binary)
+		writer.WriteBytes(Title, sizeof(Title) - 1);
+	return true;
+}
+
+
+bool Fort021::ResumeWriting(quint64 offset)
+{
+	return writer.ResumeWriting(GetFilePath(), offset);
 }
 
 
 void Fort021::WriteHeader(int numTS, std::vector<unsigned int> nodeList)
 {
-	if (file.is_open())
-	{
-		file << "1\t" << nodeList.size() << "\t" << numTS << "\n";
-		for (std::vector<unsigned int>::iterator it = nodeList.begin(); it != nodeList.end(); ++it)
-		{
-			file << *it << "\n";
-		}
-	}
+	writer.WriteHeader(numTS, nodeList);
 }
 
 
-void Fort021::WriteTimestep(std::vector<std::string> tsData)
+void Fort021::WriteBinaryHeader(const BoundaryBinaryHeader &header)
 {
-	if (file.is_open())
+	writer.WriteBinaryHeader(header);
+}
+
+
+void Fort021::WriteTimestep(const std::vector<std::string> &tsData)
+{
+	for (std::vector<std::string>::const_iterator it = tsData.begin(); it != tsData.end(); ++it)
 	{
-		for (std::vector<std::string>::iterator it = tsData.begin(); it != tsData.end(); ++it)
-		{
-			file << *it;
-		}
+		writer.WriteBytes(it->data(), it->size());
 	}
 }
 
 
+void Fort021::WriteBytes(const char *data, size_t length)
+{
+	writer.WriteBytes(data, length);
+}
+
+
+bool Fort021::Checkpoint(quint64 *offset)
+{
+	return writer.Checkpoint(offset);
+}
+
+
 void Fort021::FinishedWriting()
 {
-	if (file.is_open())
-		file.close();
+	writer.FinishedWriting();
+}
+
+
+bool Fort021::CommitFile()
+{
+	return writer.CommitFile();
 }
 
 
@@ -0,0 +1,128 @@
+#include "Fort065.h"
+
+Fort065::Fort065(QObject *parent) :
+	QObject(parent),
+	currentData(),
+	currTS(0),
+	reader(1, false),
+	numNodes(0),
+	numTS(0),
+	projectFile(0)
+{
+}
+
+
+Fort065::Fort065(ProjectFile *projectFile, QObject *parent) :
+	QObject(parent),
+	currentData(),
+	currTS(0),
+	reader(1, false),
+	numNodes(0),
+	numTS(0),
+	projectFile(projectFile)
+{
+	if (projectFile)
+	{
+		QString targetFile = projectFile->GetFullDomainFort065();
+		if (!targetFile.isEmpty())
+		{
+			SearchForFile();
+		}
+	}
+}
+
+
+bool Fort065::StartReading()
+{
+	if (projectFile)
+	{
+		QString targetFile = projectFile->GetFullDomainFort065();
+		if (reader.Open(targetFile, &numNodes, &numTS))
+			return true;
+		reader.Close();
+	}
+	return false;
+}
+
+
+bool Fort065::HasNextTimestep()
+{
+	return currTS < numTS;
+}
+
+
+/**
+ * @brief Reads the next timestep
+ *
+ * The records point into a buffer that is reused for every timestep, so the
+ * returned timestep is only valid until this function is called again. If the
+ * file ends early, the timestep has no records and reading stops.
+ */
+const BoundaryTimestep& Fort065::GetNextTimestep()
+{
+	if (reader.ReadTimestep(numNodes, &currentData))
+		++currTS;
+	else
+		currTS = numTS;
+	return currentData;
+}
+
+
+/**
+ * @brief Moves to a timestep so that it is returned by the next call to
+ * GetNextTimestep()
+ *
+ * The first seek scans the file for the offset of every timestep and saves
+ * them to fort.065.index, so later seeks into the same file are immediate.
+ *
+ * @param timestep The timestep, counting from 0
+ * @return false if the file has no such timestep
+ */
+bool Fort065::SeekTimestep(int timestep)
+{
+	if (timestep < 0 || timestep >= numTS || !reader.SeekTimestep(timestep))
+		return false;
+	currTS = timestep;
+	return true;
+}
+
+
+int Fort065::GetNumTimesteps()
+{
+	return numTS;
+}
+
+
+/**
+ * @brief Returns the header of the file if it is in the binary layout, or 0
+ */
+const BoundaryBinaryHeader* Fort065::GetBinaryHeader()
+{
+	return reader.GetBinaryHeader();
+}
+
+
+void Fort065::FinishedReading()
+{
+	reader.Close();
+	currentData.records.clear();
+	currTS = 0;
+	numNodes = 0;
+	numTS = 0;
+}
+
+
+void Fort065::SearchForFile()
+{
+	if (projectFile)
+	{
+		QDir targetDirectory (projectFile->GetFullDomainDirectory());
+		if (targetDirectory.exists())
+		{
+			if (targetDirectory.exists("fort.065"))
+			{
+				projectFile->SetFullDomainFort065(targetDirectory.absoluteFilePath("fort.065"));
+			}
+		}
+	}
+}
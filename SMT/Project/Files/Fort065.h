@@ -0,0 +1,38 @@
+#ifndef FORT065_NEW_H
+#define FORT065_NEW_H
+
+#include <QObject>
+
+#include "adcData.h"
+#include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/BoundaryRecordReader.h"
+
+class Fort065 : public QObject
+{
+		Q_OBJECT
+	public:
+		explicit Fort065(QObject *parent=0);
+		Fort065(ProjectFile *projectFile, QObject *parent=0);
+
+		bool					StartReading();
+		bool					HasNextTimestep();
+		const BoundaryTimestep&			GetNextTimestep();
+		bool					SeekTimestep(int timestep);
+		int					GetNumTimesteps();
+		const BoundaryBinaryHeader*		GetBinaryHeader();
+		void					FinishedReading();
+
+	private:
+
+		BoundaryTimestep			currentData;	/**< Points into the reader's buffer */
+		int					currTS;
+		BoundaryRecordReader			reader;
+		int					numNodes;
+		int					numTS;
+		ProjectFile*			projectFile;
+
+
+		void	SearchForFile();
+};
+
+#endif // FORT065_NEW_H
@@ -4,7 +4,7 @@ Fort066::Fort066(QObject *parent) :
 	QObject(parent),
 	currentData(),
 	currTS(0),
-	file(),
+	reader(2, true),
 	numNodes(0),
 	numTS(0),
 	projectFile(0)
@@ -16,7 +16,7 @@ Fort066::Fort066(ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	currentData(),
 	currTS(0),
-	file(),
+	reader(2, true),
 	numNodes(0),
 	numTS(0),
 	projectFile(projectFile)
@@ -37,22 +37,9 @@ bool Fort066::StartReading()
 	if (projectFile)
 	{
 		QString targetFile = projectFile->GetFullDomainFort066();
-		file.open(targetFile.toStdString().data());
-		if (file.is_open())
-		{
-			int NSPOOLGS;
-			std::string line;
-			std::getline(file, line);
-			std::getline(file, line);
-			std::stringstream(line) >> NSPOOLGS >> numNodes >> numTS;
-			if (numNodes && numTS)
-			{
-				return true;
-			} else {
-				file.close();
-				return false;
-			}
-		}
+		if (reader.Open(targetFile, &numNodes, &numTS))
+			return true;
+		reader.Close();
 	}
 	return false;
 }
@@ -64,39 +51,61 @@ bool Fort066::HasNextTimestep()
 }
 
 
-std::map<unsigned int, std::string> Fort066::GetNextTimestep()
+/**
+ * @brief Reads the next timestep
+ *
+ * The records point into a buffer that is reused for every timestep, so the
+ * returned timestep is only valid until this function is called again. If the
+ * file ends early, the timestep has no records and reading stops.
+ */
+const BoundaryTimestep& Fort066::GetNextTimestep()
 {
-	currentData.clear();
-	if (file.is_open())
-	{
-		std::string tsLine, line1, line2;
-		unsigned int currNode;
-		std::getline(file, tsLine);
-		currentData[0] = tsLine;
-		for (int i=0; i<numNodes; ++i)
-		{
-			std::getline(file, line1);
-			std::getline(file, line2);
-			std::stringstream(line1) >> currNode;
-			currentData[currNode] = line1 + "\n" + line2 + "\n";
-		}
-	}
-	++currTS;
+	if (reader.ReadTimestep(numNodes, &currentData))
+		++currTS;
+	else
+		currTS = numTS;
 	return currentData;
 }
 
 
+/**
+ * @brief Moves to a timestep so that it is returned by the next call to
+ * GetNextTimestep()
+ *
+ * The first seek scans the file for the offset of every timestep and saves
+ * them to fort.066.index, so later seeks into the same file are immediate.
+ *
+ * @param timestep The timestep, counting from 0
+ * @return false if the file has no such timestep
+ */
+bool Fort066::SeekTimestep(int timestep)
+{
+	if (timestep < 0 || timestep >= numTS || !reader.SeekTimestep(timestep))
+		return false;
+	currTS = timestep;
+	return true;
+}
+
+
 int Fort066::GetNumTimesteps()
 {
 	return numTS;
 }
 
 
+/**
+ * @brief Returns the header of the file if it is in the binary layout, or 0
+ */
+const BoundaryBinaryHeader* Fort066::GetBinaryHeader()
+{
+	return reader.GetBinaryHeader();
+}
+
+
 void Fort066::FinishedReading()
 {
-	if (file.is_open())
-		file.close();
-	currentData.clear();
+	reader.Close();
+	currentData.records.clear();
 	currTS = 0;
 	numNodes = 0;
 	numTS = 0;
@@ -1,14 +1,11 @@
 #ifndef FORT066_NEW_H
 #define FORT066_NEW_H
 
-#include <map>
-#include <fstream>
-#include <istream>
-#include <sstream>
-
 #include <QObject>
 
+#include "adcData.h"
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/BoundaryRecordReader.h"
 
 class Fort066 : public QObject
 {
@@ -19,15 +16,17 @@ class Fort066 : public QObject
 
 		bool					StartReading();
 		bool					HasNextTimestep();
-		std::map<unsigned int, std::string>	GetNextTimestep();
+		const BoundaryTimestep&			GetNextTimestep();
+		bool					SeekTimestep(int timestep);
 		int					GetNumTimesteps();
+		const BoundaryBinaryHeader*		GetBinaryHeader();
 		void					FinishedReading();
 
 	private:
 
-		std::map<unsigned int, std::string>	currentData;
+		BoundaryTimestep			currentData;	/**< Points into the reader's buffer */
 		int					currTS;
-		std::ifstream				file;
+		BoundaryRecordReader			reader;
 		int					numNodes;
 		int					numTS;
 		ProjectFile*			projectFile;
@@ -4,7 +4,7 @@ Fort067::Fort067(QObject *parent) :
 	QObject(parent),
 	currentData(),
 	currTS(0),
-	file(),
+	reader(1, false),
 	numNodes(0),
 	numTS(0),
 	projectFile(0)
@@ -16,7 +16,7 @@ Fort067::Fort067(ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	currentData(),
 	currTS(0),
-	file(),
+	reader(1, false),
 	numNodes(0),
 	numTS(0),
 	projectFile(projectFile)
@@ -37,22 +37,9 @@ bool Fort067::StartReading()
 	if (projectFile)
 	{
 		QString targetFile = projectFile->GetFullDomainFort067();
-		file.open(targetFile.toStdString().data());
-		if (file.is_open())
-		{
-			int NSPOOLGS;
-			std::string line;
-			std::getline(file, line);
-			std::getline(file, line);
-			std::stringstream(line) >> NSPOOLGS >> numNodes >> numTS;
-			if (numNodes && numTS)
-			{
-				return true;
-			} else {
-				file.close();
-				return false;
-			}
-		}
+		if (reader.Open(targetFile, &numNodes, &numTS))
+			return true;
+		reader.Close();
 	}
 	return false;
 }
@@ -64,38 +51,61 @@ bool Fort067::HasNextTimestep()
 }
 
 
-std::map<unsigned int, std::string> Fort067::GetNextTimestep()
+/**
+ * @brief Reads the next timestep
+ *
+ * The records point into a buffer that is reused for every timestep, so the
+ * returned timestep is only valid until this function is called again. If the
+ * file ends early, the timestep has no records and reading stops.
+ */
+const BoundaryTimestep& Fort067::GetNextTimestep()
 {
-	currentData.clear();
-	if (file.is_open())
-	{
-		std::string tsLine, line;
-		unsigned int currNode;
-		std::getline(file, tsLine);
-		currentData[0] = tsLine;
-		for (int i=0; i<numNodes; ++i)
-		{
-			file >> currNode;
-			std::getline(file, line);
-			currentData[currNode] = "\t" + line + "\n";
-		}
-	}
-	++currTS;
+	if (reader.ReadTimestep(numNodes, &currentData))
+		++currTS;
+	else
+		currTS = numTS;
 	return currentData;
 }
 
 
+/**
+ * @brief Moves to a timestep so that it is returned by the next call to
+ * GetNextTimestep()
+ *
+ * The first seek scans the file for the offset of every timestep and saves
+ * them to fort.067.index, so later seeks into the same file are immediate.
+ *
+ * @param timestep The timestep, counting from 0
+ * @return false if the file has no such timestep
+ */
+bool Fort067::SeekTimestep(int timestep)
+{
+	if (timestep < 0 || timestep >= numTS || !reader.SeekTimestep(timestep))
+		return false;
+	currTS = timestep;
+	return true;
+}
+
+
 int Fort067::GetNumTimesteps()
 {
 	return numTS;
 }
 
 
+/**
+ * @brief Returns the header of the file if it is in the binary layout, or 0
+ */
+const BoundaryBinaryHeader* Fort067::GetBinaryHeader()
+{
+	return reader.GetBinaryHeader();
+}
+
+
 void Fort067::FinishedReading()
 {
-	if (file.is_open())
-		file.close();
-	currentData.clear();
+	reader.Close();
+	currentData.records.clear();
 	currTS = 0;
 	numNodes = 0;
 	numTS = 0;
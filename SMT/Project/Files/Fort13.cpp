@@ -75,6 +75,12 @@ Fort13::Fort13(QString domainName, ProjectFile *projectFile, QObject *parent) :
 }
 
 
+QString Fort13::GetFilePath()
+{
+	return targetFile;
+}
+
+
 QString Fort13::GetHeaderLine()
 {
 	if (headerLine.isEmpty())
@@ -107,6 +113,66 @@ std::vector<NodalAttribute> Fort13::GetNodalAttributes()
 }
 
 
+/**
+ * @brief Expands one nodal attribute into a value for every node
+ *
+ * Nodes that aren't listed in the non-default section get the attribute's
+ * default value.
+ *
+ * @param attributeName The name of the attribute (e.g. mannings_n_at_sea_floor)
+ * @param column Which value to use for attributes with more than one value per node
+ * @param values Filled with one value per node, indexed by node number - 1
+ * @return true if the attribute was found
+ */
+bool Fort13::GetAttributeValues(QString attributeName, unsigned int column, std::vector<float> *values)
+{
+	if (!values)
+		return false;
+
+	if (attributes.empty())
+		ReadFile();
+
+	for (std::vector<NodalAttribute>::iterator currAttribute = attributes.begin();
+	     currAttribute != attributes.end();
+	     ++currAttribute)
+	{
+		if ((*currAttribute).attributeName.trimmed() != attributeName.trimmed())
+			continue;
+
+		QStringList defaults = (*currAttribute).defaultValues.trimmed().split(QRegExp("\\s+"), QString::SkipEmptyParts);
+		if ((int)column >= defaults.size())
+			return false;
+		values->assign(numNodes, defaults.at(column).toFloat());
+
+		for (std::vector<QString>::iterator currNodeLine = (*currAttribute).nonDefaultLines.begin();
+		     currNodeLine != (*currAttribute).nonDefaultLines.end();
+		     ++currNodeLine)
+		{
+			QByteArray line = (*currNodeLine).toLatin1();
+			char *end = 0;
+			unsigned long nodeNumber = strtoul(line.constData(), &end, 10);
+			if (nodeNumber == 0 || nodeNumber > numNodes)
+				continue;
+
+			const char *valueStart = end;
+			double value = 0.0;
+			for (unsigned int i=0; i<=column && end; ++i)
+			{
+				value = strtod(valueStart, &end);
+				if (end == valueStart)
+					end = 0;
+				valueStart = end;
+			}
+			if (end)
+				(*values)[nodeNumber-1] = value;
+		}
+		return true;
+	}
+
+	return false;
+}
+
+
 void Fort13::SaveFile()
 {
 	if (!isFullDomain)
@@ -169,11 +235,9 @@ void Fort13::SetNodalAttributes(std::vector<NodalAttribute> newAttributes, Py140
 
 					// If the node number has a subdomain counterpart, it needs to be added
 					// to the subdomain fort.13 file
-					if (py140->HasOldNode(nodeNumber))
+					unsigned int subdomainNodeNumber = py140->ConvertOldToNew(nodeNumber);
+					if (subdomainNodeNumber != Py140::NoNode)
 					{
-						// Convert to the subdomain node number
-						unsigned int subdomainNodeNumber = py140->ConvertOldToNew(nodeNumber);
-
 						// Build the text line for the subdomain fort.13
 						QString newLine = QString::number(subdomainNodeNumber);
 						for (int i=1; i<splitString.size(); ++i)
@@ -8,6 +8,7 @@
 #include <istream>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
 
 #include "Project/Files/ProjectFile.h"
 #include "Project/Files/Py140.h"
@@ -38,10 +39,12 @@ class Fort13 : public QObject
 		Fort13(ProjectFile *projectFile, QObject *parent=0);
 		Fort13(QString domainName, ProjectFile *projectFile, QObject *parent=0);
 
+		QString				GetFilePath();
 		QString				GetHeaderLine();
 		unsigned int			GetNumNodes();
 		unsigned int			GetNumAttributes();
 		std::vector<NodalAttribute>	GetNodalAttributes();
+		bool				GetAttributeValues(QString attributeName, unsigned int column, std::vector<float> *values);
 
 		void	SaveFile();
 		void	SetHeaderLine(QString newLine);
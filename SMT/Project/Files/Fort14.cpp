@@ -6,6 +6,7 @@
  */
 Fort14::Fort14(QObject *parent) :
 	QObject(parent),
+	adjacency(0),
 	domainName(),
 	elements(),
 	elevationBoundaries(),
@@ -35,6 +36,11 @@ Fort14::Fort14(QObject *parent) :
 	solidOutline(0), solidFill(0), solidBoundary(0),
 	gradientOutline(0), gradientFill(0), gradientBoundary(0),
     VAOId(0), VBOId(0), IBOId(0),
+    scalarBufferIds(NumScalarFields, 0),
+    scalarResident(NumScalarFields, false),
+    displayedField(BathymetryField),
+    maxeleIsDifference(false),
+    maxeleLoaded(false),
     GLmode("default")
 {
 
@@ -48,6 +54,7 @@ Fort14::Fort14(QObject *parent) :
  */
 Fort14::Fort14(ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
+	adjacency(0),
 	domainName(),
 	elements(),
 	elevationBoundaries(),
@@ -76,6 +83,11 @@ Fort14::Fort14(ProjectFile *projectFile, QObject *parent) :
 	solidOutline(0), solidFill(0), solidBoundary(0),
 	gradientOutline(0), gradientFill(0), gradientBoundary(0),
     VAOId(0), VBOId(0), IBOId(0),
+    scalarBufferIds(NumScalarFields, 0),
+    scalarResident(NumScalarFields, false),
+    displayedField(BathymetryField),
+    maxeleIsDifference(false),
+    maxeleLoaded(false),
     GLmode("default")
 
 {
@@ -90,6 +102,7 @@ Fort14::Fort14(ProjectFile *projectFile, QObject *parent) :
  */
 Fort14::Fort14(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
+	adjacency(0),
 	domainName(domainName),
 	elements(),
 	elevationBoundaries(),
@@ -118,6 +131,11 @@ Fort14::Fort14(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	solidOutline(0), solidFill(0), solidBoundary(0),
 	gradientOutline(0), gradientFill(0), gradientBoundary(0),
     VAOId(0), VBOId(0), IBOId(0),
+    scalarBufferIds(NumScalarFields, 0),
+    scalarResident(NumScalarFields, false),
+    displayedField(BathymetryField),
+    maxeleIsDifference(false),
+    maxeleLoaded(false),
     GLmode("default")
 {
 	ReadFile();
@@ -128,6 +146,8 @@ Fort14::~Fort14()
 {
 	if (quadtree)
 		delete quadtree;
+	if (adjacency)
+		delete adjacency;
 
 	if (solidOutline)
 		delete solidOutline;
@@ -150,6 +170,8 @@ Fort14::~Fort14()
 		glDeleteBuffers(1, &VAOId);
 	if (IBOId)
 		glDeleteBuffers(1, &IBOId);
+	if (scalarBufferIds[0])
+		glDeleteBuffers(NumScalarFields, &scalarBufferIds[0]);
 }
 
 
@@ -259,6 +281,37 @@ std::vector<Element>* Fort14::GetElements()
 }
 
 
+/**
+ * @brief Returns the element/node adjacency tables for the mesh
+ *
+ * The tables are built the first time they are requested. Returns 0 if the
+ * file is still being read.
+ *
+ * @return The MeshAdjacency object for this fort.14 file
+ */
+MeshAdjacency* Fort14::GetMeshAdjacency()
+{
+	if (!adjacency && !readingLock && elements.size())
+		adjacency = new MeshAdjacency(&elements, nodes.size());
+	return adjacency;
+}
+
+
+/**
+ * @brief Returns the copy of the elements that the Quadtree searches point into
+ *
+ * Selection tools that don't use a spatial search need to hand out pointers to
+ * these elements so that their results can be merged with the other tools'.
+ * Returns 0 if the Quadtree hasn't been built yet.
+ */
+std::vector<Element>* Fort14::GetQuadtreeElements()
+{
+	if (quadtree)
+		return quadtree->GetElements();
+	return 0;
+}
+
+
 QString Fort14::GetFilePath()
 {
 	if (projectFile)
@@ -451,6 +504,10 @@ QColor Fort14::GetSolidOutlineColor()
 }
 
 
+/**
+ * @brief Sends the positions and depths of the nodes to the GPU again, after
+ * they have been edited, and colors the mesh by depth
+ */
 void Fort14::RefreshGL()
 {
 	if (glLoaded)
@@ -473,7 +530,9 @@ void Fort14::RefreshGL()
 				return;
 			}
 		}
-            resetGradientFill(minZ, maxZ); //aa15
+		UploadBathymetry();
+		displayedField = NumScalarFields;
+		ShowBathymetryGL();
 	}
 
 
@@ -500,6 +559,7 @@ void Fort14::SetGradientBoundaryColors(QGradientStops newStops)
 		gradientBoundary = new GradientShader();
 		gradientBoundary->SetCamera(camera);
 		gradientBoundary->SetGradientRange(minZ, maxZ);
+		gradientBoundary->SetValueAttribute(true);
 	}
 
 	gradientBoundary->SetGradientStops(newStops);
@@ -515,6 +575,7 @@ void Fort14::SetGradientFillColors(QGradientStops newStops)
 		gradientFill = new GradientShader();
 		gradientFill->SetCamera(camera);
 		gradientFill->SetGradientRange(minZ, maxZ);
+		gradientFill->SetValueAttribute(true);
 	}
 
 	gradientFill->SetGradientStops(newStops);
@@ -530,6 +591,7 @@ void Fort14::SetGradientOutlineColors(QGradientStops newStops)
 		gradientOutline = new GradientShader();
 		gradientOutline->SetCamera(camera);
 		gradientOutline->SetGradientRange(minZ, maxZ);
+		gradientOutline->SetValueAttribute(true);
 	}
 
 	gradientOutline->SetGradientStops(newStops);
@@ -695,6 +757,20 @@ void Fort14::LoadGL()
 			return;
 		}
 
+		// Make room for the values the mesh can be colored by, and start with the depths
+		glGenBuffers(NumScalarFields, &scalarBufferIds[0]);
+		for (unsigned int i=0; i<NumScalarFields; ++i)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, scalarBufferIds[i]);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat)*numNodes, NULL, GL_DYNAMIC_DRAW);
+			scalarResident[i] = false;
+		}
+		UploadBathymetry();
+		glBindBuffer(GL_ARRAY_BUFFER, scalarBufferIds[BathymetryField]);
+		glEnableVertexAttribArray(GradientShader::ValueLocation);
+		glVertexAttribPointer(GradientShader::ValueLocation, 1, GL_FLOAT, GL_FALSE, 0, 0);
+		displayedField = BathymetryField;
+
 		// Send Index Data
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
 		const size_t IndexBufferSize = 3*sizeof(GLuint)*numElements; // + sizeof(GLuint)*boundaryNodes.size();
@@ -789,6 +865,8 @@ void Fort14::ReadFile()
 			connect(worker, SIGNAL(FinishedReading()), worker, SLOT(deleteLater()));
 			connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
 
+			// The nodes are replaced, so any maxele values are gone
+			maxeleLoaded = false;
 			LockFile();
 			thread->start();
 		}
@@ -891,17 +969,41 @@ bool Fort14::setMaxele(Maxele63 * maxele63){
         return false;
     }
 
+    // The maxele values already on the GPU can be kept if they haven't changed
+    bool changed = maxeleIsDifference;
     for (unsigned int i=0; i<numNodes; i++){
-        nodes[i].maxele = maxele63->GetMaxele(i);
+        float maxele = maxele63->GetMaxele(i);
+        changed = changed || nodes[i].maxele != maxele;
+        nodes[i].maxele = maxele;
     }
 
+    if (changed)
+        scalarResident[MaxeleField] = false;
+    scalarResident[DifferenceField] = false;
+    maxeleIsDifference = false;
+    maxeleLoaded = true;
     return true;
 }
 
-void Fort14::setMaxeleDif(float fullMaxele, unsigned int i){
-    nodes[i].maxele = fullMaxele - nodes[i].maxele;
-    minDif = std::min(minDif,nodes[i].maxele);
-    maxDif = std::max(maxDif,nodes[i].maxele);
+
+/**
+ * @brief Whether the nodes hold the values of a maxele.63, rather than
+ * nothing or the differences set by setMaxeleDif()
+ */
+bool Fort14::HasMaxele()
+{
+    return maxeleLoaded && !maxeleIsDifference;
+}
+
+void Fort14::setMaxeleDif(const std::vector<float> &differences, float minDifference, float maxDifference){
+    unsigned int numDifferences = std::min(nodes.size(), differences.size());
+    for (unsigned int i=0; i<numDifferences; i++){
+        nodes[i].maxele = differences[i];
+    }
+    minDif = minDifference;
+    maxDif = maxDifference;
+    maxeleIsDifference = true;
+    scalarResident[DifferenceField] = false;
 }
 
 
@@ -909,36 +1011,17 @@ void Fort14::setMaxeleDif(float fullMaxele, unsigned int i){
 
 void Fort14::maxeleGL(float minMaxele, float maxMaxele){
 
-
     if (glLoaded)
     {
-        const size_t VertexBufferSize = 4*sizeof(GLfloat)*numNodes;
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBOId);
-        GLfloat* glNodeData = (GLfloat *)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-        if (glNodeData)
+        ScalarField field = maxeleIsDifference ? DifferenceField : MaxeleField;
+        if (!scalarResident[field])
         {
+            std::vector<GLfloat> values (numNodes);
             for (unsigned int i=0; i<numNodes; i++)
-            {
-                glNodeData[4*i+0] = (GLfloat)nodes[i].normX;
-                glNodeData[4*i+1] = (GLfloat)nodes[i].normY;
-                glNodeData[4*i+2] = (GLfloat)nodes[i].maxele;
-            }
-
-            if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
-            {
-                glLoaded = false;
-                DEBUG("ERROR: Unmapping vertex buffer for fort.14");
-                return;
-            }
+                values[i] = (GLfloat)nodes[i].maxele;
+            UploadScalarField(field, &values[0]);
         }
-
-        glBindVertexArray(VAOId);
-
-        resetGradientFill(minMaxele,maxMaxele);
-
-        emit Refresh();
-
+        ShowScalarFieldGL(field, minMaxele, maxMaxele);
     }
 
 }
@@ -978,3 +1061,89 @@ void Fort14::resetGradientFill(float minVal, float maxVal){
     gradientFill->SetGradientStops(defaultStops);
 
 }
+
+
+/**
+ * @brief Colors the mesh by a value at every node, such as one frame of a time series
+ *
+ * Only the values are sent to the GPU. Values below the bottom of the range,
+ * like those of dry nodes, are shown in the color of the bottom of the range.
+ *
+ * @param values One value for every node, in node number order
+ */
+void Fort14::SetDisplayValuesGL(const std::vector<float> &values, float minVal, float maxVal){
+
+    if (glLoaded && values.size() >= numNodes)
+    {
+        UploadScalarField(TimeSeriesField, &values[0]);
+        ShowScalarFieldGL(TimeSeriesField, minVal, maxVal);
+    }
+
+}
+
+
+/**
+ * @brief Colors the mesh by a field that is already on the GPU
+ *
+ * Only the buffer the shader reads the values from is changed, and the
+ * gradient is only rebuilt if the field or the range changes.
+ *
+ * @return false if the field hasn't been sent to the GPU
+ */
+bool Fort14::ShowScalarFieldGL(ScalarField field, float minVal, float maxVal){
+
+    if (!glLoaded || field >= NumScalarFields || !scalarResident[field])
+        return false;
+
+    if (field != displayedField)
+    {
+        glBindVertexArray(VAOId);
+        glBindBuffer(GL_ARRAY_BUFFER, scalarBufferIds[field]);
+        glVertexAttribPointer(GradientShader::ValueLocation, 1, GL_FLOAT, GL_FALSE, 0, 0);
+        glBindVertexArray(0);
+    }
+
+    if (field != displayedField || minVal != minDisplayVal || maxVal != maxDisplayVal)
+        resetGradientFill(minVal, maxVal);
+    displayedField = field;
+
+    emit Refresh();
+    return true;
+
+}
+
+
+/**
+ * @brief Colors the mesh by depth again, without sending anything to the GPU
+ */
+void Fort14::ShowBathymetryGL(){
+
+    ShowScalarFieldGL(BathymetryField, minZ, maxZ);
+
+}
+
+
+/**
+ * @brief Replaces the values of a field on the GPU
+ * @param values One value for every node, in node number order
+ */
+void Fort14::UploadScalarField(ScalarField field, const GLfloat *values){
+
+    glBindBuffer(GL_ARRAY_BUFFER, scalarBufferIds[field]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat)*numNodes, values);
+    scalarResident[field] = true;
+
+}
+
+
+void Fort14::UploadBathymetry(){
+
+    if (numNodes == 0)
+        return;
+
+    std::vector<GLfloat> depths (numNodes);
+    for (unsigned int i=0; i<numNodes; i++)
+        depths[i] = (GLfloat)nodes[i].z;
+    UploadScalarField(BathymetryField, &depths[0]);
+
+}
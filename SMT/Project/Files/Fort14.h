@@ -14,6 +14,7 @@
 #include "OpenGL/Shaders/SolidShader.h"
 
 #include "Quadtree/Quadtree.h"
+#include "SubdomainTools/MeshAdjacency.h"
 #include "Maxele63.h"
 
 
@@ -21,6 +22,9 @@ class Fort14 : public QObject
 {
 		Q_OBJECT
 	public:
+		/** @brief The values the mesh can be colored by, each kept in its own buffer on the GPU */
+		enum ScalarField {BathymetryField, MaxeleField, DifferenceField, TimeSeriesField, NumScalarFields};
+
 		explicit Fort14(QObject *parent=0);
 		Fort14(ProjectFile *projectFile, QObject *parent=0);
 		Fort14(QString domainName, ProjectFile *projectFile, QObject *parent=0);
@@ -36,6 +40,8 @@ class Fort14 : public QObject
 
 		ShaderType		GetBoundaryShaderType();
 		std::vector<Element>*	GetElements();
+		MeshAdjacency*		GetMeshAdjacency();
+		std::vector<Element>*	GetQuadtreeElements();
 		QString			GetFilePath();
 		ShaderType		GetFillShaderType();
 		QGradientStops		GetGradientBoundaryColors();
@@ -80,14 +86,19 @@ class Fort14 : public QObject
         float           GetMinDif();
         float           GetMaxDif();
         bool            setMaxele(Maxele63 * maxele63);
-        void            setMaxeleDif(float fullMaxele, unsigned int i);
+        bool            HasMaxele();
+        void            setMaxeleDif(const std::vector<float> &differences, float minDifference, float maxDifference);
         void            maxeleGL(float minMaxele, float maxMaxele);
         void            resetGradientFill(float minVal, float maxVal);
+        void            SetDisplayValuesGL(const std::vector<float> &values, float minVal, float maxVal);
+        bool            ShowScalarFieldGL(ScalarField field, float minVal, float maxVal);
+        void            ShowBathymetryGL();
 
 
 
 	private:
 
+		MeshAdjacency*			adjacency;
         QString				domainName;
 		std::vector<Element>		elements;
 		std::vector<std::vector<unsigned int> >	elevationBoundaries;
@@ -129,10 +140,17 @@ class Fort14 : public QObject
 		GLuint		VAOId;
 		GLuint		VBOId;
 		GLuint		IBOId;
+		std::vector<GLuint>	scalarBufferIds;	/**< One buffer of node values for each ScalarField */
+		std::vector<bool>	scalarResident;	/**< Whether each scalar buffer holds the current values */
+		ScalarField		displayedField;
+		bool			maxeleIsDifference;	/**< Whether the maxele values have been replaced by differences */
+		bool			maxeleLoaded;	/**< Whether a maxele.63 has been loaded into the nodes */
         QString     GLmode;
 
 		void	CreateDefaultShaders();
 		void	LoadGL();
+		void	UploadScalarField(ScalarField field, const GLfloat *values);
+		void	UploadBathymetry();
 		void	PopulateQuadtree();
 		void	ReadFile();
 		void	UnlockFile();
@@ -3,7 +3,8 @@
 Fort63::Fort63(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(0)
+	projectFile(0),
+	reader(1)
 {
 }
 
@@ -11,7 +12,8 @@ Fort63::Fort63(QObject *parent) :
 Fort63::Fort63(ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	reader(1)
 {
 }
 
@@ -19,6 +21,82 @@ Fort63::Fort63(ProjectFile *projectFile, QObject *parent) :
 Fort63::Fort63(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	reader(1)
 {
 }
+
+
+/**
+ * @brief Opens the file and indexes its timesteps
+ * @param filePath The file to read. If empty, the domain's fort.63 is used.
+ */
+bool Fort63::StartReading(QString filePath)
+{
+	if (filePath.isEmpty())
+		filePath = GetFilePath();
+	if (filePath.isEmpty())
+		return false;
+	return reader.Open(filePath);
+}
+
+
+void Fort63::FinishedReading()
+{
+	reader.Close();
+}
+
+
+unsigned int Fort63::GetNumNodes()
+{
+	return reader.GetNumNodes();
+}
+
+
+unsigned int Fort63::GetNumTimesteps()
+{
+	return reader.GetNumTimesteps();
+}
+
+
+/**
+ * @brief Reads the water level of every node at a timestep
+ * @param timestep The timestep, counting from 0
+ * @param values Filled with the water level of every node, in node number
+ * order. Dry nodes are TimeSeriesReader::DryValue.
+ * @param time Set to the model time of the timestep
+ */
+bool Fort63::ReadTimestep(unsigned int timestep, std::vector<float> &values, double *time)
+{
+	values.resize(reader.GetNumNodes());
+	if (values.empty())
+		return false;
+	return reader.ReadTimestep(timestep, &values[0], time);
+}
+
+
+/**
+ * @brief Returns the reader of the open file, which can be shared with a
+ * background thread while the file stays open
+ */
+TimeSeriesReader* Fort63::GetReader()
+{
+	return &reader;
+}
+
+
+QString Fort63::GetFilePath()
+{
+	if (projectFile)
+	{
+		QString targetFile = domainName.isEmpty() ? projectFile->GetFullDomainFort63() : projectFile->GetSubDomainFort63(domainName);
+		if (targetFile.isEmpty())
+		{
+			QDir targetDirectory (domainName.isEmpty() ? projectFile->GetFullDomainDirectory() : projectFile->GetSubDomainDirectory(domainName));
+			if (targetDirectory.exists("fort.63"))
+				targetFile = targetDirectory.absoluteFilePath("fort.63");
+		}
+		return targetFile;
+	}
+	return QString();
+}
@@ -2,9 +2,16 @@
 #define FORT63_H
 
 #include <QObject>
+#include <QDir>
+
+#include <vector>
 
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/TimeSeriesReader.h"
 
+/**
+ * @brief Reads the timesteps of a fort.63 water level file by timestep number
+ */
 class Fort63 : public QObject
 {
 		Q_OBJECT
@@ -13,10 +20,20 @@ class Fort63 : public QObject
 		Fort63(ProjectFile *projectFile, QObject *parent=0);
 		Fort63(QString domainName, ProjectFile *projectFile, QObject *parent=0);
 
+		bool			StartReading(QString filePath = QString());
+		void			FinishedReading();
+		unsigned int		GetNumNodes();
+		unsigned int		GetNumTimesteps();
+		bool			ReadTimestep(unsigned int timestep, std::vector<float> &values, double *time);
+		TimeSeriesReader*	GetReader();
+
 	private:
 
 		QString			domainName;
 		ProjectFile*	projectFile;
+		TimeSeriesReader	reader;
+
+		QString	GetFilePath();
 };
 
 #endif // FORT63_H
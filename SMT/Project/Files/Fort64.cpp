@@ -3,7 +3,8 @@
 Fort64::Fort64(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(0)
+	projectFile(0),
+	reader(2)
 {
 }
 
@@ -11,7 +12,8 @@ Fort64::Fort64(QObject *parent) :
 Fort64::Fort64(ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	reader(2)
 {
 }
 
@@ -19,7 +21,94 @@ Fort64::Fort64(ProjectFile *projectFile, QObject *parent) :
 Fort64::Fort64(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	reader(2)
 {
 }
 
+
+/**
+ * @brief Opens the file and indexes its timesteps
+ * @param filePath The file to read. If empty, the domain's fort.64 is used.
+ */
+bool Fort64::StartReading(QString filePath)
+{
+	if (filePath.isEmpty())
+		filePath = GetFilePath();
+	if (filePath.isEmpty())
+		return false;
+	return reader.Open(filePath);
+}
+
+
+void Fort64::FinishedReading()
+{
+	reader.Close();
+}
+
+
+unsigned int Fort64::GetNumNodes()
+{
+	return reader.GetNumNodes();
+}
+
+
+unsigned int Fort64::GetNumTimesteps()
+{
+	return reader.GetNumTimesteps();
+}
+
+
+/**
+ * @brief Reads the velocity of every node at a timestep
+ * @param timestep The timestep, counting from 0
+ * @param values Filled with the u and v velocities of every node, in node
+ * number order
+ * @param time Set to the model time of the timestep
+ */
+bool Fort64::ReadTimestep(unsigned int timestep, std::vector<float> &values, double *time)
+{
+	values.resize(2*reader.GetNumNodes());
+	if (values.empty())
+		return false;
+	return reader.ReadTimestep(timestep, &values[0], time);
+}
+
+
+/**
+ * @brief Reads the speed of every node at a timestep
+ */
+bool Fort64::ReadSpeeds(unsigned int timestep, std::vector<float> &speeds, double *time)
+{
+	speeds.resize(reader.GetNumNodes());
+	if (speeds.empty())
+		return false;
+	return reader.ReadMagnitudes(timestep, &speeds[0], time);
+}
+
+
+/**
+ * @brief Returns the reader of the open file, which can be shared with a
+ * background thread while the file stays open
+ */
+TimeSeriesReader* Fort64::GetReader()
+{
+	return &reader;
+}
+
+
+QString Fort64::GetFilePath()
+{
+	if (projectFile)
+	{
+		QString targetFile = domainName.isEmpty() ? projectFile->GetFullDomainFort64() : projectFile->GetSubDomainFort64(domainName);
+		if (targetFile.isEmpty())
+		{
+			QDir targetDirectory (domainName.isEmpty() ? projectFile->GetFullDomainDirectory() : projectFile->GetSubDomainDirectory(domainName));
+			if (targetDirectory.exists("fort.64"))
+				targetFile = targetDirectory.absoluteFilePath("fort.64");
+		}
+		return targetFile;
+	}
+	return QString();
+}
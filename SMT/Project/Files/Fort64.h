@@ -2,9 +2,16 @@
 #define FORT64_H
 
 #include <QObject>
+#include <QDir>
+
+#include <vector>
 
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/TimeSeriesReader.h"
 
+/**
+ * @brief Reads the timesteps of a fort.64 velocity file by timestep number
+ */
 class Fort64 : public QObject
 {
 		Q_OBJECT
@@ -13,10 +20,21 @@ class Fort64 : public QObject
 		Fort64(ProjectFile *projectFile, QObject *parent=0);
 		Fort64(QString domainName, ProjectFile *projectFile, QObject *parent=0);
 
+		bool			StartReading(QString filePath = QString());
+		void			FinishedReading();
+		unsigned int		GetNumNodes();
+		unsigned int		GetNumTimesteps();
+		bool			ReadTimestep(unsigned int timestep, std::vector<float> &values, double *time);
+		bool			ReadSpeeds(unsigned int timestep, std::vector<float> &speeds, double *time);
+		TimeSeriesReader*	GetReader();
+
 	private:
 
 		QString			domainName;
 		ProjectFile*	projectFile;
+		TimeSeriesReader	reader;
+
+		QString	GetFilePath();
 };
 
 #endif // FORT64_H
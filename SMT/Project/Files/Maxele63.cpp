@@ -4,7 +4,8 @@
 Maxele63::Maxele63(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(0)
+	projectFile(0),
+	stats()
 {
 }
 
@@ -15,7 +16,8 @@ Maxele63::Maxele63(ProjectFile *projectFile, QObject *parent) :
     isFullDomain(true),
     headerLine(),
     numNodes(0),
-    targetFile()
+    targetFile(),
+    stats()
 {
 }
 
@@ -31,7 +33,8 @@ Maxele63::Maxele63(QString targetFile,
     isFullDomain(true),
     headerLine(),
     numNodes(0),
-    targetFile(targetFile)
+    targetFile(targetFile),
+    stats()
 {
 
     ReadFile();
@@ -41,7 +44,8 @@ Maxele63::Maxele63(QString targetFile,
 Maxele63::Maxele63(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	stats()
 {
 }
 
@@ -54,45 +58,22 @@ QString Maxele63::GetHeaderLine()
     return headerLine;
 }
 
+/**
+ * @brief Reads the file, replacing the values of dry nodes with 0, and
+ * gathers the statistics that the getters return
+ */
 void Maxele63::ReadFile()
 {
 
     if (!targetFile.isEmpty()){
 
-        std::ifstream file (targetFile.toStdString().data());
-        if (file.is_open())
+        std::string header;
+        if (GlobalOutputReader::ReadFile(targetFile, 0.0, &header, &maxeles, &stats))
         {
-            std::string currentLine;
-            int dummy;
-
-            // Read the header line
-            std::getline(file, currentLine);
-            headerLine = QString(currentLine.data());
-
-            // read the number of nodes
-            std::getline(file, currentLine);
-            std::stringstream(currentLine) >> dummy >> numNodes;
-
-            std::cout << dummy << " " << numNodes << std::endl;
-
-            // read time
-            std::getline(file, currentLine);
-
-            // read maxeles
-            unsigned int node;
-            float maxele;
-            for (int i=0;i<numNodes;i++){
-                std::getline(file, currentLine);
-                std::stringstream(currentLine) >> node >> maxele ;
-                if (maxele==-99999.0)
-                    maxele = 0.0;
-                maxeles.push_back(maxele);
-            }
+            headerLine = QString(header.data());
+            numNodes = maxeles.size();
         }
     }
-
-    GetMinMaxele();
-    GetMaxMaxele();
 }
 
 
@@ -105,14 +86,25 @@ float Maxele63::GetMaxele(int index){
     return maxeles[index];
 }
 
+const std::vector<float>& Maxele63::GetMaxeles(){
+    return maxeles;
+}
+
 float Maxele63::GetMinMaxele(){
-    float minmaxele = (float)(std::min_element(maxeles.begin(),maxeles.end()))[0];
-    std::cout << minmaxele << std::endl;
-    return minmaxele;
+    return stats.minValue;
 }
 
 float Maxele63::GetMaxMaxele(){
-    float maxmaxele = (float)(std::max_element(maxeles.begin(),maxeles.end()))[0];
-    std::cout << maxmaxele << std::endl;
-    return maxmaxele;
+    return stats.maxValue;
+}
+
+/**
+ * @brief Returns the mean maxele of the nodes that were wet
+ */
+float Maxele63::GetMeanMaxele(){
+    return stats.meanValue;
+}
+
+unsigned int Maxele63::GetNumDryNodes(){
+    return stats.numDry;
 }
@@ -12,6 +12,7 @@
 #include <iostream>
 
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/GlobalOutputReader.h"
 
 class Maxele63 : public QObject
 {
@@ -25,8 +26,11 @@ class Maxele63 : public QObject
         QString                 GetHeaderLine();
         unsigned int            GetNumNodes();
         float       GetMaxele(int index);
+        const std::vector<float>&   GetMaxeles();
         float       GetMaxMaxele();
         float       GetMinMaxele();
+        float       GetMeanMaxele();
+        unsigned int    GetNumDryNodes();
 
 
 
@@ -40,6 +44,7 @@ class Maxele63 : public QObject
         QString             headerLine;
         unsigned int        numNodes;
         std::vector<float>  maxeles;
+        GlobalOutputStats   stats;
         void ReadFile();
 };
 
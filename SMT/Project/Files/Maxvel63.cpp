@@ -2,23 +2,114 @@
 
 Maxvel63::Maxvel63(QObject *parent) :
 	QObject(parent),
+	targetFile(),
 	domainName(),
-	projectFile(0)
+	projectFile(0),
+	headerLine(),
+	maxvels(),
+	stats()
 {
 }
 
 
 Maxvel63::Maxvel63(ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
+	targetFile(),
 	domainName(),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	headerLine(),
+	maxvels(),
+	stats()
 {
 }
 
 
 Maxvel63::Maxvel63(QString domainName, ProjectFile *projectFile, QObject *parent) :
 	QObject(parent),
+	targetFile(),
 	domainName(domainName),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	headerLine(),
+	maxvels(),
+	stats()
 {
 }
+
+
+/**
+ * @brief Constructor that reads a maxvel.63 file right away
+ * @param targetFile The file to read
+ */
+Maxvel63::Maxvel63(QString targetFile, QString domainName, ProjectFile *projectFile, QObject *parent) :
+	QObject(parent),
+	targetFile(targetFile),
+	domainName(domainName),
+	projectFile(projectFile),
+	headerLine(),
+	maxvels(),
+	stats()
+{
+	ReadFile();
+}
+
+
+QString Maxvel63::GetHeaderLine()
+{
+	if (headerLine.isEmpty())
+		ReadFile();
+	return headerLine;
+}
+
+
+unsigned int Maxvel63::GetNumNodes()
+{
+	return maxvels.size();
+}
+
+
+float Maxvel63::GetMaxvel(int index)
+{
+	return maxvels[index];
+}
+
+
+float Maxvel63::GetMaxMaxvel()
+{
+	return stats.maxValue;
+}
+
+
+float Maxvel63::GetMinMaxvel()
+{
+	return stats.minValue;
+}
+
+
+/**
+ * @brief Returns the mean maximum speed of the nodes that were wet
+ */
+float Maxvel63::GetMeanMaxvel()
+{
+	return stats.meanValue;
+}
+
+
+unsigned int Maxvel63::GetNumDryNodes()
+{
+	return stats.numDry;
+}
+
+
+/**
+ * @brief Reads the file, replacing the values of dry nodes with 0, and
+ * gathers the statistics that the getters return
+ */
+void Maxvel63::ReadFile()
+{
+	if (!targetFile.isEmpty())
+	{
+		std::string header;
+		if (GlobalOutputReader::ReadFile(targetFile, 0.0, &header, &maxvels, &stats))
+			headerLine = QString(header.data());
+	}
+}
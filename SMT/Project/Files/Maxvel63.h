@@ -3,9 +3,16 @@
 
 
 #include <QObject>
+#include <QString>
+
+#include <vector>
 
 #include "Project/Files/ProjectFile.h"
+#include "Project/Files/Workers/GlobalOutputReader.h"
 
+/**
+ * @brief Reads the maximum speed of every node from a maxvel.63 file
+ */
 class Maxvel63 : public QObject
 {
 		Q_OBJECT
@@ -13,11 +20,27 @@ class Maxvel63 : public QObject
 		explicit Maxvel63(QObject *parent=0);
 		Maxvel63(ProjectFile *projectFile, QObject *parent=0);
 		Maxvel63(QString domainName, ProjectFile *projectFile, QObject *parent=0);
+		Maxvel63(QString targetFile, QString domainName, ProjectFile *projectFile, QObject *parent=0);
+
+		QString		GetHeaderLine();
+		unsigned int	GetNumNodes();
+		float		GetMaxvel(int index);
+		float		GetMaxMaxvel();
+		float		GetMinMaxvel();
+		float		GetMeanMaxvel();
+		unsigned int	GetNumDryNodes();
 
 	private:
 
+		QString			targetFile;
 		QString			domainName;
 		ProjectFile*	projectFile;
+
+		QString			headerLine;
+		std::vector<float>	maxvels;
+		GlobalOutputStats	stats;
+
+		void	ReadFile();
 };
 
 #endif // MAXVEL63_H
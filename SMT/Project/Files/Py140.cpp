@@ -1,5 +1,40 @@
 #include "Py140.h"
 
+const unsigned int Py140::NoNode;
+
+
+/*
+ * Text helpers for the reader and writer
+ */
+
+static const char* ReadNumber(const char *pos, const char *end, unsigned int *value)
+{
+	while (pos < end && (*pos < '0' || *pos > '9'))
+		++pos;
+	if (pos == end)
+		return 0;
+
+	unsigned int result = 0;
+	while (pos < end && *pos >= '0' && *pos <= '9')
+		result = 10*result + (*pos++ - '0');
+	*value = result;
+	return pos;
+}
+
+
+static char* WriteNumber(char *out, unsigned int value)
+{
+	char digits[10];
+	int numDigits = 0;
+	do {
+		digits[numDigits++] = '0' + value%10;
+		value /= 10;
+	} while (value);
+	while (numDigits)
+		*out++ = digits[--numDigits];
+	return out;
+}
+
 
 /*
  * Default constructor
@@ -50,96 +85,129 @@ Py140::Py140(QString domainName, ProjectFile *projectFile, QObject *parent) :
 }
 
 
-void Py140::SaveFile()
+/**
+ * @brief Writes the file in a single block
+ *
+ * The text is formatted into a buffer with a simple integer formatter instead
+ * of going through a stream for every number. The file location was recorded in
+ * the project file by the constructor, so saving doesn't touch the project file
+ * and can be done from a worker thread.
+ */
+bool Py140::SaveFile()
 {
-	if (projectFile && !domainName.isEmpty())
+	if (projectFile && !domainName.isEmpty() && !targetFile.isEmpty())
 	{
-		std::ofstream file (projectFile->GetSubDomainPy140(domainName).toStdString().data());
+		std::ofstream file (targetFile.toStdString().data(), std::ios::out | std::ios::binary);
 		if (file.is_open())
 		{
-			file << "new old " << newToOldNodes.size() << "\n";
-			if (newToOldNodes.size() > 0)
+			std::vector<char> buffer (32 + 22*newToOldNodes.size());
+			char *out = &buffer[0];
+			out += sprintf(out, "new old %u\n", (unsigned int)newToOldNodes.size());
+			for (unsigned int i=0; i<newToOldNodes.size(); ++i)
 			{
-				for (std::map<unsigned int, unsigned int>::iterator it = newToOldNodes.begin(); it != newToOldNodes.end(); ++it)
-				{
-					file << it->first << " " << it->second << "\n";
-				}
+				out = WriteNumber(out, i+1);
+				*out++ = ' ';
+				out = WriteNumber(out, newToOldNodes[i]);
+				*out++ = '\n';
 			}
+			file.write(&buffer[0], out - &buffer[0]);
 			file.close();
+			return !file.fail();
 		} else {
-			std::cout << "Unable to write py.140: " << projectFile->GetSubDomainPy140(domainName).toStdString() << std::endl;
+			std::cout << "Unable to write py.140: " << targetFile.toStdString() << std::endl;
 		}
-		projectFile->SetSubDomainPy140(domainName, targetFile);
 	}
+	return false;
 }
 
 
-void Py140::SetNewToOld(std::map<unsigned int, unsigned int> newMap)
+/**
+ * @brief Sets the node numbering of the subdomain
+ * @param oldNumbers The full domain node number of each subdomain node, in
+ * subdomain order (entry i is subdomain node i+1)
+ */
+void Py140::SetNewToOld(const std::vector<unsigned int> &oldNumbers)
 {
-	newToOldNodes = newMap;
-	oldToNewNodes.clear();
-	if (newToOldNodes.size() > 0)
-	{
-		for (std::map<unsigned int, unsigned int>::iterator it = newToOldNodes.begin(); it != newToOldNodes.end(); ++it)
-		{
-			oldToNewNodes[it->second] = it->first;
-		}
-	}
+	newToOldNodes = oldNumbers;
+	BuildOldToNew();
 }
 
 
-void Py140::SetOldToNew(std::map<unsigned int, unsigned int> newMap)
+/**
+ * @brief Returns the full domain number of a subdomain node, or NoNode
+ */
+unsigned int Py140::ConvertNewToOld(unsigned int newNum)
 {
-	oldToNewNodes = newMap;
-	newToOldNodes.clear();
-	if (oldToNewNodes.size() > 0)
-	{
-		for (std::map<unsigned int, unsigned int>::iterator it = oldToNewNodes.begin(); it != oldToNewNodes.end(); ++it)
-		{
-			newToOldNodes[it->second] = it->first;
-		}
-	}
+	if (newToOldNodes.empty())
+		ReadFile();
+	if (newNum == 0 || newNum > newToOldNodes.size())
+		return NoNode;
+	return newToOldNodes[newNum-1];
 }
 
 
-unsigned int Py140::ConvertNewToOld(unsigned int newNum)
+/**
+ * @brief Converts a block of subdomain node numbers to full domain node numbers
+ * @param newNums The subdomain node numbers
+ * @param count The number of node numbers to convert
+ * @param oldNums Receives the full domain node numbers (NoNode if out of range)
+ */
+void Py140::ConvertNewToOld(const unsigned int *newNums, unsigned int count, unsigned int *oldNums)
 {
-	if (!newToOldNodes.size())
+	if (newToOldNodes.empty())
 		ReadFile();
-	return newToOldNodes[newNum];
+	const unsigned int tableSize = newToOldNodes.size();
+	const unsigned int *table = tableSize ? &newToOldNodes[0] : 0;
+	for (unsigned int i=0; i<count; ++i)
+		oldNums[i] = (newNums[i]-1 < tableSize) ? table[newNums[i]-1] : NoNode;
 }
 
 
-std::vector<unsigned int> Py140::ConvertNewToOld(std::vector<unsigned int> newVector)
+std::vector<unsigned int> Py140::ConvertNewToOld(const std::vector<unsigned int> &newVector)
 {
-	if (!newToOldNodes.size())
-		ReadFile();
-	std::vector<unsigned int> oldVals;
-	for (std::vector<unsigned int>::iterator it = newVector.begin(); it != newVector.end(); ++it)
-	{
-		oldVals.push_back(newToOldNodes[*it]);
-	}
+	std::vector<unsigned int> oldVals (newVector.size());
+	if (!newVector.empty())
+		ConvertNewToOld(&newVector[0], newVector.size(), &oldVals[0]);
 	return oldVals;
 }
 
 
+/**
+ * @brief Returns the subdomain number of a full domain node, or NoNode if
+ * the node isn't in the subdomain
+ */
 unsigned int Py140::ConvertOldToNew(unsigned int oldNum)
 {
-	if (!oldToNewNodes.size())
+	if (oldToNewNodes.empty())
 		ReadFile();
+	if (oldNum >= oldToNewNodes.size())
+		return NoNode;
 	return oldToNewNodes[oldNum];
 }
 
 
-std::vector<unsigned int> Py140::ConvertOldToNew(std::vector<unsigned int> oldVector)
+/**
+ * @brief Converts a block of full domain node numbers to subdomain node numbers
+ * @param oldNums The full domain node numbers
+ * @param count The number of node numbers to convert
+ * @param newNums Receives the subdomain node numbers (NoNode if not in the subdomain)
+ */
+void Py140::ConvertOldToNew(const unsigned int *oldNums, unsigned int count, unsigned int *newNums)
 {
-	if (!oldToNewNodes.size())
+	if (oldToNewNodes.empty())
 		ReadFile();
-	std::vector<unsigned int> newVals;
-	for (std::vector<unsigned int>::iterator it = oldVector.begin(); it != oldVector.end(); ++it)
-	{
-		newVals.push_back(oldToNewNodes[*it]);
-	}
+	const unsigned int tableSize = oldToNewNodes.size();
+	const unsigned int *table = tableSize ? &oldToNewNodes[0] : 0;
+	for (unsigned int i=0; i<count; ++i)
+		newNums[i] = (oldNums[i] < tableSize) ? table[oldNums[i]] : NoNode;
+}
+
+
+std::vector<unsigned int> Py140::ConvertOldToNew(const std::vector<unsigned int> &oldVector)
+{
+	std::vector<unsigned int> newVals (oldVector.size());
+	if (!oldVector.empty())
+		ConvertOldToNew(&oldVector[0], oldVector.size(), &newVals[0]);
 	return newVals;
 }
 
@@ -154,9 +222,13 @@ QString	Py140::GetFilePath()
 }
 
 
-std::map<unsigned int, unsigned int> Py140::GetNewToOld()
+/**
+ * @brief Returns the full domain node number of every subdomain node (entry i
+ * is subdomain node i+1)
+ */
+const std::vector<unsigned int>& Py140::GetNewToOld()
 {
-	if (!newToOldNodes.size())
+	if (newToOldNodes.empty())
 		ReadFile();
 	return newToOldNodes;
 }
@@ -164,13 +236,19 @@ std::map<unsigned int, unsigned int> Py140::GetNewToOld()
 
 unsigned int Py140::GetNumNodes()
 {
+	if (newToOldNodes.empty())
+		ReadFile();
 	return newToOldNodes.size();
 }
 
 
-std::map<unsigned int, unsigned int> Py140::GetOldToNew()
+/**
+ * @brief Returns the subdomain node number of every full domain node number,
+ * with NoNode for nodes that aren't in the subdomain
+ */
+const std::vector<unsigned int>& Py140::GetOldToNew()
 {
-	if (!oldToNewNodes.size())
+	if (oldToNewNodes.empty())
 		ReadFile();
 	return oldToNewNodes;
 }
@@ -178,32 +256,71 @@ std::map<unsigned int, unsigned int> Py140::GetOldToNew()
 
 bool Py140::HasOldNode(unsigned int nodeNum)
 {
-	if (oldToNewNodes.count(nodeNum))
-		return true;
-	return false;
+	return ConvertOldToNew(nodeNum) != NoNode;
+}
+
+
+/**
+ * @brief Fills the old to new table from the new to old table
+ */
+void Py140::BuildOldToNew()
+{
+	unsigned int maxOld = 0;
+	for (unsigned int i=0; i<newToOldNodes.size(); ++i)
+		if (newToOldNodes[i] > maxOld)
+			maxOld = newToOldNodes[i];
+
+	oldToNewNodes.assign(newToOldNodes.empty() ? 0 : maxOld+1, NoNode);
+	for (unsigned int i=0; i<newToOldNodes.size(); ++i)
+		if (newToOldNodes[i] != NoNode)
+			oldToNewNodes[newToOldNodes[i]] = i+1;
 }
 
 
+/**
+ * @brief Reads the whole file into memory and parses the number pairs directly
+ */
 void Py140::ReadFile()
 {
 	if (projectFile && !domainName.isEmpty())
 	{
 		QString targetFile = projectFile->GetSubDomainPy140(domainName);
-		std::ifstream file (targetFile.toStdString().data());
+		std::ifstream file (targetFile.toStdString().data(), std::ios::in | std::ios::binary);
 		if (file.is_open())
 		{
+			file.seekg(0, std::ios::end);
+			std::streamoff fileSize = file.tellg();
+			file.seekg(0, std::ios::beg);
+			if (fileSize <= 0)
+				return;
+
+			std::vector<char> contents (fileSize);
+			file.read(&contents[0], fileSize);
+			file.close();
+
+			const char *pos = &contents[0];
+			const char *end = pos + file.gcount();
+
+			/* The header line is "new old <number of nodes>" */
+			const char *headerEnd = (const char*)memchr(pos, '\n', end-pos);
+			if (!headerEnd)
+				return;
+			unsigned int numNodes = 0;
+			ReadNumber(pos, headerEnd, &numNodes);
+			pos = headerEnd+1;
+
 			newToOldNodes.clear();
-			oldToNewNodes.clear();
-			std::string line;
-			std::getline(file, line);
-			int currOld, currNew;
-			while (std::getline(file, line))
+			newToOldNodes.reserve(numNodes);
+			unsigned int currNew, currOld;
+			while ((pos = ReadNumber(pos, end, &currNew)) && (pos = ReadNumber(pos, end, &currOld)))
 			{
-				std::stringstream(line) >> currNew >> currOld;
-				newToOldNodes[currNew] = currOld;
-				oldToNewNodes[currOld] = currNew;
+				if (currNew == 0)
+					continue;
+				if (currNew > newToOldNodes.size())
+					newToOldNodes.resize(currNew, NoNode);
+				newToOldNodes[currNew-1] = currOld;
 			}
-			file.close();
+			BuildOldToNew();
 		}
 	}
 }
@@ -4,13 +4,25 @@
 #include <QObject>
 
 #include <vector>
-#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <istream>
 #include <fstream>
 #include <sstream>
 
 #include "Project/Files/ProjectFile.h"
 
+/**
+ * @brief The py.140 file, which maps subdomain node numbers to full domain
+ * node numbers
+ *
+ * Both directions are stored as dense tables. The new to old table has one entry
+ * per subdomain node, and the old to new table has one entry per full domain node
+ * number, with NoNode for full domain nodes that aren't in the subdomain. Lookups
+ * never insert anything.
+ *
+ */
 class Py140 : public QObject
 {
 		Q_OBJECT
@@ -18,18 +30,21 @@ class Py140 : public QObject
 		explicit Py140(QObject *parent=0);
 		Py140(QString domainName, ProjectFile *projectFile, QObject *parent=0);
 
-		void					SaveFile();
-		void					SetNewToOld(std::map<unsigned int, unsigned int> newMap);
-		void					SetOldToNew(std::map<unsigned int, unsigned int> newMap);
+		static const unsigned int	NoNode = 0;
+
+		bool					SaveFile();
+		void					SetNewToOld(const std::vector<unsigned int> &oldNumbers);
 
 		unsigned int				ConvertNewToOld(unsigned int newNum);
-		std::vector<unsigned int>		ConvertNewToOld(std::vector<unsigned int> newVector);
+		void					ConvertNewToOld(const unsigned int *newNums, unsigned int count, unsigned int *oldNums);
+		std::vector<unsigned int>		ConvertNewToOld(const std::vector<unsigned int> &newVector);
 		unsigned int				ConvertOldToNew(unsigned int oldNum);
-		std::vector<unsigned int>		ConvertOldToNew(std::vector<unsigned int> oldVector);
+		void					ConvertOldToNew(const unsigned int *oldNums, unsigned int count, unsigned int *newNums);
+		std::vector<unsigned int>		ConvertOldToNew(const std::vector<unsigned int> &oldVector);
 		QString					GetFilePath();
-		std::map<unsigned int, unsigned int>	GetNewToOld();
+		const std::vector<unsigned int>&	GetNewToOld();
 		unsigned int				GetNumNodes();
-		std::map<unsigned int, unsigned int>	GetOldToNew();
+		const std::vector<unsigned int>&	GetOldToNew();
 		bool					HasOldNode(unsigned int nodeNum);
 
 	private:
@@ -38,9 +53,10 @@ class Py140 : public QObject
 		ProjectFile*	projectFile;
 		QString		targetFile;
 
-		std::map<unsigned int, unsigned int>	newToOldNodes;
-		std::map<unsigned int, unsigned int>	oldToNewNodes;
+		std::vector<unsigned int>	newToOldNodes;	/**< Full domain number of subdomain node i+1 */
+		std::vector<unsigned int>	oldToNewNodes;	/**< Subdomain number of full domain node i, or NoNode */
 
+		void	BuildOldToNew();
 		void	ReadFile();
 };
 
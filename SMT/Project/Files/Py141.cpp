@@ -1,5 +1,40 @@
 #include "Py141.h"
 
+const unsigned int Py141::NoElement;
+
+
+/*
+ * Text helpers for the reader and writer
+ */
+
+static const char* ReadNumber(const char *pos, const char *end, unsigned int *value)
+{
+	while (pos < end && (*pos < '0' || *pos > '9'))
+		++pos;
+	if (pos == end)
+		return 0;
+
+	unsigned int result = 0;
+	while (pos < end && *pos >= '0' && *pos <= '9')
+		result = 10*result + (*pos++ - '0');
+	*value = result;
+	return pos;
+}
+
+
+static char* WriteNumber(char *out, unsigned int value)
+{
+	char digits[10];
+	int numDigits = 0;
+	do {
+		digits[numDigits++] = '0' + value%10;
+		value /= 10;
+	} while (value);
+	while (numDigits)
+		*out++ = digits[--numDigits];
+	return out;
+}
+
 
 /*
  * Default constructor
@@ -47,96 +82,129 @@ Py141::Py141(QString domainName, ProjectFile *projectFile, QObject *parent) :
 }
 
 
-void Py141::SaveFile()
+/**
+ * @brief Writes the file in a single block
+ *
+ * The text is formatted into a buffer with a simple integer formatter instead
+ * of going through a stream for every number. The file location was recorded in
+ * the project file by the constructor, so saving doesn't touch the project file
+ * and can be done from a worker thread.
+ */
+bool Py141::SaveFile()
 {
-	if (projectFile && !domainName.isEmpty())
+	if (projectFile && !domainName.isEmpty() && !targetFile.isEmpty())
 	{
-		std::ofstream file (projectFile->GetSubDomainPy141(domainName).toStdString().data());
+		std::ofstream file (targetFile.toStdString().data(), std::ios::out | std::ios::binary);
 		if (file.is_open())
 		{
-			file << "new old " << newToOldElements.size() << "\n";
-			if (newToOldElements.size() > 0)
+			std::vector<char> buffer (32 + 22*newToOldElements.size());
+			char *out = &buffer[0];
+			out += sprintf(out, "new old %u\n", (unsigned int)newToOldElements.size());
+			for (unsigned int i=0; i<newToOldElements.size(); ++i)
 			{
-				for (std::map<unsigned int, unsigned int>::iterator it = newToOldElements.begin(); it != newToOldElements.end(); ++it)
-				{
-					file << it->first << " " << it->second << "\n";
-				}
+				out = WriteNumber(out, i+1);
+				*out++ = ' ';
+				out = WriteNumber(out, newToOldElements[i]);
+				*out++ = '\n';
 			}
+			file.write(&buffer[0], out - &buffer[0]);
 			file.close();
+			return !file.fail();
 		} else {
-			std::cout << "Unable to write py.141: " << projectFile->GetSubDomainPy141(domainName).toStdString() << std::endl;
+			std::cout << "Unable to write py.141: " << targetFile.toStdString() << std::endl;
 		}
-		projectFile->SetSubDomainPy141(domainName, targetFile);
 	}
+	return false;
 }
 
 
-void Py141::SetNewToOld(std::map<unsigned int, unsigned int> newMap)
+/**
+ * @brief Sets the element numbering of the subdomain
+ * @param oldNumbers The full domain element number of each subdomain element, in
+ * subdomain order (entry i is subdomain element i+1)
+ */
+void Py141::SetNewToOld(const std::vector<unsigned int> &oldNumbers)
 {
-	newToOldElements = newMap;
-	oldToNewElements.clear();
-	if (newToOldElements.size() > 0)
-	{
-		for (std::map<unsigned int, unsigned int>::iterator it = newToOldElements.begin(); it != newToOldElements.end(); ++it)
-		{
-			oldToNewElements[it->second] = it->first;
-		}
-	}
+	newToOldElements = oldNumbers;
+	BuildOldToNew();
 }
 
 
-void Py141::SetOldToNew(std::map<unsigned int, unsigned int> newMap)
+/**
+ * @brief Returns the full domain number of a subdomain element, or NoElement
+ */
+unsigned int Py141::ConvertNewToOld(unsigned int newNum)
 {
-	oldToNewElements = newMap;
-	newToOldElements.clear();
-	if (oldToNewElements.size() > 0)
-	{
-		for (std::map<unsigned int, unsigned int>::iterator it = oldToNewElements.begin(); it != oldToNewElements.end(); ++it)
-		{
-			newToOldElements[it->second] = it->first;
-		}
-	}
+	if (newToOldElements.empty())
+		ReadFile();
+	if (newNum == 0 || newNum > newToOldElements.size())
+		return NoElement;
+	return newToOldElements[newNum-1];
 }
 
 
-unsigned int Py141::ConvertNewToOld(unsigned int newNum)
+/**
+ * @brief Converts a block of subdomain element numbers to full domain element numbers
+ * @param newNums The subdomain element numbers
+ * @param count The number of element numbers to convert
+ * @param oldNums Receives the full domain element numbers (NoElement if out of range)
+ */
+void Py141::ConvertNewToOld(const unsigned int *newNums, unsigned int count, unsigned int *oldNums)
 {
-	if (!newToOldElements.size())
+	if (newToOldElements.empty())
 		ReadFile();
-	return newToOldElements[newNum];
+	const unsigned int tableSize = newToOldElements.size();
+	const unsigned int *table = tableSize ? &newToOldElements[0] : 0;
+	for (unsigned int i=0; i<count; ++i)
+		oldNums[i] = (newNums[i]-1 < tableSize) ? table[newNums[i]-1] : NoElement;
 }
 
 
-std::vector<unsigned int> Py141::ConvertNewToOld(std::vector<unsigned int> newVector)
+std::vector<unsigned int> Py141::ConvertNewToOld(const std::vector<unsigned int> &newVector)
 {
-	if (!newToOldElements.size())
-		ReadFile();
-	std::vector<unsigned int> oldVals;
-	for (std::vector<unsigned int>::iterator it = newVector.begin(); it != newVector.end(); ++it)
-	{
-		oldVals.push_back(newToOldElements[*it]);
-	}
+	std::vector<unsigned int> oldVals (newVector.size());
+	if (!newVector.empty())
+		ConvertNewToOld(&newVector[0], newVector.size(), &oldVals[0]);
 	return oldVals;
 }
 
 
+/**
+ * @brief Returns the subdomain number of a full domain element, or NoElement if
+ * the element isn't in the subdomain
+ */
 unsigned int Py141::ConvertOldToNew(unsigned int oldNum)
 {
-	if (!oldToNewElements.size())
+	if (oldToNewElements.empty())
 		ReadFile();
+	if (oldNum >= oldToNewElements.size())
+		return NoElement;
 	return oldToNewElements[oldNum];
 }
 
 
-std::vector<unsigned int> Py141::ConvertOldToNew(std::vector<unsigned int> oldVector)
+/**
+ * @brief Converts a block of full domain element numbers to subdomain element numbers
+ * @param oldNums The full domain element numbers
+ * @param count The number of element numbers to convert
+ * @param newNums Receives the subdomain element numbers (NoElement if not in the subdomain)
+ */
+void Py141::ConvertOldToNew(const unsigned int *oldNums, unsigned int count, unsigned int *newNums)
 {
-	if (!oldToNewElements.size())
+	if (oldToNewElements.empty())
 		ReadFile();
-	std::vector<unsigned int> newVals;
-	for (std::vector<unsigned int>::iterator it = oldVector.begin(); it != oldVector.end(); ++it)
-	{
-		newVals.push_back(oldToNewElements[*it]);
-	}
+	const unsigned int tableSize = oldToNewElements.size();
+	const unsigned int *table = tableSize ? &oldToNewElements[0] : 0;
+	for (unsigned int i=0; i<count; ++i)
+		newNums[i] = (oldNums[i] < tableSize) ? table[oldNums[i]] : NoElement;
+}
+
+
+std::vector<unsigned int> Py141::ConvertOldToNew(const std::vector<unsigned int> &oldVector)
+{
+	std::vector<unsigned int> newVals (oldVector.size());
+	if (!oldVector.empty())
+		ConvertOldToNew(&oldVector[0], oldVector.size(), &newVals[0]);
 	return newVals;
 }
 
@@ -151,42 +219,105 @@ QString	Py141::GetFilePath()
 }
 
 
-std::map<unsigned int, unsigned int> Py141::GetNewToOld()
+/**
+ * @brief Returns the full domain element number of every subdomain element (entry i
+ * is subdomain element i+1)
+ */
+const std::vector<unsigned int>& Py141::GetNewToOld()
 {
-	if (!newToOldElements.size())
+	if (newToOldElements.empty())
 		ReadFile();
 	return newToOldElements;
 }
 
 
-std::map<unsigned int, unsigned int> Py141::GetOldToNew()
+unsigned int Py141::GetNumElements()
+{
+	if (newToOldElements.empty())
+		ReadFile();
+	return newToOldElements.size();
+}
+
+
+/**
+ * @brief Returns the subdomain element number of every full domain element number,
+ * with NoElement for elements that aren't in the subdomain
+ */
+const std::vector<unsigned int>& Py141::GetOldToNew()
 {
-	if (!oldToNewElements.size())
+	if (oldToNewElements.empty())
 		ReadFile();
 	return oldToNewElements;
 }
 
 
+bool Py141::HasOldElement(unsigned int elementNum)
+{
+	return ConvertOldToNew(elementNum) != NoElement;
+}
+
+
+/**
+ * @brief Fills the old to new table from the new to old table
+ */
+void Py141::BuildOldToNew()
+{
+	unsigned int maxOld = 0;
+	for (unsigned int i=0; i<newToOldElements.size(); ++i)
+		if (newToOldElements[i] > maxOld)
+			maxOld = newToOldElements[i];
+
+	oldToNewElements.assign(newToOldElements.empty() ? 0 : maxOld+1, NoElement);
+	for (unsigned int i=0; i<newToOldElements.size(); ++i)
+		if (newToOldElements[i] != NoElement)
+			oldToNewElements[newToOldElements[i]] = i+1;
+}
+
+
+/**
+ * @brief Reads the whole file into memory and parses the number pairs directly
+ */
 void Py141::ReadFile()
 {
 	if (projectFile && !domainName.isEmpty())
 	{
 		QString targetFile = projectFile->GetSubDomainPy141(domainName);
-		std::ifstream file (targetFile.toStdString().data());
+		std::ifstream file (targetFile.toStdString().data(), std::ios::in | std::ios::binary);
 		if (file.is_open())
 		{
+			file.seekg(0, std::ios::end);
+			std::streamoff fileSize = file.tellg();
+			file.seekg(0, std::ios::beg);
+			if (fileSize <= 0)
+				return;
+
+			std::vector<char> contents (fileSize);
+			file.read(&contents[0], fileSize);
+			file.close();
+
+			const char *pos = &contents[0];
+			const char *end = pos + file.gcount();
+
+			/* The header line is "new old <number of elements>" */
+			const char *headerEnd = (const char*)memchr(pos, '\n', end-pos);
+			if (!headerEnd)
+				return;
+			unsigned int numElements = 0;
+			ReadNumber(pos, headerEnd, &numElements);
+			pos = headerEnd+1;
+
 			newToOldElements.clear();
-			oldToNewElements.clear();
-			std::string line;
-			std::getline(file, line);
-			int currOld, currNew;
-			while (std::getline(file, line))
+			newToOldElements.reserve(numElements);
+			unsigned int currNew, currOld;
+			while ((pos = ReadNumber(pos, end, &currNew)) && (pos = ReadNumber(pos, end, &currOld)))
 			{
-				std::stringstream(line) >> currNew >> currOld;
-				newToOldElements[currNew] = currOld;
-				oldToNewElements[currOld] = currNew;
+				if (currNew == 0)
+					continue;
+				if (currNew > newToOldElements.size())
+					newToOldElements.resize(currNew, NoElement);
+				newToOldElements[currNew-1] = currOld;
 			}
-			file.close();
+			BuildOldToNew();
 		}
 	}
 }
@@ -4,13 +4,23 @@
 #include <QObject>
 
 #include <vector>
-#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <istream>
 #include <fstream>
 #include <sstream>
 
 #include "Project/Files/ProjectFile.h"
 
+/**
+ * @brief The py.141 file, which maps subdomain element numbers to full domain
+ * element numbers
+ *
+ * Stored the same way as Py140: a dense table in each direction, with NoElement
+ * for full domain elements that aren't in the subdomain.
+ *
+ */
 class Py141 : public QObject
 {
 		Q_OBJECT
@@ -18,27 +28,33 @@ class Py141 : public QObject
 		explicit Py141(QObject *parent=0);
 		Py141(QString domainName, ProjectFile *projectFile, QObject *parent=0);
 
-		void					SaveFile();
-		void					SetNewToOld(std::map<unsigned int, unsigned int> newMap);
-		void					SetOldToNew(std::map<unsigned int, unsigned int> newMap);
+		static const unsigned int	NoElement = 0;
+
+		bool					SaveFile();
+		void					SetNewToOld(const std::vector<unsigned int> &oldNumbers);
 
 		unsigned int				ConvertNewToOld(unsigned int newNum);
-		std::vector<unsigned int>		ConvertNewToOld(std::vector<unsigned int> newVector);
+		void					ConvertNewToOld(const unsigned int *newNums, unsigned int count, unsigned int *oldNums);
+		std::vector<unsigned int>		ConvertNewToOld(const std::vector<unsigned int> &newVector);
 		unsigned int				ConvertOldToNew(unsigned int oldNum);
-		std::vector<unsigned int>		ConvertOldToNew(std::vector<unsigned int> oldVector);
+		void					ConvertOldToNew(const unsigned int *oldNums, unsigned int count, unsigned int *newNums);
+		std::vector<unsigned int>		ConvertOldToNew(const std::vector<unsigned int> &oldVector);
 		QString					GetFilePath();
-		std::map<unsigned int, unsigned int>	GetNewToOld();
-		std::map<unsigned int, unsigned int>	GetOldToNew();
+		const std::vector<unsigned int>&	GetNewToOld();
+		unsigned int				GetNumElements();
+		const std::vector<unsigned int>&	GetOldToNew();
+		bool					HasOldElement(unsigned int elementNum);
 
 	private:
 
-		QString			domainName;
+		QString		domainName;
 		ProjectFile*	projectFile;
-		QString			targetFile;
+		QString		targetFile;
 
-		std::map<unsigned int, unsigned int>	newToOldElements;
-		std::map<unsigned int, unsigned int>	oldToNewElements;
+		std::vector<unsigned int>	newToOldElements;	/**< Full domain number of subdomain element i+1 */
+		std::vector<unsigned int>	oldToNewElements;	/**< Subdomain number of full domain element i, or NoElement */
 
+		void	BuildOldToNew();
 		void	ReadFile();
 };
 
@@ -0,0 +1,79 @@
+#ifndef ASCIINUMBERPARSER_H
+#define ASCIINUMBERPARSER_H
+
+#include <cstring>
+#include <cmath>
+
+
+/**
+ * @brief Parses numbers straight out of the text of a mapped ADCIRC file
+ *
+ * Unlike strtod or streams, this doesn't depend on the locale, accepts the
+ * D exponents written by Fortran, and never reads past the end of the data,
+ * which doesn't have to end with a null character.
+ *
+ */
+class AsciiNumberParser
+{
+	public:
+
+		/**
+		 * @brief Returns the start of the next line, or the end of the data
+		 */
+		static const char* SkipLine(const char *pos, const char *end)
+		{
+			const char *newline = (const char*)memchr(pos, '\n', end - pos);
+			return newline ? newline + 1 : end;
+		}
+
+		/**
+		 * @brief Parses the next number on the current line
+		 * @param pos Moved past the number
+		 * @return false if the next character that isn't a space doesn't
+		 * start a number
+		 */
+		static bool ParseNumber(const char *&pos, const char *end, double *value)
+		{
+			static const double PowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+							     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+			while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r'))
+				++pos;
+
+			bool negative = false;
+			if (pos < end && (*pos == '-' || *pos == '+'))
+				negative = *pos++ == '-';
+
+			double mantissa = 0.0;
+			int exponent = 0;
+			bool digits = false;
+			for (; pos < end && *pos >= '0' && *pos <= '9'; ++pos, digits = true)
+				mantissa = 10.0*mantissa + (*pos - '0');
+			if (pos < end && *pos == '.')
+				for (++pos; pos < end && *pos >= '0' && *pos <= '9'; ++pos, digits = true, --exponent)
+					mantissa = 10.0*mantissa + (*pos - '0');
+			if (!digits)
+				return false;
+
+			if (pos < end && (*pos == 'E' || *pos == 'e' || *pos == 'D' || *pos == 'd'))
+			{
+				++pos;
+				bool negativeExponent = false;
+				if (pos < end && (*pos == '-' || *pos == '+'))
+					negativeExponent = *pos++ == '-';
+				int written = 0;
+				for (; pos < end && *pos >= '0' && *pos <= '9'; ++pos)
+					written = 10*written + (*pos - '0');
+				exponent += negativeExponent ? -written : written;
+			}
+
+			if (exponent >= 0)
+				mantissa *= exponent <= 22 ? PowersOfTen[exponent] : pow(10.0, exponent);
+			else
+				mantissa /= -exponent <= 22 ? PowersOfTen[-exponent] : pow(10.0, -exponent);
+			*value = negative ? -mantissa : mantissa;
+			return true;
+		}
+};
+
+#endif // ASCIINUMBERPARSER_H
@@ -0,0 +1,320 @@
+#include "BoundaryBinaryFormat.h"
+
+
+static const char BinaryMagic[8] = {'S', 'M', 'T', 'B', 'N', 'D', 'R', 'Y'};
+static const unsigned int BinaryByteOrder = 0x01020304;
+
+
+static void WriteUInt(std::ostream &file, unsigned int value)
+{
+	file.write((const char*)&value, sizeof(value));
+}
+
+
+static bool ReadUInt(std::istream &file, unsigned int *value)
+{
+	file.read((char*)value, sizeof(*value));
+	return file.good();
+}
+
+
+static unsigned int GetHeaderPadding(const BoundaryBinaryHeader &header)
+{
+	unsigned int size = sizeof(BinaryMagic) + 8*sizeof(unsigned int) +
+			    (header.lineValues.size() + header.nodes.size())*sizeof(unsigned int) + header.title.size();
+	return (8 - size%8) % 8;
+}
+
+
+static void StripLineEnd(std::string &line)
+{
+	while (!line.empty() && (line[line.size()-1] == '\r' || line[line.size()-1] == '\n'))
+		line.erase(line.size()-1);
+}
+
+
+/*
+ * Appends every number on a line of text to a record, and returns how many there were
+ */
+static unsigned int AppendValues(const char *text, unsigned int valueSize, std::vector<char> &record)
+{
+	unsigned int count = 0;
+	char *end = 0;
+	for (double value = strtod(text, &end); end != text; value = strtod(text, &end))
+	{
+		text = end;
+		size_t pos = record.size();
+		record.resize(pos + valueSize);
+		if (valueSize == 4)
+		{
+			float single = value;
+			memcpy(&record[pos], &single, sizeof(single));
+		} else {
+			memcpy(&record[pos], &value, sizeof(value));
+		}
+		++count;
+	}
+	return count;
+}
+
+
+/**
+ * @brief Checks the magic bytes at the start of a file, then moves back to the start
+ */
+bool BoundaryBinaryFormat::IsBinaryFile(std::istream &file)
+{
+	char magic[sizeof(BinaryMagic)];
+	file.read(magic, sizeof(magic));
+	bool isBinary = file.good() && memcmp(magic, BinaryMagic, sizeof(magic)) == 0;
+	file.clear();
+	file.seekg(0);
+	return isBinary;
+}
+
+
+/**
+ * @brief Reads the header of a binary file, leaving the file at the first timestep
+ */
+bool BoundaryBinaryFormat::ReadHeader(std::istream &file, BoundaryBinaryHeader *header)
+{
+	char magic[sizeof(BinaryMagic)];
+	file.read(magic, sizeof(magic));
+	if (!file.good() || memcmp(magic, BinaryMagic, sizeof(magic)) != 0)
+		return false;
+
+	unsigned int byteOrder, hasNodeList, numLines, numNodes, titleLength;
+	if (!ReadUInt(file, &byteOrder) || byteOrder != BinaryByteOrder)
+	{
+		std::cout << "The binary boundary condition file was written with a different byte order" << std::endl;
+		return false;
+	}
+	if (!ReadUInt(file, &header->valueSize) ||
+	    !ReadUInt(file, &header->recordFrequency) ||
+	    !ReadUInt(file, &header->numTimesteps) ||
+	    !ReadUInt(file, &hasNodeList) ||
+	    !ReadUInt(file, &numLines) ||
+	    !ReadUInt(file, &numNodes) ||
+	    !ReadUInt(file, &titleLength))
+		return false;
+	if ((header->valueSize != 4 && header->valueSize != 8) || numLines == 0 || numLines > 64 || titleLength > 4096)
+		return false;
+
+	header->hasNodeList = hasNodeList != 0;
+	header->lineValues.resize(numLines);
+	for (unsigned int i=0; i<numLines; ++i)
+		if (!ReadUInt(file, &header->lineValues[i]))
+			return false;
+
+	header->title.resize(titleLength);
+	if (titleLength)
+		file.read(&header->title[0], titleLength);
+
+	header->nodes.resize(numNodes);
+	if (numNodes)
+		file.read((char*)&header->nodes[0], numNodes*sizeof(unsigned int));
+
+	file.ignore(GetHeaderPadding(*header));
+	return file.good();
+}
+
+
+bool BoundaryBinaryFormat::WriteHeader(std::ostream &file, const BoundaryBinaryHeader &header)
+{
+	file.write(BinaryMagic, sizeof(BinaryMagic));
+	WriteUInt(file, BinaryByteOrder);
+	WriteUInt(file, header.valueSize);
+	WriteUInt(file, header.recordFrequency);
+	WriteUInt(file, header.numTimesteps);
+	WriteUInt(file, header.hasNodeList ? 1 : 0);
+	WriteUInt(file, header.lineValues.size());
+	WriteUInt(file, header.nodes.size());
+	WriteUInt(file, header.title.size());
+	for (unsigned int i=0; i<header.lineValues.size(); ++i)
+		WriteUInt(file, header.lineValues[i]);
+	file.write(header.title.data(), header.title.size());
+	if (!header.nodes.empty())
+		file.write((const char*)&header.nodes[0], header.nodes.size()*sizeof(unsigned int));
+
+	const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	file.write(padding, GetHeaderPadding(header));
+	return file.good();
+}
+
+
+/**
+ * @brief Returns the number of bytes in each record
+ */
+unsigned int BoundaryBinaryFormat::GetRecordSize(const BoundaryBinaryHeader &header)
+{
+	unsigned int numValues = 0;
+	for (unsigned int i=0; i<header.lineValues.size(); ++i)
+		numValues += header.lineValues[i];
+	return numValues*header.valueSize;
+}
+
+
+/**
+ * @brief Converts a boundary condition file from the ASCII layout to the binary one
+ *
+ * The number of values on each line of a record is taken from the first
+ * record, and every other record has to match it.
+ *
+ * @param asciiPath The ASCII file
+ * @param binaryPath The binary file to write
+ * @param linesPerRecord 2 for fort.066 and fort.020 files, otherwise 1
+ * @param hasNodeList true for subdomain files (fort.019/020/021), which list
+ * their nodes after the second line of the header
+ * @param valueSize 4 to store the values as float32, 8 for float64
+ */
+bool BoundaryBinaryFormat::AsciiToBinary(QString asciiPath, QString binaryPath, unsigned int linesPerRecord,
+					 bool hasNodeList, unsigned int valueSize)
+{
+	std::ifstream in (asciiPath.toStdString().data(), std::ios::in | std::ios::binary);
+	std::ofstream out (binaryPath.toStdString().data(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!in.is_open() || !out.is_open() || linesPerRecord == 0 || (valueSize != 4 && valueSize != 8))
+		return false;
+
+	BoundaryBinaryHeader header;
+	header.valueSize = valueSize;
+	header.hasNodeList = hasNodeList;
+
+	std::string line;
+	std::getline(in, header.title);
+	StripLineEnd(header.title);
+	std::getline(in, line);
+	char *pos = 0;
+	header.recordFrequency = strtoul(line.c_str(), &pos, 10);
+	unsigned int numNodes = strtoul(pos, &pos, 10);
+	header.numTimesteps = strtoul(pos, &pos, 10);
+	for (unsigned int i=0; i<numNodes && hasNodeList; ++i)
+		std::getline(in, line);
+	if (!in || numNodes == 0 || header.numTimesteps == 0)
+		return false;
+
+	std::vector<char> timestep;
+	for (unsigned int ts=0; ts<header.numTimesteps; ++ts)
+	{
+		timestep.clear();
+		if (!std::getline(in, line))
+		{
+			std::cout << asciiPath.toStdString() << " ended at timestep " << ts+1 << " of " << header.numTimesteps << std::endl;
+			return false;
+		}
+		double time = strtod(line.c_str(), &pos);
+		qint64 iteration = strtoll(pos, &pos, 10);
+		timestep.resize(TimeBlockSize);
+		memcpy(&timestep[0], &time, sizeof(time));
+		memcpy(&timestep[8], &iteration, sizeof(iteration));
+
+		for (unsigned int node=0; node<numNodes; ++node)
+		{
+			for (unsigned int l=0; l<linesPerRecord; ++l)
+			{
+				if (!std::getline(in, line))
+				{
+					std::cout << asciiPath.toStdString() << " ended at timestep " << ts+1 << " of " << header.numTimesteps << std::endl;
+					return false;
+				}
+
+				const char *text = line.c_str();
+				if (l == 0)
+				{
+					unsigned int nodeNumber = strtoul(text, &pos, 10);
+					text = pos;
+					if (ts == 0)
+						header.nodes.push_back(nodeNumber);
+					else if (nodeNumber != header.nodes[node])
+					{
+						std::cout << asciiPath.toStdString() << " lists its nodes in a different order in timestep " << ts+1 << std::endl;
+						return false;
+					}
+				}
+
+				unsigned int count = AppendValues(text, valueSize, timestep);
+				if (ts == 0 && node == 0)
+					header.lineValues.push_back(count);
+				else if (count != header.lineValues[l])
+				{
+					std::cout << "Record " << node+1 << " of timestep " << ts+1 << " in " << asciiPath.toStdString() <<
+						     " has a different number of values than the first record" << std::endl;
+					return false;
+				}
+			}
+		}
+
+		if (ts == 0 && !WriteHeader(out, header))
+			return false;
+		out.write(&timestep[0], timestep.size());
+	}
+	out.close();
+	return !out.fail();
+}
+
+
+/**
+ * @brief Converts a boundary condition file from the binary layout to ASCII,
+ * so it can be read or compared
+ *
+ * Values are written with enough digits to be read back exactly: 9 for float32
+ * and 17 for float64.
+ */
+bool BoundaryBinaryFormat::BinaryToAscii(QString binaryPath, QString asciiPath)
+{
+	std::ifstream in (binaryPath.toStdString().data(), std::ios::in | std::ios::binary);
+	std::ofstream out (asciiPath.toStdString().data(), std::ios::out | std::ios::binary | std::ios::trunc);
+	BoundaryBinaryHeader header;
+	if (!in.is_open() || !out.is_open() || !ReadHeader(in, &header))
+		return false;
+
+	out << header.title << "\n" << header.recordFrequency << "\t" << header.nodes.size() << "\t" << header.numTimesteps << "\n";
+	for (unsigned int i=0; i<header.nodes.size() && header.hasNodeList; ++i)
+		out << header.nodes[i] << "\n";
+
+	const char *format = header.valueSize == 4 ? " %.9g" : " %.17g";
+	std::vector<char> timestep (TimeBlockSize + header.nodes.size()*GetRecordSize(header));
+	std::string text;
+	char number[64];
+	for (unsigned int ts=0; ts<header.numTimesteps; ++ts)
+	{
+		in.read(&timestep[0], timestep.size());
+		if (!in.good())
+		{
+			std::cout << binaryPath.toStdString() << " ended at timestep " << ts+1 << " of " << header.numTimesteps << std::endl;
+			return false;
+		}
+
+		double time;
+		qint64 iteration;
+		memcpy(&time, &timestep[0], sizeof(time));
+		memcpy(&iteration, &timestep[8], sizeof(iteration));
+		text.clear();
+		text.append(number, sprintf(number, "%.17g %lld\n", time, (long long)iteration));
+
+		const char *value = &timestep[TimeBlockSize];
+		for (unsigned int node=0; node<header.nodes.size(); ++node)
+		{
+			for (unsigned int l=0; l<header.lineValues.size(); ++l)
+			{
+				if (l == 0)
+					text.append(number, sprintf(number, "%u", header.nodes[node]));
+				for (unsigned int v=0; v<header.lineValues[l]; ++v, value += header.valueSize)
+				{
+					double d;
+					if (header.valueSize == 4)
+					{
+						float single;
+						memcpy(&single, value, sizeof(single));
+						d = single;
+					} else {
+						memcpy(&d, value, sizeof(d));
+					}
+					text.append(number, sprintf(number, format, d));
+				}
+				text.push_back('\n');
+			}
+		}
+		out.write(text.data(), text.size());
+	}
+	out.close();
+	return !out.fail();
+}
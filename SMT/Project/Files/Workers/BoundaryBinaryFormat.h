@@ -0,0 +1,67 @@
+#ifndef BOUNDARYBINARYFORMAT_H
+#define BOUNDARYBINARYFORMAT_H
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+
+#include <QString>
+
+
+/**
+ * @brief The header of a boundary condition file in the binary layout
+ *
+ * Holds everything in the header of the ASCII layout, plus what is needed to
+ * write the records back out as text.
+ */
+struct BoundaryBinaryHeader
+{
+		std::string			title;
+		unsigned int			recordFrequency;
+		unsigned int			numTimesteps;
+		unsigned int			valueSize;	/**< 4 for float32 or 8 for float64 values */
+		std::vector<unsigned int>	lineValues;	/**< The number of values on each line of a record */
+		bool				hasNodeList;	/**< true for subdomain files, which list their nodes in the ASCII header */
+		std::vector<unsigned int>	nodes;		/**< The node of each record, in record order */
+};
+
+
+/**
+ * @brief Reads, writes and converts the binary layout of the boundary
+ * condition files (fort.065/066/067 and fort.019/020/021)
+ *
+ * In the binary layout, every timestep has the same size, so no text has to
+ * be parsed or formatted and any timestep can be found without an index:
+ *
+ * - Header: the magic bytes "SMTBNDRY", then the fields of BoundaryBinaryHeader,
+ *   padded to a multiple of 8 bytes
+ * - Each timestep: the time as a float64 and the iteration as an int64, then
+ *   one record per node in header order. A record is the record's values,
+ *   each a float32 or float64. Records don't repeat their node numbers.
+ *
+ * Values are stored in the byte order of the machine that wrote the file, and
+ * files from a machine with the other byte order are rejected.
+ *
+ */
+class BoundaryBinaryFormat
+{
+	public:
+
+		static const unsigned int	TimeBlockSize = 16;
+
+		static bool	IsBinaryFile(std::istream &file);
+		static bool	ReadHeader(std::istream &file, BoundaryBinaryHeader *header);
+		static bool	WriteHeader(std::ostream &file, const BoundaryBinaryHeader &header);
+		static unsigned int	GetRecordSize(const BoundaryBinaryHeader &header);
+
+		static bool	AsciiToBinary(QString asciiPath, QString binaryPath, unsigned int linesPerRecord,
+					      bool hasNodeList, unsigned int valueSize);
+		static bool	BinaryToAscii(QString binaryPath, QString asciiPath);
+};
+
+#endif // BOUNDARYBINARYFORMAT_H
@@ -0,0 +1,234 @@
+#include "BoundaryFileWriter.h"
+
+
+/*
+ * The size of the blocks that are written to the file
+ */
+static const size_t WriteBufferSize = 4*1024*1024;
+
+/*
+ * The most characters a number takes up in an ASCII record
+ */
+static const size_t MaxNumberLength = 32;
+
+
+BoundaryFileWriter::BoundaryFileWriter() :
+	file(),
+	filePath(),
+	tempPath(),
+	buffer(),
+	bufferUsed(0),
+	fileSize(0)
+{
+}
+
+
+BoundaryFileWriter::~BoundaryFileWriter()
+{
+	CloseFile();
+}
+
+
+/**
+ * @brief Starts a new file
+ *
+ * The file is written to filePath.part until CommitFile() is called.
+ */
+bool BoundaryFileWriter::StartWriting(QString filePath)
+{
+	if (filePath.isEmpty())
+		return false;
+
+	this->filePath = filePath;
+	tempPath = filePath + ".part";
+	return OpenFile(std::ios::out | std::ios::binary | std::ios::trunc, 0);
+}
+
+
+/**
+ * @brief Continues an unfinished file from a checkpoint
+ * @param offset The offset returned by Checkpoint(). Anything written after
+ * it is removed.
+ * @return false if the unfinished file is missing or shorter than the offset
+ */
+bool BoundaryFileWriter::ResumeWriting(QString filePath, quint64 offset)
+{
+	if (filePath.isEmpty())
+		return false;
+
+	this->filePath = filePath;
+	tempPath = filePath + ".part";
+	QFile tempFile (tempPath);
+	if (!tempFile.exists() || (quint64)tempFile.size() < offset || !tempFile.resize(offset))
+		return false;
+
+	return OpenFile(std::ios::in | std::ios::out | std::ios::binary, offset);
+}
+
+
+void BoundaryFileWriter::WriteHeader(int numTS, const std::vector<unsigned int> &nodeList)
+{
+	if (file.is_open())
+	{
+		char *start = Reserve(2*MaxNumberLength + nodeList.size()*MaxNumberLength);
+		char *pos = start;
+		pos += sprintf(pos, "1\t%u\t%d\n", (unsigned int)nodeList.size(), numTS);
+		for (std::vector<unsigned int>::const_iterator it = nodeList.begin(); it != nodeList.end(); ++it)
+		{
+			pos += sprintf(pos, "%u\n", *it);
+		}
+		Commit(pos - start);
+	}
+}
+
+
+void BoundaryFileWriter::WriteBinaryHeader(const BoundaryBinaryHeader &header)
+{
+	if (file.is_open())
+	{
+		std::ostringstream bytes;
+		BoundaryBinaryFormat::WriteHeader(bytes, header);
+		std::string data = bytes.str();
+		WriteBytes(data.data(), data.size());
+	}
+}
+
+
+/**
+ * @brief Writes bytes that are already formatted
+ */
+void BoundaryFileWriter::WriteBytes(const char *data, size_t length)
+{
+	if (!file.is_open() || buffer.empty())
+		return;
+
+	// Only fill the buffer up to the end of the current block, so large
+	// spans don't grow it
+	while (length > 0)
+	{
+		size_t count = std::min(length, (size_t)(WriteBufferSize - fileSize%WriteBufferSize) - bufferUsed);
+		memcpy(Reserve(count), data, count);
+		Commit(count);
+		data += count;
+		length -= count;
+	}
+}
+
+
+/**
+ * @brief Makes sure everything written so far is on disk
+ * @param offset Set to the size of the file, to be passed to ResumeWriting()
+ */
+bool BoundaryFileWriter::Checkpoint(quint64 *offset)
+{
+	if (!file.is_open() || !FlushBuffer() || !file.flush())
+		return false;
+
+	*offset = fileSize;
+	return FileSync::SyncFile(tempPath);
+}
+
+
+void BoundaryFileWriter::FinishedWriting()
+{
+	CloseFile();
+}
+
+
+/**
+ * @brief Closes the file and moves it into place
+ */
+bool BoundaryFileWriter::CommitFile()
+{
+	if (!CloseFile() || tempPath.isEmpty())
+		return false;
+	return FileSync::ReplaceFile(tempPath, filePath);
+}
+
+
+/**
+ * @brief Opens the temporary file
+ * @param offset The size of the file. Writing continues from its end.
+ */
+bool BoundaryFileWriter::OpenFile(std::ios::openmode mode, quint64 offset)
+{
+	if (file.is_open())
+		file.close();
+	file.clear();
+	file.rdbuf()->pubsetbuf(0, 0);
+	file.open(tempPath.toStdString().data(), mode);
+	if (!file.is_open())
+		return false;
+
+	bufferUsed = 0;
+	fileSize = offset;
+	if (buffer.size() < WriteBufferSize)
+		buffer.resize(WriteBufferSize);
+	file.seekp(0, std::ios::end);
+	return file.good();
+}
+
+
+/**
+ * @brief Flushes the buffer and closes the file
+ * @return false if anything couldn't be written
+ */
+bool BoundaryFileWriter::CloseFile()
+{
+	if (file.is_open())
+	{
+		FlushBuffer();
+		file.close();
+	}
+	return !file.fail();
+}
+
+
+/**
+ * @brief Makes room for data at the end of the buffer
+ * @param length The most bytes that will be added
+ * @return Where the data should be added, to be followed by Commit()
+ */
+char* BoundaryFileWriter::Reserve(size_t length)
+{
+	if (buffer.size() < bufferUsed + length + 1)
+		buffer.resize(bufferUsed + length + 1);
+	return &buffer[bufferUsed];
+}
+
+
+/**
+ * @brief Adds data to the buffer, and writes every block that is full
+ *
+ * Each block ends on a multiple of the buffer size in the file, so the file
+ * is written in whole aligned blocks until the buffer is flushed.
+ */
+void BoundaryFileWriter::Commit(size_t length)
+{
+	bufferUsed += length;
+	size_t blockSize = WriteBufferSize - fileSize%WriteBufferSize;
+	while (bufferUsed >= blockSize)
+	{
+		file.write(&buffer[0], blockSize);
+		fileSize += blockSize;
+		bufferUsed -= blockSize;
+		if (bufferUsed > 0)
+			memmove(&buffer[0], &buffer[blockSize], bufferUsed);
+		blockSize = WriteBufferSize;
+	}
+}
+
+
+/**
+ * @brief Writes everything in the buffer to the file
+ */
+bool BoundaryFileWriter::FlushBuffer()
+{
+	if (bufferUsed > 0)
+	{
+		file.write(&buffer[0], bufferUsed);
+		fileSize += bufferUsed;
+		bufferUsed = 0;
+	}
+	return file.good();
+}
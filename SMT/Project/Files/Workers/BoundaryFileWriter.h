@@ -0,0 +1,63 @@
+#ifndef BOUNDARYFILEWRITER_H
+#define BOUNDARYFILEWRITER_H
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#include <QString>
+#include <QFile>
+
+#include "Project/Files/Workers/FileSync.h"
+#include "Project/Files/Workers/BoundaryBinaryFormat.h"
+
+
+/**
+ * @brief Writes a subdomain boundary condition file (fort.019, fort.020 or
+ * fort.021) through one large buffer
+ *
+ * Everything written is gathered in a buffer that is reused for the whole
+ * file, and the buffer is written out in blocks that end on a multiple of the
+ * buffer size in the file. The file stream's own buffer is turned off, since
+ * only whole blocks are written to it.
+ *
+ * The file is written to a temporary file next to it, which is synced to disk
+ * at every checkpoint and replaces the file once CommitFile() is called. An
+ * unfinished temporary file can be continued from its last checkpoint.
+ *
+ */
+class BoundaryFileWriter
+{
+	public:
+		BoundaryFileWriter();
+		~BoundaryFileWriter();
+
+		bool	StartWriting(QString filePath);
+		bool	ResumeWriting(QString filePath, quint64 offset);
+		void	WriteHeader(int numTS, const std::vector<unsigned int> &nodeList);
+		void	WriteBinaryHeader(const BoundaryBinaryHeader &header);
+		void	WriteBytes(const char *data, size_t length);
+		bool	Checkpoint(quint64 *offset);
+		void	FinishedWriting();
+		bool	CommitFile();
+
+	private:
+
+		std::ofstream		file;
+		QString			filePath;
+		QString			tempPath;	/**< The file is written here until it is complete */
+		std::vector<char>	buffer;
+		size_t			bufferUsed;
+		quint64			fileSize;	/**< The number of bytes written out of the buffer */
+
+		bool	OpenFile(std::ios::openmode mode, quint64 offset);
+		bool	CloseFile();
+		char*	Reserve(size_t length);
+		void	Commit(size_t length);
+		bool	FlushBuffer();
+};
+
+#endif // BOUNDARYFILEWRITER_H
@@ -0,0 +1,346 @@
+#include "BoundaryRecordReader.h"
+
+
+static const size_t BlockSize = 4*1024*1024;
+
+
+/**
+ * @brief Constructor
+ * @param linesPerRecord The number of lines in each node's record
+ * @param spanIncludesNode true if the record span should start with the node
+ * number, false if it should start right after it
+ */
+BoundaryRecordReader::BoundaryRecordReader(unsigned int linesPerRecord, bool spanIncludesNode) :
+	file(),
+	buffer(),
+	start(0),
+	end(0),
+	endOfFile(false),
+	linesPerRecord(linesPerRecord),
+	spanIncludesNode(spanIncludesNode),
+	recordOffsets(),
+	filePath(),
+	fileNodes(0),
+	fileTimesteps(0),
+	index(),
+	binary(false),
+	binaryHeader(),
+	binaryDataStart(0),
+	binaryTimestepSize(0)
+{
+}
+
+
+BoundaryRecordReader::~BoundaryRecordReader()
+{
+	Close();
+}
+
+
+/**
+ * @brief Opens the file and reads the header
+ *
+ * The second line of the header holds the record frequency, the number of
+ * nodes in each timestep and the number of timesteps. A binary file gives
+ * them in its header instead.
+ */
+bool BoundaryRecordReader::Open(QString filePath, int *numNodes, int *numTimesteps)
+{
+	Close();
+	file.open(filePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	this->filePath = filePath;
+	if (BoundaryBinaryFormat::IsBinaryFile(file))
+	{
+		if (!BoundaryBinaryFormat::ReadHeader(file, &binaryHeader))
+			return false;
+		binary = true;
+		binaryDataStart = file.tellg();
+		binaryTimestepSize = BoundaryBinaryFormat::TimeBlockSize +
+				     binaryHeader.nodes.size()*BoundaryBinaryFormat::GetRecordSize(binaryHeader);
+		*numNodes = binaryHeader.nodes.size();
+		*numTimesteps = binaryHeader.numTimesteps;
+		fileNodes = *numNodes;
+		fileTimesteps = *numTimesteps;
+		return *numNodes > 0 && *numTimesteps > 0;
+	}
+
+	size_t titleEnd, infoEnd;
+	if (!FindLineEnd(0, &titleEnd) || !FindLineEnd(titleEnd, &infoEnd))
+		return false;
+
+	std::string info (&buffer[titleEnd], infoEnd - titleEnd);
+	char *pos = 0;
+	strtol(info.c_str(), &pos, 10);
+	*numNodes = strtol(pos, &pos, 10);
+	*numTimesteps = strtol(pos, &pos, 10);
+	start = infoEnd;
+
+	fileNodes = *numNodes > 0 ? *numNodes : 0;
+	fileTimesteps = *numTimesteps > 0 ? *numTimesteps : 0;
+	return *numNodes > 0 && *numTimesteps > 0;
+}
+
+
+/**
+ * @brief Reads the next timestep into the buffer
+ * @param numNodes The number of records in the timestep
+ * @param timestep Filled with views into the buffer
+ * @return false if the file ended before the timestep was complete
+ */
+bool BoundaryRecordReader::ReadTimestep(unsigned int numNodes, BoundaryTimestep *timestep)
+{
+	timestep->timeLine = 0;
+	timestep->timeLineLength = 0;
+	timestep->records.clear();
+
+	if (binary)
+		return ReadBinaryTimestep(numNodes, timestep);
+
+	// Drop the timesteps that have been read once the unread data is smaller
+	// than them, so small timesteps don't each move the rest of the block
+	if (start > 0 && end - start <= start)
+	{
+		if (end > start)
+			memmove(&buffer[0], &buffer[start], end - start);
+		end -= start;
+		start = 0;
+	}
+
+	// Offsets are stored while reading, because reading more data can move the buffer
+	size_t timeLineStart = start;
+	size_t pos = start;
+	size_t timeLineEnd;
+	if (!FindLineEnd(pos, &timeLineEnd))
+		return false;
+	size_t timeLineLength = timeLineEnd - timeLineStart;
+	while (timeLineLength > 0 && (buffer[timeLineStart+timeLineLength-1] == '\n' || buffer[timeLineStart+timeLineLength-1] == '\r'))
+		--timeLineLength;
+	pos = timeLineEnd;
+
+	timestep->records.resize(numNodes);
+	recordOffsets.resize(numNodes);
+	for (unsigned int i=0; i<numNodes; ++i)
+	{
+		size_t lineEnd;
+		if (!FindLineEnd(pos, &lineEnd))
+		{
+			timestep->records.clear();
+			return false;
+		}
+
+		size_t numberEnd = pos;
+		while (numberEnd < lineEnd && (buffer[numberEnd] == ' ' || buffer[numberEnd] == '\t'))
+			++numberEnd;
+		unsigned int node = 0;
+		while (numberEnd < lineEnd && buffer[numberEnd] >= '0' && buffer[numberEnd] <= '9')
+			node = 10*node + (buffer[numberEnd++] - '0');
+
+		recordOffsets[i] = spanIncludesNode ? pos : numberEnd;
+		for (unsigned int line=1; line<linesPerRecord; ++line)
+		{
+			if (!FindLineEnd(lineEnd, &lineEnd))
+			{
+				timestep->records.clear();
+				return false;
+			}
+		}
+
+		timestep->records[i].node = node;
+		timestep->records[i].length = lineEnd - recordOffsets[i];
+		pos = lineEnd;
+	}
+
+	const char *data = &buffer[0];
+	timestep->timeLine = data + timeLineStart;
+	timestep->timeLineLength = timeLineLength;
+	for (unsigned int i=0; i<numNodes; ++i)
+		timestep->records[i].data = data + recordOffsets[i];
+
+	start = pos;
+	return true;
+}
+
+
+/**
+ * @brief Moves to a timestep, so that it is the next one read
+ * @param timestep The timestep, counting from 0
+ * @return false if the file has no such timestep
+ */
+bool BoundaryRecordReader::SeekTimestep(unsigned int timestep)
+{
+	quint64 offset;
+	return GetTimestepOffset(timestep, &offset) && SeekOffset(offset);
+}
+
+
+/**
+ * @brief Moves to the start of a timestep that was found in a TimestepIndex
+ * @param offset The offset of the timestep's time line
+ */
+bool BoundaryRecordReader::SeekOffset(quint64 offset)
+{
+	if (!file.is_open())
+		return false;
+
+	file.clear();
+	file.seekg(offset);
+	if (!file)
+		return false;
+
+	start = 0;
+	end = 0;
+	endOfFile = false;
+	return true;
+}
+
+
+/**
+ * @brief Finds the offset of a timestep, for SeekOffset()
+ *
+ * The offsets of an ASCII file come from its TimestepIndex, while those of a
+ * binary file are computed from the size of a timestep.
+ *
+ * @param timestep The timestep, counting from 0
+ * @return false if the file has no such timestep, or it is cut off by the end
+ * of the file
+ */
+bool BoundaryRecordReader::GetTimestepOffset(unsigned int timestep, quint64 *offset)
+{
+	if (!file.is_open() || timestep >= fileTimesteps)
+		return false;
+
+	if (binary)
+	{
+		*offset = binaryDataStart + (quint64)timestep*binaryTimestepSize;
+		return *offset + binaryTimestepSize <= (quint64)QFileInfo(filePath).size();
+	}
+
+	if (!index.IsLoaded() && !index.Load(filePath, 2, 1 + fileNodes*linesPerRecord, fileTimesteps))
+		return false;
+	if (timestep >= index.GetNumTimesteps())
+		return false;
+
+	*offset = index.GetOffset(timestep);
+	return true;
+}
+
+
+bool BoundaryRecordReader::IsBinary()
+{
+	return binary;
+}
+
+
+/**
+ * @brief Returns the header of a binary file, or 0 for an ASCII file
+ */
+const BoundaryBinaryHeader* BoundaryRecordReader::GetBinaryHeader()
+{
+	return binary ? &binaryHeader : 0;
+}
+
+
+void BoundaryRecordReader::Close()
+{
+	if (file.is_open())
+		file.close();
+	file.clear();
+	start = 0;
+	end = 0;
+	endOfFile = false;
+	fileNodes = 0;
+	fileTimesteps = 0;
+	index.Clear();
+	binary = false;
+	binaryDataStart = 0;
+	binaryTimestepSize = 0;
+}
+
+
+/**
+ * @brief Reads the next timestep of a binary file into the buffer
+ *
+ * The time line of the timestep is its time and iteration, and each record
+ * spans the record's values.
+ */
+bool BoundaryRecordReader::ReadBinaryTimestep(unsigned int numNodes, BoundaryTimestep *timestep)
+{
+	if (numNodes != binaryHeader.nodes.size())
+		return false;
+
+	if (buffer.size() < binaryTimestepSize)
+		buffer.resize(binaryTimestepSize);
+	file.read(&buffer[0], binaryTimestepSize);
+	if ((size_t)file.gcount() != binaryTimestepSize)
+		return false;
+
+	const char *data = &buffer[0];
+	unsigned int recordSize = BoundaryBinaryFormat::GetRecordSize(binaryHeader);
+	timestep->timeLine = data;
+	timestep->timeLineLength = BoundaryBinaryFormat::TimeBlockSize;
+	timestep->records.resize(numNodes);
+	data += BoundaryBinaryFormat::TimeBlockSize;
+	for (unsigned int i=0; i<numNodes; ++i, data += recordSize)
+	{
+		timestep->records[i].node = binaryHeader.nodes[i];
+		timestep->records[i].data = data;
+		timestep->records[i].length = recordSize;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Finds the end of the line that starts at pos, reading more of the
+ * file as needed
+ * @param pos The start of the line
+ * @param lineEnd Set to the position just past the line's newline
+ * @return false if there is no line at pos
+ */
+bool BoundaryRecordReader::FindLineEnd(size_t pos, size_t *lineEnd)
+{
+	size_t searchStart = pos;
+	while (true)
+	{
+		if (searchStart < end)
+		{
+			const char *newline = (const char*)memchr(&buffer[searchStart], '\n', end - searchStart);
+			if (newline)
+			{
+				*lineEnd = newline - &buffer[0] + 1;
+				return true;
+			}
+			searchStart = end;
+		}
+
+		if (!ReadBlock())
+		{
+			// The last line of the file may not have a newline
+			*lineEnd = end;
+			return pos < end;
+		}
+	}
+}
+
+
+/**
+ * @brief Appends the next block of the file to the buffer
+ */
+bool BoundaryRecordReader::ReadBlock()
+{
+	if (endOfFile || !file.is_open())
+		return false;
+
+	if (buffer.size() < end + BlockSize)
+		buffer.resize(std::max(2*buffer.size(), end + BlockSize));
+
+	file.read(&buffer[end], BlockSize);
+	size_t bytesRead = file.gcount();
+	end += bytesRead;
+	if (bytesRead < BlockSize)
+		endOfFile = true;
+	return bytesRead > 0;
+}
@@ -0,0 +1,78 @@
+#ifndef BOUNDARYRECORDREADER_H
+#define BOUNDARYRECORDREADER_H
+
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+
+#include <QString>
+
+#include "adcData.h"
+#include "Project/Files/Workers/TimestepIndex.h"
+#include "Project/Files/Workers/BoundaryBinaryFormat.h"
+
+
+/**
+ * @brief Reads the timesteps of a full domain boundary condition file (fort.065,
+ * fort.066 or fort.067) without copying the records
+ *
+ * The file is read in large blocks into a single buffer that is reused for
+ * every timestep. A timestep is returned as a list of (node number, byte span)
+ * pairs that point into the buffer, so no memory is allocated per node once the
+ * buffer and record list have grown to the size of one timestep.
+ *
+ * Each record is a fixed number of lines that starts with the node number. The
+ * span either covers the whole record or starts right after the node number.
+ *
+ * SeekTimestep() jumps to any timestep using a TimestepIndex of the file, which
+ * is built by the first seek and saved next to the file for later runs.
+ *
+ * Files in the binary layout (see BoundaryBinaryFormat) are found by their
+ * magic bytes. Their timesteps are read with a single read each and need no
+ * index, and their records span only the values, since the node number of
+ * each record is taken from the header.
+ *
+ */
+class BoundaryRecordReader
+{
+	public:
+		BoundaryRecordReader(unsigned int linesPerRecord, bool spanIncludesNode);
+		~BoundaryRecordReader();
+
+		bool	Open(QString filePath, int *numNodes, int *numTimesteps);
+		bool	ReadTimestep(unsigned int numNodes, BoundaryTimestep *timestep);
+		bool	SeekTimestep(unsigned int timestep);
+		bool	SeekOffset(quint64 offset);
+		bool	GetTimestepOffset(unsigned int timestep, quint64 *offset);
+		bool	IsBinary();
+		const BoundaryBinaryHeader*	GetBinaryHeader();
+		void	Close();
+
+	private:
+
+		std::ifstream		file;
+		std::vector<char>	buffer;
+		size_t			start;		/**< Start of the unread part of the buffer */
+		size_t			end;		/**< End of the data in the buffer */
+		bool			endOfFile;
+		unsigned int		linesPerRecord;
+		bool			spanIncludesNode;
+		std::vector<size_t>	recordOffsets;	/**< Buffer offsets of the records while a timestep is read */
+		QString			filePath;
+		unsigned int		fileNodes;	/**< The number of nodes given in the header */
+		unsigned int		fileTimesteps;	/**< The number of timesteps given in the header */
+		TimestepIndex		index;
+		bool			binary;
+		BoundaryBinaryHeader	binaryHeader;
+		quint64			binaryDataStart;	/**< Offset of the first timestep in a binary file */
+		size_t			binaryTimestepSize;
+
+		bool	ReadBinaryTimestep(unsigned int numNodes, BoundaryTimestep *timestep);
+		bool	FindLineEnd(size_t pos, size_t *lineEnd);
+		bool	ReadBlock();
+};
+
+#endif // BOUNDARYRECORDREADER_H
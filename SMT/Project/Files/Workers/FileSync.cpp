@@ -0,0 +1,48 @@
+#include "FileSync.h"
+
+
+/**
+ * @brief Waits until everything written to a file has reached the disk
+ *
+ * Data is flushed by the file system no matter which descriptor it was
+ * written through, so the file's own stream should be flushed first.
+ */
+bool FileSync::SyncFile(QString filePath)
+{
+	QByteArray path = QFile::encodeName(filePath);
+#ifdef Q_OS_WIN32
+	int fd = _open(path.constData(), _O_WRONLY);
+	if (fd < 0)
+		return false;
+	bool synced = _commit(fd) == 0;
+	_close(fd);
+#else
+	int fd = open(path.constData(), O_WRONLY);
+	if (fd < 0)
+		return false;
+	bool synced = fsync(fd) == 0;
+	close(fd);
+#endif
+	return synced;
+}
+
+
+/**
+ * @brief Renames a finished temporary file over its final location
+ *
+ * The rename replaces an existing file in one step, so the final location
+ * always holds either the old file or the complete new one. Windows can't
+ * rename over an existing file, so there the old file is removed first.
+ */
+bool FileSync::ReplaceFile(QString tempPath, QString filePath)
+{
+	SyncFile(tempPath);
+
+	QByteArray from = QFile::encodeName(tempPath);
+	QByteArray to = QFile::encodeName(filePath);
+	if (rename(from.constData(), to.constData()) == 0)
+		return true;
+
+	QFile::remove(filePath);
+	return rename(from.constData(), to.constData()) == 0;
+}
@@ -0,0 +1,35 @@
+#ifndef FILESYNC_H
+#define FILESYNC_H
+
+#include <cstdio>
+
+#include <QtGlobal>
+#include <QString>
+#include <QFile>
+
+#ifdef Q_OS_WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+
+/**
+ * @brief Makes written data durable and moves finished files into place
+ *
+ * Used by files that are written over a long time and checkpointed, so that a
+ * checkpoint is only recorded once the data before it is on disk, and so the
+ * final file only appears once it is complete.
+ *
+ */
+class FileSync
+{
+	public:
+
+		static bool	SyncFile(QString filePath);
+		static bool	ReplaceFile(QString tempPath, QString filePath);
+};
+
+#endif // FILESYNC_H
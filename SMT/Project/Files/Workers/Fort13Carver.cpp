@@ -0,0 +1,522 @@
+#include "Fort13Carver.h"
+
+
+/* Approximate number of bytes of non-default lines indexed by one thread at a time */
+static const qint64 PieceSize = 4*1024*1024;
+
+/* Identifies an index file written by SaveIndex() */
+static const char IndexMagic[8] = {'S', 'M', 'T', '1', '3', 'I', 'D', 'X'};
+static const quint32 IndexVersion = 1;
+
+
+/*
+ * A line aligned piece of one attribute's non-default lines, indexed on one thread
+ */
+struct IndexPiece
+{
+		unsigned int			section;
+		const char			*data;
+		qint64				begin;
+		qint64				end;
+		std::vector<Fort13IndexEntry>	entries;
+};
+
+
+/*
+ * A range of the subdomain's full domain node numbers, merged against one
+ * attribute's index on one thread
+ */
+struct CarveChunk
+{
+		const Fort13Section		*section;
+		const char			*data;
+		const unsigned int		*oldNodes;
+		unsigned int			begin;
+		unsigned int			end;
+		const unsigned int		*oldToNew;
+		unsigned int			numLines;
+		std::vector<char>		output;
+};
+
+
+static bool EntryBeforeNode(const Fort13IndexEntry &entry, unsigned int node)
+{
+	return entry.node < node;
+}
+
+
+static bool EntryBeforeEntry(const Fort13IndexEntry &a, const Fort13IndexEntry &b)
+{
+	return a.node < b.node;
+}
+
+
+static char* WriteNumber(char *out, unsigned int value)
+{
+	char digits[10];
+	int numDigits = 0;
+	do {
+		digits[numDigits++] = '0' + value%10;
+		value /= 10;
+	} while (value);
+	while (numDigits)
+		*out++ = digits[--numDigits];
+	return out;
+}
+
+
+static void IndexLines(IndexPiece &piece)
+{
+	const char *pos = piece.data + piece.begin;
+	const char *end = piece.data + piece.end;
+	while (pos < end)
+	{
+		const char *lineEnd = (const char*)memchr(pos, '\n', end - pos);
+		const char *nextLine = lineEnd ? lineEnd+1 : end;
+		if (!lineEnd)
+			lineEnd = end;
+		if (lineEnd > pos && lineEnd[-1] == '\r')
+			--lineEnd;
+
+		const char *numberStart = pos;
+		while (numberStart < lineEnd && (*numberStart == ' ' || *numberStart == '\t'))
+			++numberStart;
+		const char *numberEnd = numberStart;
+		unsigned int nodeNumber = 0;
+		while (numberEnd < lineEnd && *numberEnd >= '0' && *numberEnd <= '9')
+			nodeNumber = 10*nodeNumber + (*numberEnd++ - '0');
+
+		if (numberEnd != numberStart)
+		{
+			Fort13IndexEntry entry;
+			entry.node = nodeNumber;
+			entry.length = lineEnd - numberEnd;
+			entry.offset = numberEnd - piece.data;
+			piece.entries.push_back(entry);
+		}
+
+		pos = nextLine;
+	}
+}
+
+
+static void CarveLines(CarveChunk &chunk)
+{
+	chunk.numLines = 0;
+
+	const std::vector<Fort13IndexEntry> &entries = chunk.section->entries;
+	std::vector<Fort13IndexEntry>::const_iterator entry = entries.begin();
+	for (unsigned int i=chunk.begin; i<chunk.end && entry != entries.end(); ++i)
+	{
+		unsigned int oldNode = chunk.oldNodes[i];
+		entry = std::lower_bound(entry, entries.end(), oldNode, EntryBeforeNode);
+		for (; entry != entries.end() && entry->node == oldNode; ++entry)
+		{
+			char number[10];
+			char *end = WriteNumber(number, chunk.oldToNew[oldNode]);
+			chunk.output.insert(chunk.output.end(), number, end);
+			chunk.output.insert(chunk.output.end(), chunk.data + entry->offset, chunk.data + entry->offset + entry->length);
+			chunk.output.push_back('\n');
+			++chunk.numLines;
+		}
+	}
+}
+
+
+/**
+ * @brief Constructor
+ * @param fullDomainFile Path to the full domain fort.13 file
+ * @param indexFile Where the index of the fort.13 file is kept (not saved if empty)
+ */
+Fort13Carver::Fort13Carver(QString fullDomainFile, QString indexFile)
+{
+	file.setFileName(fullDomainFile);
+	indexPath = indexFile;
+	data = 0;
+	dataSize = 0;
+	mappedData = 0;
+	headerEnd = 0;
+	propertiesStart = 0;
+	propertiesEnd = 0;
+}
+
+
+Fort13Carver::~Fort13Carver()
+{
+	if (mappedData)
+		file.unmap(mappedData);
+	if (file.isOpen())
+		file.close();
+}
+
+
+/**
+ * @brief Maps the full domain file and gets its index
+ *
+ * The index is loaded from the index file if it is still valid, and built (and
+ * saved) otherwise.
+ */
+bool Fort13Carver::LoadFile()
+{
+	if (data)
+		return true;
+
+	if (!OpenFile() || (!LoadIndex() && !BuildIndex()))
+	{
+		std::cout << "Unable to read full domain fort.13: " << file.fileName().toStdString() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Writes the subdomain fort.13 file
+ *
+ * @param py140 The py.140 file for converting from full to subdomain node numbers
+ * @param targetFile Path of the subdomain fort.13 file
+ * @return true if the file was written
+ */
+bool Fort13Carver::CarveSubdomain(Py140 *py140, QString targetFile)
+{
+	if (!py140 || targetFile.isEmpty())
+		return false;
+
+	if (!data && !LoadFile())
+		return false;
+
+	// The old to new table is indexed by full domain node number, so walking it
+	// gives the subdomain's full domain node numbers in sorted order
+	const std::vector<unsigned int> &oldToNew = py140->GetOldToNew();
+	std::vector<unsigned int> oldNodes;
+	oldNodes.reserve(py140->GetNumNodes());
+	for (unsigned int i=0; i<oldToNew.size(); ++i)
+		if (oldToNew[i] != Py140::NoNode)
+			oldNodes.push_back(i);
+
+	unsigned int numThreads = std::max(QThread::idealThreadCount(), 1);
+	unsigned int numRanges = std::min(4*numThreads, (unsigned int)oldNodes.size()/4096 + 1);
+	std::vector<CarveChunk> chunks;
+	for (unsigned int i=0; i<sections.size(); ++i)
+	{
+		for (unsigned int j=0; j<numRanges; ++j)
+		{
+			CarveChunk chunk;
+			chunk.section = &sections[i];
+			chunk.data = data;
+			chunk.oldNodes = oldNodes.empty() ? 0 : &oldNodes[0];
+			chunk.begin = (quint64)oldNodes.size()*j/numRanges;
+			chunk.end = (quint64)oldNodes.size()*(j+1)/numRanges;
+			chunk.oldToNew = oldToNew.empty() ? 0 : &oldToNew[0];
+			chunk.numLines = 0;
+			chunks.push_back(chunk);
+		}
+	}
+
+	if (chunks.size() == 1)
+		CarveLines(chunks[0]);
+	else if (chunks.size() > 1)
+		QtConcurrent::blockingMap(chunks, CarveLines);
+
+	std::ofstream out (targetFile.toStdString().data(), std::ios::out | std::ios::binary);
+	if (!out.is_open())
+	{
+		std::cout << "Unable to write subdomain fort.13: " << targetFile.toStdString() << std::endl;
+		return false;
+	}
+
+	WriteLines(out, 0, headerEnd);
+	out << py140->GetNumNodes() << '\n';
+	WriteLines(out, propertiesStart, propertiesEnd);
+
+	for (unsigned int i=0; i<sections.size(); ++i)
+	{
+		unsigned int numLines = 0;
+		for (unsigned int j=0; j<numRanges; ++j)
+			numLines += chunks[i*numRanges + j].numLines;
+
+		WriteLines(out, sections[i].nameStart, sections[i].nameEnd);
+		out << numLines << '\n';
+		for (unsigned int j=0; j<numRanges; ++j)
+		{
+			const std::vector<char> &output = chunks[i*numRanges + j].output;
+			if (!output.empty())
+				out.write(&output[0], output.size());
+		}
+	}
+
+	out.close();
+	return true;
+}
+
+
+/**
+ * @brief Maps the full domain file into memory, or reads it if it can't be mapped
+ */
+bool Fort13Carver::OpenFile()
+{
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	dataSize = file.size();
+	if (dataSize <= 0)
+		return false;
+
+	mappedData = file.map(0, dataSize);
+	if (mappedData)
+	{
+		data = (const char*)mappedData;
+	} else {
+		fileContents = file.readAll();
+		data = fileContents.constData();
+		dataSize = fileContents.size();
+	}
+	return data != 0;
+}
+
+
+/**
+ * @brief Scans the file once to find the property lines and the byte range of
+ * each attribute's non-default lines
+ */
+bool Fort13Carver::FindSections()
+{
+	sections.clear();
+
+	headerEnd = NextLine(0);
+	propertiesStart = NextLine(headerEnd);
+
+	unsigned int numAttributes = 0;
+	if (!ReadCount(propertiesStart, &numAttributes))
+		return false;
+
+	qint64 pos = NextLine(propertiesStart);
+	for (unsigned int i=0; i<4*numAttributes; ++i)
+		pos = NextLine(pos);
+	propertiesEnd = pos;
+
+	for (unsigned int i=0; i<numAttributes && pos < dataSize; ++i)
+	{
+		Fort13Section section;
+		section.nameStart = pos;
+		section.nameEnd = NextLine(pos);
+		if (!ReadCount(section.nameEnd, &section.numLines))
+			return false;
+		section.linesStart = NextLine(section.nameEnd);
+
+		pos = section.linesStart;
+		for (unsigned int j=0; j<section.numLines && pos < dataSize; ++j)
+			pos = NextLine(pos);
+		section.linesEnd = pos;
+
+		sections.push_back(section);
+	}
+
+	return sections.size() == numAttributes;
+}
+
+
+/**
+ * @brief Parses the node number of every non-default line and sorts each
+ * attribute's lines by node number
+ */
+bool Fort13Carver::BuildIndex()
+{
+	if (!FindSections())
+		return false;
+
+	// Cut every attribute's non-default lines into line aligned pieces
+	std::vector<IndexPiece> pieces;
+	for (unsigned int i=0; i<sections.size(); ++i)
+	{
+		qint64 begin = sections[i].linesStart;
+		while (begin < sections[i].linesEnd)
+		{
+			qint64 end = begin + PieceSize;
+			if (end >= sections[i].linesEnd)
+				end = sections[i].linesEnd;
+			else
+				end = NextLine(end-1);
+
+			IndexPiece piece;
+			piece.section = i;
+			piece.data = data;
+			piece.begin = begin;
+			piece.end = end;
+			pieces.push_back(piece);
+
+			begin = end;
+		}
+	}
+
+	if (pieces.size() == 1)
+		IndexLines(pieces[0]);
+	else if (pieces.size() > 1)
+		QtConcurrent::blockingMap(pieces, IndexLines);
+
+	for (unsigned int i=0; i<pieces.size(); ++i)
+	{
+		std::vector<Fort13IndexEntry> &entries = sections[pieces[i].section].entries;
+		entries.insert(entries.end(), pieces[i].entries.begin(), pieces[i].entries.end());
+	}
+
+	// Most fort.13 files list nodes in order already
+	for (unsigned int i=0; i<sections.size(); ++i)
+	{
+		std::vector<Fort13IndexEntry> &entries = sections[i].entries;
+		for (unsigned int j=1; j<entries.size(); ++j)
+		{
+			if (entries[j].node < entries[j-1].node)
+			{
+				std::stable_sort(entries.begin(), entries.end(), EntryBeforeEntry);
+				break;
+			}
+		}
+	}
+
+	SaveIndex();
+	return true;
+}
+
+
+/**
+ * @brief Reads the index file, if it was written for the current fort.13 file
+ */
+bool Fort13Carver::LoadIndex()
+{
+	if (indexPath.isEmpty())
+		return false;
+
+	std::ifstream index (indexPath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!index.is_open())
+		return false;
+
+	char magic[8];
+	quint32 version = 0;
+	qint64 fileSize = 0, fileModified = 0;
+	quint32 numSections = 0;
+	index.read(magic, sizeof(magic));
+	index.read((char*)&version, sizeof(version));
+	index.read((char*)&fileSize, sizeof(fileSize));
+	index.read((char*)&fileModified, sizeof(fileModified));
+	if (!index || memcmp(magic, IndexMagic, sizeof(magic)) != 0 || version != IndexVersion ||
+	    fileSize != dataSize || fileModified != QFileInfo(file).lastModified().toMSecsSinceEpoch())
+		return false;
+
+	index.read((char*)&headerEnd, sizeof(headerEnd));
+	index.read((char*)&propertiesStart, sizeof(propertiesStart));
+	index.read((char*)&propertiesEnd, sizeof(propertiesEnd));
+	index.read((char*)&numSections, sizeof(numSections));
+
+	sections.assign(numSections, Fort13Section());
+	for (unsigned int i=0; i<numSections && index; ++i)
+	{
+		quint64 numEntries = 0;
+		index.read((char*)&sections[i].nameStart, sizeof(qint64));
+		index.read((char*)&sections[i].nameEnd, sizeof(qint64));
+		index.read((char*)&numEntries, sizeof(numEntries));
+		if (!index || numEntries > (quint64)dataSize)
+			break;
+
+		sections[i].linesStart = sections[i].linesEnd = 0;
+		sections[i].numLines = numEntries;
+		sections[i].entries.resize(numEntries);
+		if (numEntries)
+			index.read((char*)&sections[i].entries[0], numEntries*sizeof(Fort13IndexEntry));
+	}
+
+	for (unsigned int i=0; i<sections.size() && index; ++i)
+		for (unsigned int j=0; j<sections[i].entries.size(); ++j)
+			if (sections[i].entries[j].offset < 0 || sections[i].entries[j].offset + sections[i].entries[j].length > dataSize)
+				index.setstate(std::ios::failbit);
+
+	if (!index)
+	{
+		sections.clear();
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Writes the index file, tagged with the size and modification time of
+ * the fort.13 file
+ */
+void Fort13Carver::SaveIndex()
+{
+	if (indexPath.isEmpty())
+		return;
+
+	std::ofstream index (indexPath.toStdString().data(), std::ios::out | std::ios::binary);
+	if (!index.is_open())
+	{
+		std::cout << "Unable to write fort.13 index: " << indexPath.toStdString() << std::endl;
+		return;
+	}
+
+	qint64 fileModified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+	quint32 numSections = sections.size();
+	index.write(IndexMagic, sizeof(IndexMagic));
+	index.write((const char*)&IndexVersion, sizeof(IndexVersion));
+	index.write((const char*)&dataSize, sizeof(dataSize));
+	index.write((const char*)&fileModified, sizeof(fileModified));
+	index.write((const char*)&headerEnd, sizeof(headerEnd));
+	index.write((const char*)&propertiesStart, sizeof(propertiesStart));
+	index.write((const char*)&propertiesEnd, sizeof(propertiesEnd));
+	index.write((const char*)&numSections, sizeof(numSections));
+	for (unsigned int i=0; i<sections.size(); ++i)
+	{
+		quint64 numEntries = sections[i].entries.size();
+		index.write((const char*)&sections[i].nameStart, sizeof(qint64));
+		index.write((const char*)&sections[i].nameEnd, sizeof(qint64));
+		index.write((const char*)&numEntries, sizeof(numEntries));
+		if (numEntries)
+			index.write((const char*)&sections[i].entries[0], numEntries*sizeof(Fort13IndexEntry));
+	}
+	index.close();
+}
+
+
+/**
+ * @brief Returns the start of the line after the one at pos
+ */
+qint64 Fort13Carver::NextLine(qint64 pos)
+{
+	if (pos >= dataSize)
+		return dataSize;
+	const char *lineEnd = (const char*)memchr(data + pos, '\n', dataSize - pos);
+	return lineEnd ? lineEnd - data + 1 : dataSize;
+}
+
+
+/**
+ * @brief Reads the number at the start of the line at pos
+ */
+bool Fort13Carver::ReadCount(qint64 pos, unsigned int *count)
+{
+	while (pos < dataSize && (data[pos] == ' ' || data[pos] == '\t'))
+		++pos;
+
+	qint64 start = pos;
+	unsigned int value = 0;
+	while (pos < dataSize && data[pos] >= '0' && data[pos] <= '9')
+		value = 10*value + (data[pos++] - '0');
+
+	*count = value;
+	return pos != start;
+}
+
+
+/**
+ * @brief Copies lines from the full domain file, making sure the last one ends
+ * with a newline
+ */
+void Fort13Carver::WriteLines(std::ofstream &out, qint64 begin, qint64 end)
+{
+	if (end <= begin)
+		return;
+	out.write(data + begin, end - begin);
+	if (data[end-1] != '\n')
+		out << '\n';
+}
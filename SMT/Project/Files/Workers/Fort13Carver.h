@@ -0,0 +1,98 @@
+#ifndef FORT13CARVER_H
+#define FORT13CARVER_H
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QByteArray>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include "Project/Files/Py140.h"
+
+
+/**
+ * @brief The location of one non-default line in a fort.13 file
+ */
+struct Fort13IndexEntry
+{
+		quint32		node;		/**< The full domain node number at the start of the line */
+		quint32		length;		/**< Length of the rest of the line, without the newline */
+		qint64		offset;		/**< Start of the rest of the line, right after the node number */
+};
+
+
+/**
+ * @brief The byte range of one attribute's non-default section in a fort.13 file
+ */
+struct Fort13Section
+{
+		qint64				nameStart;	/**< Start of the attribute name line */
+		qint64				nameEnd;	/**< End of the attribute name line (including its newline) */
+		qint64				linesStart;	/**< Start of the first non-default line */
+		qint64				linesEnd;	/**< End of the last non-default line (including its newline) */
+		unsigned int			numLines;	/**< Number of non-default lines */
+		std::vector<Fort13IndexEntry>	entries;	/**< The non-default lines, sorted by node number */
+};
+
+
+/**
+ * @brief Writes a subdomain fort.13 file straight from the full domain fort.13
+ *
+ * The full domain file is mapped into memory and indexed once: for every
+ * attribute, the node number, offset and length of each non-default line is
+ * stored in a list sorted by node number. The index is saved to a file (usually
+ * in the project directory) along with the size and modification time of the
+ * fort.13, so later subdomains can skip the parsing entirely as long as the
+ * fort.13 hasn't changed.
+ *
+ * Carving a subdomain is then a merge of the subdomain's sorted full domain node
+ * numbers against each attribute's index, done on several threads. Lines for
+ * nodes in the subdomain get the new node number, followed by the rest of the
+ * line's bytes unchanged. The header and attribute property lines are copied over
+ * as they are, except for the number of nodes.
+ *
+ * Once LoadFile() has been called, CarveSubdomain() only reads the carver's
+ * state, so several subdomains can be carved at the same time.
+ *
+ */
+class Fort13Carver
+{
+	public:
+		Fort13Carver(QString fullDomainFile, QString indexFile = QString());
+		~Fort13Carver();
+
+		bool	LoadFile();
+		bool	CarveSubdomain(Py140 *py140, QString targetFile);
+
+	private:
+
+		QFile				file;
+		QString				indexPath;
+		const char*			data;		/**< The mapped file, or the contents of fileContents */
+		qint64				dataSize;
+		uchar*				mappedData;
+		QByteArray			fileContents;	/**< Used when the file can't be mapped */
+
+		qint64				headerEnd;		/**< End of the header line */
+		qint64				propertiesStart;	/**< Start of the number of attributes line */
+		qint64				propertiesEnd;		/**< End of the last attribute property line */
+		std::vector<Fort13Section>	sections;
+
+		bool	OpenFile();
+		bool	FindSections();
+		bool	BuildIndex();
+		bool	LoadIndex();
+		void	SaveIndex();
+		qint64	NextLine(qint64 pos);
+		bool	ReadCount(qint64 pos, unsigned int *count);
+		void	WriteLines(std::ofstream &out, qint64 begin, qint64 end);
+};
+
+#endif // FORT13CARVER_H
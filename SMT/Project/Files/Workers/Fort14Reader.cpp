@@ -193,6 +193,7 @@ bool Fort14Reader::ReadNodalData(int numNodes, std::ifstream *fileStream)
 	maxX = maxY = maxZ -99999.0;
 
 	Node currNode;
+	currNode.maxele = 0.0;
 	std::string currLine;
 	for (int i=0; i<numNodes; ++i)
 	{
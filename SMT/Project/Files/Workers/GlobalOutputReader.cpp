@@ -0,0 +1,284 @@
+#include "GlobalOutputReader.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GLOBALOUTPUT_SSE2
+#include <emmintrin.h>
+#endif
+
+
+const float GlobalOutputReader::DryValue = -99999.0;
+
+/*
+ * The node lines are split into ranges of at least this many bytes for parsing
+ */
+static const quint64 MinRangeSize = 64*1024;
+
+/*
+ * The values are split into chunks of at least this many values for the statistics
+ */
+static const size_t MinStatsChunkSize = 16*1024;
+
+/*
+ * Values at or below this are dry
+ */
+static const float DryLimit = GlobalOutputReader::DryValue + 0.5f;
+
+
+/*
+ * A range of node lines, parsed on one thread
+ */
+struct ParseRange
+{
+		const char	*start;
+		const char	*end;
+		unsigned int	numNodes;
+		float		*values;
+		unsigned int	numParsed;
+		bool		success;
+};
+
+
+/*
+ * A chunk of values, checked for dry nodes and summarized on one thread
+ */
+struct StatsChunk
+{
+		float		*values;
+		size_t		count;
+		float		dryReplacement;
+		float		minWet;
+		float		maxWet;
+		double		sumWet;
+		unsigned int	numDry;
+};
+
+
+static void ParseLines(ParseRange &range)
+{
+	range.numParsed = 0;
+	range.success = true;
+
+	const char *pos = range.start;
+	while (pos < range.end)
+	{
+		double node, value;
+		if (!AsciiNumberParser::ParseNumber(pos, range.end, &node))
+		{
+			pos = AsciiNumberParser::SkipLine(pos, range.end);
+			continue;
+		}
+
+		unsigned int nodeNumber = (unsigned int)node;
+		if (nodeNumber < 1 || nodeNumber > range.numNodes || !AsciiNumberParser::ParseNumber(pos, range.end, &value))
+		{
+			range.success = false;
+			return;
+		}
+		range.values[nodeNumber-1] = value;
+		++range.numParsed;
+		pos = AsciiNumberParser::SkipLine(pos, range.end);
+	}
+}
+
+
+/*
+ * Replaces the dry values of a chunk and finds the range and sum of the wet
+ * ones. The SSE2 version works on four values at a time, using masks instead
+ * of branches for the dry test.
+ */
+static void GatherChunkStats(StatsChunk &chunk)
+{
+	const float Largest = std::numeric_limits<float>::max();
+	float *values = chunk.values;
+	size_t i = 0;
+
+	chunk.minWet = Largest;
+	chunk.maxWet = -Largest;
+	chunk.sumWet = 0.0;
+	chunk.numDry = 0;
+
+#ifdef GLOBALOUTPUT_SSE2
+	const __m128 dryLimit = _mm_set1_ps(DryLimit);
+	const __m128 replacement = _mm_set1_ps(chunk.dryReplacement);
+	const __m128 largest = _mm_set1_ps(Largest);
+	const __m128 smallest = _mm_set1_ps(-Largest);
+	__m128 minimum = largest;
+	__m128 maximum = smallest;
+	__m128i dryCount = _mm_setzero_si128();
+	float lanes[4];
+
+	// Sums are kept in single precision for one block at a time
+	const size_t BlockSize = 4096;
+	while (i + 4 <= chunk.count)
+	{
+		size_t blockEnd = std::min(chunk.count - chunk.count%4, i + BlockSize);
+		__m128 sum = _mm_setzero_ps();
+		for (; i < blockEnd; i += 4)
+		{
+			__m128 value = _mm_loadu_ps(values + i);
+			__m128 dry = _mm_cmple_ps(value, dryLimit);
+			__m128 wet = _mm_andnot_ps(dry, value);
+			minimum = _mm_min_ps(minimum, _mm_or_ps(wet, _mm_and_ps(dry, largest)));
+			maximum = _mm_max_ps(maximum, _mm_or_ps(wet, _mm_and_ps(dry, smallest)));
+			sum = _mm_add_ps(sum, wet);
+			dryCount = _mm_sub_epi32(dryCount, _mm_castps_si128(dry));
+			_mm_storeu_ps(values + i, _mm_or_ps(wet, _mm_and_ps(dry, replacement)));
+		}
+		_mm_storeu_ps(lanes, sum);
+		chunk.sumWet += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+
+	_mm_storeu_ps(lanes, minimum);
+	chunk.minWet = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+	_mm_storeu_ps(lanes, maximum);
+	chunk.maxWet = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+	int counts[4];
+	_mm_storeu_si128((__m128i*)counts, dryCount);
+	chunk.numDry = counts[0] + counts[1] + counts[2] + counts[3];
+#endif
+
+	for (; i < chunk.count; ++i)
+	{
+		if (values[i] <= DryLimit)
+		{
+			values[i] = chunk.dryReplacement;
+			++chunk.numDry;
+		} else {
+			chunk.minWet = std::min(chunk.minWet, values[i]);
+			chunk.maxWet = std::max(chunk.maxWet, values[i]);
+			chunk.sumWet += values[i];
+		}
+	}
+}
+
+
+/**
+ * @brief Reads the first data set of a global output file
+ * @param filePath The file to read
+ * @param dryReplacement The value stored for nodes that were never wet
+ * @param headerLine Set to the first line of the file
+ * @param values Set to the value of every node, in node number order
+ * @param stats Set to the statistics of the values
+ * @return false if the file can't be read or doesn't have a line for every node
+ */
+bool GlobalOutputReader::ReadFile(QString filePath, float dryReplacement, std::string *headerLine,
+				  std::vector<float> *values, GlobalOutputStats *stats)
+{
+	QFile file (filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	quint64 dataSize = file.size();
+	const char *data = (const char*)file.map(0, dataSize);
+	if (!data)
+	{
+		std::cout << "Unable to map " << filePath.toStdString() << " into memory" << std::endl;
+		return false;
+	}
+	const char *end = data + dataSize;
+
+	const char *pos = AsciiNumberParser::SkipLine(data, end);
+	const char *headerEnd = pos;
+	while (headerEnd > data && (headerEnd[-1] == '\n' || headerEnd[-1] == '\r'))
+		--headerEnd;
+	headerLine->assign(data, headerEnd);
+
+	const char *infoEnd = AsciiNumberParser::SkipLine(pos, end);
+	double numDataSets = 0.0;
+	double fileNodes = 0.0;
+	if (!AsciiNumberParser::ParseNumber(pos, infoEnd, &numDataSets) || !AsciiNumberParser::ParseNumber(pos, infoEnd, &fileNodes) || fileNodes < 1.0)
+	{
+		file.unmap((uchar*)data);
+		return false;
+	}
+	unsigned int numNodes = (unsigned int)fileNodes;
+
+	// Skip the time line, then find where the first data set ends
+	const char *nodesStart = AsciiNumberParser::SkipLine(infoEnd, end);
+	const char *nodesEnd = nodesStart;
+	for (unsigned int i=0; i<numNodes && nodesEnd < end; ++i)
+		nodesEnd = AsciiNumberParser::SkipLine(nodesEnd, end);
+
+	values->assign(numNodes, DryValue);
+	quint64 numBytes = nodesEnd - nodesStart;
+	unsigned int numRanges = std::min((quint64)(4*std::max(QThread::idealThreadCount(), 1)), numBytes/MinRangeSize + 1);
+	std::vector<ParseRange> ranges (numRanges);
+	const char *rangeStart = nodesStart;
+	for (unsigned int i=0; i<numRanges; ++i)
+	{
+		const char *rangeEnd = i+1 == numRanges ? nodesEnd : AsciiNumberParser::SkipLine(nodesStart + numBytes*(i+1)/numRanges, nodesEnd);
+		ranges[i].start = rangeStart;
+		ranges[i].end = std::max(rangeStart, rangeEnd);
+		ranges[i].numNodes = numNodes;
+		ranges[i].values = &(*values)[0];
+		ranges[i].numParsed = 0;
+		ranges[i].success = false;
+		rangeStart = ranges[i].end;
+	}
+	QtConcurrent::blockingMap(ranges, ParseLines);
+	file.unmap((uchar*)data);
+
+	unsigned int numParsed = 0;
+	for (unsigned int i=0; i<numRanges; ++i)
+	{
+		if (!ranges[i].success)
+		{
+			std::cout << "Unable to read the node values in " << filePath.toStdString() << std::endl;
+			values->clear();
+			return false;
+		}
+		numParsed += ranges[i].numParsed;
+	}
+	if (numParsed != numNodes)
+	{
+		std::cout << filePath.toStdString() << " has " << numParsed << " node values, expected " << numNodes << std::endl;
+		values->clear();
+		return false;
+	}
+
+	GatherStats(*values, dryReplacement, stats);
+	return true;
+}
+
+
+/**
+ * @brief Replaces the dry values with dryReplacement and gathers the
+ * statistics of the values in one parallel pass
+ */
+void GlobalOutputReader::GatherStats(std::vector<float> &values, float dryReplacement, GlobalOutputStats *stats)
+{
+	size_t numChunks = std::min((size_t)(4*std::max(QThread::idealThreadCount(), 1)), values.size()/MinStatsChunkSize + 1);
+	std::vector<StatsChunk> chunks (numChunks);
+	for (size_t i=0; i<numChunks; ++i)
+	{
+		size_t first = values.size()*i/numChunks;
+		size_t last = values.size()*(i+1)/numChunks;
+		chunks[i].values = values.empty() ? 0 : &values[first];
+		chunks[i].count = last - first;
+		chunks[i].dryReplacement = dryReplacement;
+	}
+	QtConcurrent::blockingMap(chunks, GatherChunkStats);
+
+	float minWet = std::numeric_limits<float>::max();
+	float maxWet = -std::numeric_limits<float>::max();
+	double sumWet = 0.0;
+	unsigned int numDry = 0;
+	for (size_t i=0; i<numChunks; ++i)
+	{
+		minWet = std::min(minWet, chunks[i].minWet);
+		maxWet = std::max(maxWet, chunks[i].maxWet);
+		sumWet += chunks[i].sumWet;
+		numDry += chunks[i].numDry;
+	}
+
+	unsigned int numWet = values.size() - numDry;
+	stats->numDry = numDry;
+	stats->meanValue = numWet > 0 ? sumWet/numWet : 0.0;
+	if (numWet == 0)
+	{
+		stats->minValue = stats->maxValue = dryReplacement;
+	} else {
+		stats->minValue = numDry > 0 ? std::min(minWet, dryReplacement) : minWet;
+		stats->maxValue = numDry > 0 ? std::max(maxWet, dryReplacement) : maxWet;
+	}
+}
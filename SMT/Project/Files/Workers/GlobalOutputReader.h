@@ -0,0 +1,56 @@
+#ifndef GLOBALOUTPUTREADER_H
+#define GLOBALOUTPUTREADER_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+#include <QString>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include "Project/Files/Workers/AsciiNumberParser.h"
+
+
+/**
+ * @brief Statistics of the values in a global output file, gathered while
+ * it is read
+ */
+struct GlobalOutputStats
+{
+		float		minValue;	/**< The lowest value, counting dry nodes as the dry replacement */
+		float		maxValue;	/**< The highest value, counting dry nodes as the dry replacement */
+		double		meanValue;	/**< The mean of the wet nodes */
+		unsigned int	numDry;		/**< The number of nodes that were never wet */
+};
+
+
+/**
+ * @brief Reads global output files that hold one value per node, such as
+ * maxele.63 and maxvel.63
+ *
+ * The file is memory mapped and the node lines are split into byte ranges
+ * that are parsed in parallel. The values are then checked for dry nodes and
+ * gathered into a GlobalOutputStats in one parallel pass, which uses SSE2 where
+ * it is available.
+ *
+ * Only the first data set is read, so the times of the maximums that newer
+ * versions of ADCIRC write after it are ignored.
+ *
+ */
+class GlobalOutputReader
+{
+	public:
+
+		static const float	DryValue;
+
+		static bool	ReadFile(QString filePath, float dryReplacement, std::string *headerLine,
+					 std::vector<float> *values, GlobalOutputStats *stats);
+		static void	GatherStats(std::vector<float> &values, float dryReplacement, GlobalOutputStats *stats);
+};
+
+#endif // GLOBALOUTPUTREADER_H
@@ -0,0 +1,224 @@
+#include "TimeSeriesAnimation.h"
+
+
+FramePrefetcher::FramePrefetcher(TimeSeriesReader *reader, std::vector<AnimationFrame> *frames, int *playhead, QMutex *frameLock) :
+	QObject(),
+	reader(reader),
+	frames(frames),
+	playhead(playhead),
+	frameLock(frameLock),
+	stopping(0)
+{
+}
+
+
+/**
+ * @brief Stops decoding after the current frame, from any thread
+ */
+void FramePrefetcher::Stop()
+{
+	stopping.fetchAndStoreOrdered(1);
+}
+
+
+/**
+ * @brief Decodes frames until every frame holds one of the timesteps after the
+ * playhead
+ */
+void FramePrefetcher::FillFrames()
+{
+	AnimationFrame *frame;
+	while (!stopping.fetchAndAddOrdered(0) && (frame = ClaimFrame()))
+	{
+		bool decoded = reader->ReadMagnitudes(frame->timestep, &frame->values[0], &frame->time);
+		if (decoded)
+		{
+			frame->minValue = frame->maxValue = TimeSeriesReader::DryValue;
+			for (std::vector<float>::const_iterator it = frame->values.begin(); it != frame->values.end(); ++it)
+			{
+				if (*it <= TimeSeriesReader::DryValue)
+					continue;
+				if (frame->minValue == TimeSeriesReader::DryValue || *it < frame->minValue)
+					frame->minValue = *it;
+				if (*it > frame->maxValue)
+					frame->maxValue = *it;
+			}
+		}
+
+		frameLock->lock();
+		frame->state = decoded ? AnimationFrame::Ready : AnimationFrame::Free;
+		if (!decoded)
+			frame->timestep = -1;
+		frameLock->unlock();
+
+		if (decoded)
+			emit FrameReady();
+		else
+			break;
+	}
+}
+
+
+/**
+ * @brief Frees the frames the playhead has passed, and claims a free frame
+ * for the first upcoming timestep that isn't decoded yet
+ * @return The claimed frame, marked Loading, or 0 if there is nothing to do
+ */
+AnimationFrame* FramePrefetcher::ClaimFrame()
+{
+	QMutexLocker locker (frameLock);
+
+	int numTimesteps = reader->GetNumTimesteps();
+	int numFrames = frames->size();
+	if (numTimesteps < 1)
+		return 0;
+
+	int upcoming = std::min(numFrames, numTimesteps);
+	for (int i=0; i<numFrames; ++i)
+	{
+		AnimationFrame &frame = (*frames)[i];
+		if (frame.state == AnimationFrame::Ready && (frame.timestep - *playhead + numTimesteps) % numTimesteps >= upcoming)
+			frame.state = AnimationFrame::Free;
+	}
+
+	for (int i=0; i<upcoming; ++i)
+	{
+		int timestep = (*playhead + i) % numTimesteps;
+		bool present = false;
+		for (int j=0; j<numFrames && !present; ++j)
+			present = (*frames)[j].state != AnimationFrame::Free && (*frames)[j].timestep == timestep;
+		if (present)
+			continue;
+
+		for (int j=0; j<numFrames; ++j)
+		{
+			AnimationFrame &frame = (*frames)[j];
+			if (frame.state == AnimationFrame::Free)
+			{
+				frame.state = AnimationFrame::Loading;
+				frame.timestep = timestep;
+				frame.values.resize(reader->GetNumNodes());
+				return &frame;
+			}
+		}
+		return 0;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Constructor
+ * @param reader An open reader, which must stay open until the animation is
+ * deleted
+ * @param fort14 The mesh the values are shown on
+ */
+TimeSeriesAnimation::TimeSeriesAnimation(TimeSeriesReader *reader, Fort14 *fort14, QObject *parent) :
+	QObject(parent),
+	reader(reader),
+	fort14(fort14),
+	frames(NumFrames),
+	playhead(0),
+	frameLock(),
+	timer(),
+	thread(0),
+	prefetcher(0),
+	rangeSet(false),
+	minValue(0.0),
+	maxValue(0.0)
+{
+	for (int i=0; i<NumFrames; ++i)
+	{
+		frames[i].state = AnimationFrame::Free;
+		frames[i].timestep = -1;
+		frames[i].time = 0.0;
+	}
+
+	timer.setInterval(DefaultFrameInterval);
+	connect(&timer, SIGNAL(timeout()), this, SLOT(ShowNextFrame()));
+
+	thread = new QThread();
+	prefetcher = new FramePrefetcher(reader, &frames, &playhead, &frameLock);
+	prefetcher->moveToThread(thread);
+	connect(this, SIGNAL(RequestFrames()), prefetcher, SLOT(FillFrames()));
+	connect(thread, SIGNAL(started()), prefetcher, SLOT(FillFrames()));
+}
+
+
+TimeSeriesAnimation::~TimeSeriesAnimation()
+{
+	timer.stop();
+	prefetcher->Stop();
+	thread->quit();
+	thread->wait();
+	delete prefetcher;
+	delete thread;
+}
+
+
+/**
+ * @brief Starts playing from the current playhead
+ * @return false if the file has no complete timesteps
+ */
+bool TimeSeriesAnimation::Start()
+{
+	if (!reader || !fort14 || reader->GetNumTimesteps() < 1)
+		return false;
+
+	if (!thread->isRunning())
+		thread->start();
+	timer.start();
+	return true;
+}
+
+
+/**
+ * @brief Pauses on the frame being shown
+ */
+void TimeSeriesAnimation::Stop()
+{
+	timer.stop();
+}
+
+
+void TimeSeriesAnimation::SetFrameInterval(int milliseconds)
+{
+	timer.setInterval(std::max(milliseconds, 1));
+}
+
+
+/**
+ * @brief Shows the frame at the playhead if it has been decoded, then asks
+ * for the frames after it
+ */
+void TimeSeriesAnimation::ShowNextFrame()
+{
+	int shownTimestep = -1;
+	double shownTime = 0.0;
+
+	frameLock.lock();
+	for (int i=0; i<NumFrames; ++i)
+	{
+		AnimationFrame &frame = frames[i];
+		if (frame.state != AnimationFrame::Ready || frame.timestep != playhead)
+			continue;
+
+		if (frame.maxValue > TimeSeriesReader::DryValue)
+		{
+			minValue = rangeSet ? std::min(minValue, frame.minValue) : frame.minValue;
+			maxValue = rangeSet ? std::max(maxValue, frame.maxValue) : frame.maxValue;
+			rangeSet = true;
+		}
+		fort14->SetDisplayValuesGL(frame.values, minValue, std::max(maxValue, minValue + 0.001f));
+
+		shownTimestep = frame.timestep;
+		shownTime = frame.time;
+		playhead = (playhead + 1) % reader->GetNumTimesteps();
+		break;
+	}
+	frameLock.unlock();
+
+	if (shownTimestep >= 0)
+		emit FrameShown(shownTimestep, shownTime);
+	emit RequestFrames();
+}
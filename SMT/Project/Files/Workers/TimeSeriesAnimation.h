@@ -0,0 +1,117 @@
+#ifndef TIMESERIESANIMATION_H
+#define TIMESERIESANIMATION_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QAtomicInt>
+
+#include <vector>
+#include <algorithm>
+
+#include "Project/Files/Fort14.h"
+#include "Project/Files/Workers/TimeSeriesReader.h"
+
+
+/**
+ * @brief One decoded timestep waiting to be shown
+ */
+struct AnimationFrame
+{
+		enum FrameState {Free, Loading, Ready};
+
+		FrameState		state;
+		int			timestep;
+		double			time;
+		float			minValue;	/**< The lowest value of a wet node */
+		float			maxValue;	/**< The highest value of a wet node */
+		std::vector<float>	values;
+};
+
+
+/**
+ * @brief Decodes the timesteps after the playhead into free frames on a
+ * background thread
+ *
+ * A frame being decoded is marked Loading and is only touched by the
+ * prefetcher. Every other change to the frames and the playhead is made while
+ * holding the shared lock.
+ */
+class FramePrefetcher : public QObject
+{
+		Q_OBJECT
+	public:
+		FramePrefetcher(TimeSeriesReader *reader, std::vector<AnimationFrame> *frames, int *playhead, QMutex *frameLock);
+
+		void	Stop();
+
+	private:
+
+		TimeSeriesReader*		reader;
+		std::vector<AnimationFrame>*	frames;
+		int*				playhead;
+		QMutex*				frameLock;
+		QAtomicInt			stopping;
+
+		AnimationFrame*	ClaimFrame();
+
+	signals:
+
+		void	FrameReady();
+
+	public slots:
+
+		void	FillFrames();
+};
+
+
+/**
+ * @brief Plays a time series over the mesh of a domain
+ *
+ * A timer shows the frame at the playhead and moves the playhead forward,
+ * looping at the end of the file, while a FramePrefetcher keeps the next few
+ * frames decoded. If the next frame isn't ready in time, the current one stays
+ * on screen. The color range starts at the range of the first frame and grows
+ * as higher or lower values are shown, so colors mean the same thing from one
+ * frame to the next.
+ */
+class TimeSeriesAnimation : public QObject
+{
+		Q_OBJECT
+	public:
+		TimeSeriesAnimation(TimeSeriesReader *reader, Fort14 *fort14, QObject *parent=0);
+		~TimeSeriesAnimation();
+
+		static const int	NumFrames = 4;
+		static const int	DefaultFrameInterval = 33;
+
+		bool	Start();
+		void	Stop();
+		void	SetFrameInterval(int milliseconds);
+
+	private:
+
+		TimeSeriesReader*		reader;
+		Fort14*				fort14;
+		std::vector<AnimationFrame>	frames;
+		int				playhead;	/**< The next timestep to show */
+		QMutex				frameLock;
+		QTimer				timer;
+		QThread*			thread;
+		FramePrefetcher*		prefetcher;
+		bool				rangeSet;
+		float				minValue;
+		float				maxValue;
+
+	signals:
+
+		void	RequestFrames();
+		void	FrameShown(int timestep, double time);
+
+	private slots:
+
+		void	ShowNextFrame();
+};
+
+#endif // TIMESERIESANIMATION_H
@@ -0,0 +1,262 @@
+#include "TimeSeriesReader.h"
+
+
+const float TimeSeriesReader::DryValue = -99999.0;
+
+/*
+ * Timesteps are split into ranges of at least this many bytes for decoding
+ */
+static const quint64 MinRangeSize = 64*1024;
+
+
+/*
+ * A range of node lines in one timestep, decoded on one thread
+ */
+struct DecodeRange
+{
+		const char	*start;
+		const char	*end;
+		unsigned int	numNodes;
+		unsigned int	valuesPerNode;
+		bool		magnitudes;
+		float		*values;
+		unsigned int	numDecoded;	/**< The number of node lines found in the range */
+		bool		success;
+};
+
+
+static void DecodeLines(DecodeRange &range)
+{
+	range.numDecoded = 0;
+	range.success = true;
+
+	double lineValues[8];
+	const char *pos = range.start;
+	while (pos < range.end)
+	{
+		double node;
+		if (!AsciiNumberParser::ParseNumber(pos, range.end, &node))
+		{
+			// Blank lines are skipped
+			pos = AsciiNumberParser::SkipLine(pos, range.end);
+			continue;
+		}
+
+		unsigned int nodeNumber = (unsigned int)node;
+		if (nodeNumber < 1 || nodeNumber > range.numNodes)
+		{
+			range.success = false;
+			return;
+		}
+		for (unsigned int i=0; i<range.valuesPerNode; ++i)
+		{
+			if (!AsciiNumberParser::ParseNumber(pos, range.end, &lineValues[i]))
+			{
+				range.success = false;
+				return;
+			}
+		}
+
+		if (range.magnitudes)
+		{
+			double sum = 0.0;
+			for (unsigned int i=0; i<range.valuesPerNode; ++i)
+				sum += lineValues[i]*lineValues[i];
+			range.values[nodeNumber-1] = lineValues[0] <= TimeSeriesReader::DryValue ? TimeSeriesReader::DryValue : sqrt(sum);
+		} else {
+			for (unsigned int i=0; i<range.valuesPerNode; ++i)
+				range.values[(nodeNumber-1)*range.valuesPerNode + i] = lineValues[i];
+		}
+
+		++range.numDecoded;
+		pos = AsciiNumberParser::SkipLine(pos, range.end);
+	}
+}
+
+
+/**
+ * @brief Constructor
+ * @param valuesPerNode 1 for fort.63 files, 2 for fort.64 files
+ */
+TimeSeriesReader::TimeSeriesReader(unsigned int valuesPerNode) :
+	file(),
+	data(0),
+	dataSize(0),
+	valuesPerNode(std::min(std::max(valuesPerNode, 1u), 8u)),
+	numNodes(0),
+	index()
+{
+}
+
+
+TimeSeriesReader::~TimeSeriesReader()
+{
+	Close();
+}
+
+
+/**
+ * @brief Maps the file, reads its header and loads its timestep index
+ *
+ * The second line of the header holds the number of timesteps and the
+ * number of nodes. If the file is still being written, only the timesteps
+ * that are complete can be read.
+ */
+bool TimeSeriesReader::Open(QString filePath)
+{
+	Close();
+	file.setFileName(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	dataSize = file.size();
+	data = (const char*)file.map(0, dataSize);
+	if (!data)
+	{
+		std::cout << "Unable to map " << filePath.toStdString() << " into memory" << std::endl;
+		Close();
+		return false;
+	}
+
+	const char *end = data + dataSize;
+	const char *pos = AsciiNumberParser::SkipLine(data, end);
+	const char *infoEnd = AsciiNumberParser::SkipLine(pos, end);
+	double fileTimesteps = 0.0;
+	double fileNodes = 0.0;
+	if (!AsciiNumberParser::ParseNumber(pos, infoEnd, &fileTimesteps) || !AsciiNumberParser::ParseNumber(pos, infoEnd, &fileNodes) || fileNodes < 1.0)
+	{
+		Close();
+		return false;
+	}
+	numNodes = (unsigned int)fileNodes;
+
+	// A sparse file has the number of values and the default value after the
+	// time and iteration of each timestep
+	const char *timeLineEnd = AsciiNumberParser::SkipLine(infoEnd, end);
+	double value;
+	unsigned int numTimeValues = 0;
+	for (pos = infoEnd; AsciiNumberParser::ParseNumber(pos, timeLineEnd, &value); ++numTimeValues);
+	if (numTimeValues > 2)
+	{
+		std::cout << filePath.toStdString() << " is in the sparse format, which can't be read" << std::endl;
+		Close();
+		return false;
+	}
+
+	// The count in the header isn't updated if the run stopped early, so an
+	// upper bound is used if it is missing
+	unsigned int numTimesteps = fileTimesteps >= 1.0 ? (unsigned int)fileTimesteps : dataSize/(2*(numNodes + 1)) + 1;
+	if (!index.Load(filePath, 2, numNodes + 1, numTimesteps))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+
+void TimeSeriesReader::Close()
+{
+	if (data)
+		file.unmap((uchar*)data);
+	if (file.isOpen())
+		file.close();
+	data = 0;
+	dataSize = 0;
+	numNodes = 0;
+	index.Clear();
+}
+
+
+bool TimeSeriesReader::IsOpen()
+{
+	return data != 0;
+}
+
+
+unsigned int TimeSeriesReader::GetNumNodes()
+{
+	return numNodes;
+}
+
+
+/**
+ * @brief Returns the number of complete timesteps in the file
+ */
+unsigned int TimeSeriesReader::GetNumTimesteps()
+{
+	return index.GetNumTimesteps();
+}
+
+
+unsigned int TimeSeriesReader::GetValuesPerNode()
+{
+	return valuesPerNode;
+}
+
+
+/**
+ * @brief Decodes a timestep
+ * @param timestep The timestep, counting from 0
+ * @param values Filled with GetValuesPerNode() values for every node, in node
+ * number order. Dry nodes are DryValue.
+ * @param time Set to the model time of the timestep
+ * @return false if the file has no such timestep or it can't be read
+ */
+bool TimeSeriesReader::ReadTimestep(unsigned int timestep, float *values, double *time)
+{
+	return DecodeTimestep(timestep, values, time, false);
+}
+
+
+/**
+ * @brief Decodes a timestep into the magnitude of the values of each node,
+ * such as the speed from the velocity components of a fort.64 file
+ * @param values Filled with one value for every node
+ */
+bool TimeSeriesReader::ReadMagnitudes(unsigned int timestep, float *values, double *time)
+{
+	return DecodeTimestep(timestep, values, time, valuesPerNode > 1);
+}
+
+
+bool TimeSeriesReader::DecodeTimestep(unsigned int timestep, float *values, double *time, bool magnitudes)
+{
+	if (!data || timestep >= index.GetNumTimesteps())
+		return false;
+
+	const char *pos = data + index.GetOffset(timestep);
+	const char *end = data + index.GetEndOffset(timestep);
+	const char *timeLineEnd = AsciiNumberParser::SkipLine(pos, end);
+	if (!AsciiNumberParser::ParseNumber(pos, timeLineEnd, time))
+		return false;
+
+	// Split the node lines into ranges that each start at the beginning of a line
+	quint64 numBytes = end - timeLineEnd;
+	unsigned int numRanges = std::min((quint64)(4*std::max(QThread::idealThreadCount(), 1)), numBytes/MinRangeSize + 1);
+	std::vector<DecodeRange> ranges (numRanges);
+	const char *rangeStart = timeLineEnd;
+	for (unsigned int i=0; i<numRanges; ++i)
+	{
+		const char *rangeEnd = i+1 == numRanges ? end : AsciiNumberParser::SkipLine(timeLineEnd + numBytes*(i+1)/numRanges, end);
+		ranges[i].start = rangeStart;
+		ranges[i].end = std::max(rangeStart, rangeEnd);
+		ranges[i].numNodes = numNodes;
+		ranges[i].valuesPerNode = valuesPerNode;
+		ranges[i].magnitudes = magnitudes;
+		ranges[i].values = values;
+		ranges[i].numDecoded = 0;
+		ranges[i].success = false;
+		rangeStart = ranges[i].end;
+	}
+	QtConcurrent::blockingMap(ranges, DecodeLines);
+
+	unsigned int numDecoded = 0;
+	for (unsigned int i=0; i<numRanges; ++i)
+	{
+		if (!ranges[i].success)
+			return false;
+		numDecoded += ranges[i].numDecoded;
+	}
+	return numDecoded == numNodes;
+}
@@ -0,0 +1,65 @@
+#ifndef TIMESERIESREADER_H
+#define TIMESERIESREADER_H
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include <QString>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include "Project/Files/Workers/TimestepIndex.h"
+#include "Project/Files/Workers/AsciiNumberParser.h"
+
+
+/**
+ * @brief Reads the timesteps of an ADCIRC ASCII time series file (fort.63 or
+ * fort.64) by timestep number
+ *
+ * The file is memory mapped and its timesteps are found with a TimestepIndex,
+ * so any timestep can be decoded without reading the ones before it. Each
+ * timestep is split into byte ranges that are decoded in parallel, and the
+ * values are placed by node number, so the ranges don't need to know which
+ * line they start on.
+ *
+ * Only the full format is supported, where every timestep has a line for
+ * every node. Sparse files are rejected when they are opened.
+ *
+ * Once the file is open, several threads can decode timesteps at once.
+ *
+ */
+class TimeSeriesReader
+{
+	public:
+		TimeSeriesReader(unsigned int valuesPerNode);
+		~TimeSeriesReader();
+
+		static const float	DryValue;
+
+		bool		Open(QString filePath);
+		void		Close();
+		bool		IsOpen();
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumTimesteps();
+		unsigned int	GetValuesPerNode();
+		bool		ReadTimestep(unsigned int timestep, float *values, double *time);
+		bool		ReadMagnitudes(unsigned int timestep, float *values, double *time);
+
+	private:
+
+		QFile		file;
+		const char*	data;		/**< The mapped file */
+		quint64		dataSize;
+		unsigned int	valuesPerNode;
+		unsigned int	numNodes;
+		TimestepIndex	index;
+
+		bool	DecodeTimestep(unsigned int timestep, float *values, double *time, bool magnitudes);
+};
+
+#endif // TIMESERIESREADER_H
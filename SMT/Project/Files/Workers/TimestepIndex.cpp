@@ -0,0 +1,217 @@
+#include "TimestepIndex.h"
+
+
+static const char IndexMagic[8] = {'S', 'M', 'T', 'I', 'N', 'D', 'E', 'X'};
+static const unsigned int IndexByteOrder = 0x01020304;
+static const size_t ScanBlockSize = 4*1024*1024;
+
+
+TimestepIndex::TimestepIndex() :
+	offsets(),
+	headerLines(0),
+	linesPerTimestep(0)
+{
+}
+
+
+/**
+ * @brief Loads the index of a file from its index file, or builds and saves it
+ * @param filePath The output file
+ * @param headerLines The number of lines before the first timestep
+ * @param linesPerTimestep The number of lines in each timestep, including its time line
+ * @param numTimesteps The number of timesteps given in the file's header
+ * @return true if at least one timestep was found
+ */
+bool TimestepIndex::Load(QString filePath, unsigned int headerLines, unsigned int linesPerTimestep, unsigned int numTimesteps)
+{
+	Clear();
+	if (linesPerTimestep == 0)
+		return false;
+
+	this->headerLines = headerLines;
+	this->linesPerTimestep = linesPerTimestep;
+
+	QFileInfo info (filePath);
+	if (!info.exists())
+		return false;
+
+	QString indexPath = filePath + ".index";
+	if (ReadIndexFile(indexPath, info) && GetNumTimesteps() >= numTimesteps)
+		return true;
+
+	offsets.clear();
+	if (!BuildIndex(filePath, numTimesteps))
+	{
+		offsets.clear();
+		return false;
+	}
+
+	if (!WriteIndexFile(indexPath, info))
+		std::cout << "Unable to save the timestep index " << indexPath.toStdString() << std::endl;
+	return true;
+}
+
+
+void TimestepIndex::Clear()
+{
+	offsets.clear();
+	headerLines = 0;
+	linesPerTimestep = 0;
+}
+
+
+bool TimestepIndex::IsLoaded()
+{
+	return !offsets.empty();
+}
+
+
+/**
+ * @brief Returns the number of complete timesteps in the file
+ */
+unsigned int TimestepIndex::GetNumTimesteps()
+{
+	return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+
+/**
+ * @brief Returns the offset of the first line of a timestep (0-based)
+ */
+quint64 TimestepIndex::GetOffset(unsigned int timestep)
+{
+	return timestep < offsets.size() ? offsets[timestep] : 0;
+}
+
+
+/**
+ * @brief Returns the offset just past the last line of a timestep (0-based)
+ */
+quint64 TimestepIndex::GetEndOffset(unsigned int timestep)
+{
+	return timestep + 1 < offsets.size() ? offsets[timestep + 1] : 0;
+}
+
+
+/**
+ * @brief Reads a saved index, which is only used if it was built for the
+ * current version of the file with the same layout
+ */
+bool TimestepIndex::ReadIndexFile(QString indexPath, QFileInfo &info)
+{
+	std::ifstream file (indexPath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	char magic[8];
+	unsigned int byteOrder, savedHeaderLines, savedLinesPerTimestep, numOffsets;
+	quint64 fileSize;
+	qint64 modified;
+	file.read(magic, sizeof(magic));
+	file.read((char*)&byteOrder, sizeof(byteOrder));
+	file.read((char*)&fileSize, sizeof(fileSize));
+	file.read((char*)&modified, sizeof(modified));
+	file.read((char*)&savedHeaderLines, sizeof(savedHeaderLines));
+	file.read((char*)&savedLinesPerTimestep, sizeof(savedLinesPerTimestep));
+	file.read((char*)&numOffsets, sizeof(numOffsets));
+	if (!file.good() ||
+	    memcmp(magic, IndexMagic, sizeof(magic)) != 0 ||
+	    byteOrder != IndexByteOrder ||
+	    fileSize != (quint64)info.size() ||
+	    modified != info.lastModified().toMSecsSinceEpoch() ||
+	    savedHeaderLines != headerLines ||
+	    savedLinesPerTimestep != linesPerTimestep ||
+	    numOffsets < 2)
+		return false;
+
+	offsets.resize(numOffsets);
+	file.read((char*)&offsets[0], numOffsets*sizeof(quint64));
+	if (!file.good() || offsets.back() > fileSize)
+	{
+		offsets.clear();
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Scans the file for the start of every timestep
+ *
+ * Only newlines are counted, so the file is read in large blocks and no line
+ * is parsed. A timestep that is cut off by the end of the file is left out.
+ */
+bool TimestepIndex::BuildIndex(QString filePath, unsigned int numTimesteps)
+{
+	std::ifstream file (filePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::vector<char> block (ScanBlockSize);
+	quint64 blockOffset = 0;
+	quint64 lineStart = 0;
+	quint64 linesRead = 0;
+	quint64 nextTimestepLine = headerLines;
+
+	offsets.reserve(numTimesteps + 1);
+	if (headerLines == 0)
+	{
+		offsets.push_back(0);
+		nextTimestepLine = linesPerTimestep;
+	}
+
+	while (offsets.size() <= numTimesteps && file)
+	{
+		file.read(&block[0], block.size());
+		size_t bytesRead = file.gcount();
+		if (bytesRead == 0)
+			break;
+
+		const char *pos = &block[0];
+		const char *end = pos + bytesRead;
+		while (pos < end && offsets.size() <= numTimesteps)
+		{
+			const char *newline = (const char*)memchr(pos, '\n', end - pos);
+			if (!newline)
+				break;
+
+			++linesRead;
+			pos = newline + 1;
+			lineStart = blockOffset + (pos - &block[0]);
+			if (linesRead == nextTimestepLine)
+			{
+				offsets.push_back(lineStart);
+				nextTimestepLine += linesPerTimestep;
+			}
+		}
+		blockOffset += bytesRead;
+	}
+
+	// The last line of the file may not have a newline
+	if (offsets.size() <= numTimesteps && !offsets.empty() && linesRead + 1 == nextTimestepLine && lineStart < blockOffset)
+		offsets.push_back(blockOffset);
+
+	return offsets.size() >= 2;
+}
+
+
+bool TimestepIndex::WriteIndexFile(QString indexPath, QFileInfo &info)
+{
+	std::ofstream file (indexPath.toStdString().data(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	quint64 fileSize = info.size();
+	qint64 modified = info.lastModified().toMSecsSinceEpoch();
+	unsigned int numOffsets = offsets.size();
+	file.write(IndexMagic, sizeof(IndexMagic));
+	file.write((const char*)&IndexByteOrder, sizeof(IndexByteOrder));
+	file.write((const char*)&fileSize, sizeof(fileSize));
+	file.write((const char*)&modified, sizeof(modified));
+	file.write((const char*)&headerLines, sizeof(headerLines));
+	file.write((const char*)&linesPerTimestep, sizeof(linesPerTimestep));
+	file.write((const char*)&numOffsets, sizeof(numOffsets));
+	file.write((const char*)&offsets[0], numOffsets*sizeof(quint64));
+	file.close();
+	return !file.fail();
+}
@@ -0,0 +1,48 @@
+#ifndef TIMESTEPINDEX_H
+#define TIMESTEPINDEX_H
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+#include <QString>
+#include <QFileInfo>
+#include <QDateTime>
+
+
+/**
+ * @brief The byte offset of every timestep in an ADCIRC output file (fort.063,
+ * fort.064, fort.065, fort.066 or fort.067)
+ *
+ * These files have a fixed number of header lines followed by timesteps that
+ * all have the same number of lines, so the index is built with one scan that
+ * counts newlines. It is saved next to the file as "<file>.index" with the
+ * file's size and modification time, and is only loaded again while those
+ * still match. If the index can't be saved it is still used from memory.
+ *
+ */
+class TimestepIndex
+{
+	public:
+		TimestepIndex();
+
+		bool		Load(QString filePath, unsigned int headerLines, unsigned int linesPerTimestep, unsigned int numTimesteps);
+		void		Clear();
+		bool		IsLoaded();
+		unsigned int	GetNumTimesteps();
+		quint64		GetOffset(unsigned int timestep);
+		quint64		GetEndOffset(unsigned int timestep);
+
+	private:
+
+		std::vector<quint64>	offsets;	/**< Offset of each timestep's first line, then the end of the last timestep */
+		unsigned int		headerLines;
+		unsigned int		linesPerTimestep;
+
+		bool	ReadIndexFile(QString indexPath, QFileInfo &info);
+		bool	BuildIndex(QString filePath, unsigned int numTimesteps);
+		bool	WriteIndexFile(QString indexPath, QFileInfo &info);
+};
+
+#endif // TIMESTEPINDEX_H
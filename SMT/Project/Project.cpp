@@ -6,6 +6,8 @@ Project::Project(QObject *parent) :
 	editSubdomainList(0),
 	fullDomain(0),
 	fullDomainRunner(0),
+	floodFillUseDepth(false),
+	floodFillDepth(0.0),
 	glPanel(0),
 	progressBar(0),
 	projectFile(0),
@@ -26,6 +28,8 @@ Project::Project(QString projectFile, QObject *parent) :
 	editSubdomainList(0),
 	fullDomain(0),
 	fullDomainRunner(0),
+	floodFillUseDepth(false),
+	floodFillDepth(0.0),
 	glPanel(0),
 	progressBar(0),
 	projectFile(0),
@@ -703,6 +707,30 @@ void Project::SetVisibleDomain(Domain *newDomain)
 }
 
 
+/**
+ * @brief Asks how full domain elements should be tested with the attribute
+ * tool, then selects or deselects the ones that pass
+ */
+void Project::UseFullDomainAttributeTool(SelectionMode mode)
+{
+	if (!fullDomain)
+		return;
+
+	AttributeSelectionDialog dlg;
+	if (fullDomain->GetFort13())
+		dlg.SetNodalAttributes(fullDomain->GetFort13()->GetNodalAttributes());
+	if (dlg.exec())
+	{
+		if (mode == Select)
+			SelectFullDomainAttributeElements(dlg.GetSource(), dlg.GetAttributeName(), dlg.GetColumn(),
+							  dlg.GetMinValue(), dlg.GetMaxValue(), dlg.GetElementMatch());
+		else
+			DeselectFullDomainAttributeElements(dlg.GetSource(), dlg.GetAttributeName(), dlg.GetColumn(),
+							    dlg.GetMinValue(), dlg.GetMaxValue(), dlg.GetElementMatch());
+	}
+}
+
+
 void Project::MatchFullCamera(SubDomain *targetSub)
 {
 	// Pick two nodes from the subdomain
@@ -872,6 +900,7 @@ void Project::CreateNewSubdomain()
 			if (!name.isEmpty() && !targetDir.isEmpty() && (version == 1 || version == 2) && recordFrequency > 0)
 			{
 				SubdomainCreator creator;
+				creator.SetNodeOrdering((NodeOrdering)dlg.GetNodeOrdering());
 				bool newSubdomain = creator.CreateSubdomain(name, projectFile, targetDir, fullDomain, version, recordFrequency);
 				if (newSubdomain)
 				{
@@ -886,6 +915,87 @@ void Project::CreateNewSubdomain()
 }
 
 
+/**
+ * @brief Asks for a list of selection files and creates a subdomain from each
+ */
+void Project::CreateNewSubdomainBatch()
+{
+	if (fullDomain && projectFile)
+	{
+		CreateSubdomainBatchDialog dlg;
+		dlg.SetFullDomainDirectory(projectFile->GetFullDomainDirectory());
+		if (dlg.exec())
+		{
+			if (!CreateSubdomainBatch(dlg.GetSelections(), dlg.GetRecordFrequency(), (NodeOrdering)dlg.GetNodeOrdering()))
+				QMessageBox::warning(0, "Create Subdomains", "Some subdomains could not be created. See the output for details.");
+		}
+	}
+}
+
+
+/**
+ * @brief Creates several version 1 subdomains at once and adds them to the project
+ * @param selections The name, directory and elements of each subdomain
+ * @param recordFrequency The record frequency of the full domain fort.015
+ * @param ordering The order that the nodes of each subdomain are numbered in
+ * @return true if every subdomain was created
+ */
+bool Project::CreateSubdomainBatch(std::vector<SubdomainSelection> selections, int recordFrequency, NodeOrdering ordering)
+{
+	if (!fullDomain || !projectFile || selections.empty() || recordFrequency <= 0)
+		return false;
+
+	QStringList existingNames = projectFile->GetSubDomainNames();
+
+	SubdomainCreator creator;
+	creator.SetNodeOrdering(ordering);
+	bool allCreated = creator.CreateSubdomains(selections, projectFile, fullDomain, recordFrequency);
+
+	// Only build the subdomains that were added by this batch
+	QStringList subdomainNames = projectFile->GetSubDomainNames();
+	for (std::vector<SubdomainSelection>::iterator it=selections.begin(); it != selections.end(); ++it)
+		if (!existingNames.contains(it->name) && subdomainNames.contains(it->name))
+			BuildSubdomain(it->name);
+
+	PopulateProjectTree();
+	emit showProjectView();
+	return allCreated;
+}
+
+
+/**
+ * @brief Extracts the boundary conditions of some of the subdomains from the
+ * full domain boundary output
+ * @param subdomainNames The subdomains to extract
+ * @param numTimeSlabs The number of time ranges to extract on their own threads,
+ * or 0 to use the reading, routing and writing pipeline
+ * @param benchmark true to time the extraction with 1 to 32 threads instead
+ * @return true if the boundary condition files of every subdomain were written
+ */
+bool Project::ExtractBoundaryConditions(QStringList subdomainNames, unsigned int numTimeSlabs, bool benchmark)
+{
+	if (!fullDomain || !projectFile)
+		return false;
+
+	std::vector<SubDomain*> selectedSubdomains;
+	for (int i=0; i<subdomainNames.size(); ++i)
+	{
+		SubDomain *currSub = DetermineSubdomain(DetermineDomain(subdomainNames.at(i)));
+		if (currSub)
+			selectedSubdomains.push_back(currSub);
+	}
+	if (selectedSubdomains.empty())
+		return false;
+
+	BoundaryConditionsExtractor extractor;
+	if (benchmark)
+		return extractor.BenchmarkTimeSlabs(projectFile, fullDomain, selectedSubdomains);
+
+	extractor.SetNumTimeSlabs(numTimeSlabs);
+	return extractor.ExtractBoundaryConditions(projectFile, fullDomain, selectedSubdomains);
+}
+
+
 void Project::EditProjectSettings()
 {
 
@@ -993,6 +1103,145 @@ void Project::DeselectFullDomainRectangleElements()
 }
 
 
+/**
+ * @brief Asks for a depth, nodal attribute or maxele range and selects the
+ * full domain elements in it
+ */
+void Project::SelectFullDomainAttributeElements()
+{
+	UseFullDomainAttributeTool(Select);
+}
+
+
+/**
+ * @brief Asks for a depth, nodal attribute or maxele range and deselects the
+ * full domain elements in it
+ */
+void Project::DeselectFullDomainAttributeElements()
+{
+	UseFullDomainAttributeTool(Deselect);
+}
+
+
+/**
+ * @brief Selects every full domain element whose nodes have values in the range
+ * @param source Depth, fort.13 nodal attribute or maxele
+ * @param attributeName The fort.13 attribute name (only used for nodal attributes)
+ * @param column Which value of the attribute to test, for attributes with
+ * several values per node
+ * @param minValue The smallest value that passes
+ * @param maxValue The largest value that passes
+ * @param match Whether all or any of the nodes of an element have to pass
+ */
+void Project::SelectFullDomainAttributeElements(AttributeSource source, QString attributeName, unsigned int column,
+						float minValue, float maxValue, ElementMatch match)
+{
+	if (fullDomain)
+	{
+		AttributeTool *tool = fullDomain->GetAttributeTool();
+		tool->SetAttribute(source, attributeName, column);
+		tool->SetRange(minValue, maxValue);
+		tool->SetElementMatch(match);
+		fullDomain->UseTool(AttributeToolType, ElementSelection, Select);
+	}
+}
+
+
+void Project::DeselectFullDomainAttributeElements(AttributeSource source, QString attributeName, unsigned int column,
+						  float minValue, float maxValue, ElementMatch match)
+{
+	if (fullDomain)
+	{
+		AttributeTool *tool = fullDomain->GetAttributeTool();
+		tool->SetAttribute(source, attributeName, column);
+		tool->SetRange(minValue, maxValue);
+		tool->SetElementMatch(match);
+		fullDomain->UseTool(AttributeToolType, ElementSelection, Deselect);
+	}
+}
+
+
+/**
+ * @brief Selects the region of unselected elements around the next clicked element
+ */
+void Project::SelectFullDomainFloodFillElements()
+{
+	if (fullDomain)
+		fullDomain->UseTool(FloodFillToolType, ElementSelection, Select);
+}
+
+
+/**
+ * @brief Deselects the region of selected elements around the next clicked element
+ */
+void Project::DeselectFullDomainFloodFillElements()
+{
+	if (fullDomain)
+		fullDomain->UseTool(FloodFillToolType, ElementSelection, Deselect);
+}
+
+
+/**
+ * @brief Asks for a number of rings and grows the full domain selection by them
+ */
+void Project::GrowFullDomainSelection()
+{
+	if (fullDomain)
+	{
+		bool ok = false;
+		int numRings = QInputDialog::getInt(0, "Grow Selection", "Rings of elements to add:", 1, 1, 1000, 1, &ok);
+		if (ok)
+			GrowFullDomainSelection(numRings);
+	}
+}
+
+
+void Project::GrowFullDomainSelection(unsigned int numRings)
+{
+	if (fullDomain)
+		fullDomain->GrowSelection(numRings);
+}
+
+
+/**
+ * @brief Asks for the depth contour that stops a flood fill, if any
+ */
+void Project::EditFloodFillDepthLimit()
+{
+	if (fullDomain)
+	{
+		bool ok = false;
+		QString currentDepth = floodFillUseDepth ? QString::number(floodFillDepth) : QString();
+		QString depth = QInputDialog::getText(0, "Flood Fill Depth Limit",
+						      "Stop flood fills at this depth (leave empty for no limit):",
+						      QLineEdit::Normal, currentDepth, &ok).trimmed();
+		if (!ok)
+			return;
+
+		bool isNumber = false;
+		float newDepth = depth.toFloat(&isNumber);
+		if (depth.isEmpty())
+			SetFloodFillDepthLimit(false, 0.0);
+		else if (isNumber)
+			SetFloodFillDepthLimit(true, newDepth);
+	}
+}
+
+
+/**
+ * @brief Sets whether flood fills stop at a depth contour
+ * @param useLimit true to stop flood fills at the contour
+ * @param depth The depth of the contour
+ */
+void Project::SetFloodFillDepthLimit(bool useLimit, float depth)
+{
+	floodFillUseDepth = useLimit;
+	floodFillDepth = depth;
+	if (fullDomain)
+		fullDomain->SetFloodFillDepthLimit(useLimit, depth);
+}
+
+
 void Project::SelectSingleSubdomainNode()
 {
 	SubDomain *currentSub = 0;
@@ -1019,6 +1268,27 @@ void Project::ShowDisplayOptionsDialog()
 }
 
 
+void Project::ShowExtractBoundaryConditionsDialog()
+{
+	if (fullDomain && projectFile)
+	{
+		ExtractBoundaryConditionsDialog dlg;
+		dlg.SetSubdomainNames(GetSubdomainNames());
+		if (dlg.exec())
+		{
+			QStringList names = dlg.GetSelectedSubdomains();
+			if (names.isEmpty())
+				return;
+
+			if (ExtractBoundaryConditions(names, dlg.GetNumTimeSlabs(), dlg.GetBenchmark()))
+				QMessageBox::information(0, "Boundary Conditions", "The boundary conditions were extracted.");
+			else
+				QMessageBox::warning(0, "Boundary Conditions", "The boundary conditions could not be extracted. See the output for details.");
+		}
+	}
+}
+
+
 void Project::ToggleQuadtreeVisible()
 {
 	if (visibleDomain)
@@ -1193,7 +1463,8 @@ void Project::setDisplay(QString displayMode,
                          QString FileName,
                          QString FullFileName){
 
-    if ( displayMode=="default" or displayMode=="maxele"){
+    if ( displayMode=="default" or displayMode=="maxele" or
+         displayMode=="animateFort63" or displayMode=="animateFort64"){
         if (domainIndex==0){
             fullDomain->visualizeDomain(displayMode,FileName);
         }
@@ -1210,6 +1481,62 @@ void Project::setDisplay(QString displayMode,
 }
 
 
+/**
+ * @brief Compares the maxele.63 in every subdomain directory with the full
+ * domain maxele and prints a summary of each
+ *
+ * The subdomains are all compared at once, so the work is spread across every
+ * thread even when the subdomains are small.
+ *
+ * @param FullFileName The full domain maxele.63
+ * @param results Set to the result of every subdomain whose maxele was read
+ * @return false if a subdomain's maxele couldn't be read or compared
+ */
+bool Project::CompareSubdomainMaxeles(QString FullFileName, std::vector<MaxeleComparisonResult> *results){
+
+    results->clear();
+
+    Maxele63 fullMaxele(FullFileName,"FullDomain",0,0);
+    if (fullMaxele.GetNumNodes() == 0){
+        std::cout << "Unable to read " << FullFileName.toStdString() << std::endl;
+        return false;
+    }
+
+    bool allRead = true;
+    std::vector<Maxele63*> subMaxeles;
+    std::vector<MaxeleComparisonInput> inputs;
+    for (unsigned int i=0; i<subDomains.size(); i++){
+        SubDomain *subDomain = subDomains[i];
+        QString maxeleFile = QDir(subDomain->GetPath()).absoluteFilePath("maxele.63");
+        Maxele63 *subMaxele = new Maxele63(maxeleFile, subDomain->GetDomainName(), projectFile, 0);
+        if (subMaxele->GetNumNodes() == 0 || !subDomain->GetPy140()){
+            std::cout << "Unable to read " << maxeleFile.toStdString() << std::endl;
+            delete subMaxele;
+            allRead = false;
+            continue;
+        }
+        subMaxeles.push_back(subMaxele);
+
+        MaxeleComparisonInput input;
+        input.name = subDomain->GetDomainName();
+        input.newToOld = &subDomain->GetPy140()->GetNewToOld();
+        input.maxele = &subMaxele->GetMaxeles();
+        inputs.push_back(input);
+    }
+
+    MaxeleComparison comparison;
+    bool allCompared = comparison.CompareAll(fullMaxele.GetMaxeles(), inputs, results);
+    for (unsigned int i=0; i<results->size(); i++){
+        MaxeleComparison::PrintSummary((*results)[i]);
+    }
+
+    for (unsigned int i=0; i<subMaxeles.size(); i++){
+        delete subMaxeles[i];
+    }
+    return allRead && allCompared;
+}
+
+
 QString Project::GetDomainPath(int domainIndex){
 
     if (domainIndex==0){
@@ -11,12 +11,16 @@
 
 #include <vector>
 
+#include "Adcirc/BoundaryConditionsExtractor.h"
 #include "Adcirc/FullDomainRunner.h"
 #include "Adcirc/SubdomainCreator.h"
 
+#include "Dialogs/AttributeSelectionDialog.h"
 #include "Dialogs/CreateProjectDialog.h"
 #include "Dialogs/CreateSubdomainDialog.h"
+#include "Dialogs/CreateSubdomainBatchDialog.h"
 #include "Dialogs/DisplayOptionsDialog.h"
+#include "Dialogs/ExtractBoundaryConditionsDialog.h"
 
 #include "Project/Domains/FullDomain.h"
 #include "Project/Domains/SubDomain.h"
@@ -34,7 +38,10 @@ class Project : public QObject
 		Project(QString projectFile, QObject *parent=0);
 		~Project();
 
+		bool	CreateSubdomainBatch(std::vector<SubdomainSelection> selections, int recordFrequency,
+					     NodeOrdering ordering = FullDomainOrdering);
 		void	DisplayDomain(int index);
+		bool	ExtractBoundaryConditions(QStringList subdomainNames, unsigned int numTimeSlabs, bool benchmark = false);
 		QString	GetFilePath();
 		bool	IsInitialized();
 		void	ResetAllNodalValues(QString subdomainName);
@@ -47,10 +54,17 @@ class Project : public QObject
 
 		QStringList	GetSubdomainNames();
 
+		void	SelectFullDomainAttributeElements(AttributeSource source, QString attributeName, unsigned int column,
+							  float minValue, float maxValue, ElementMatch match);
+		void	DeselectFullDomainAttributeElements(AttributeSource source, QString attributeName, unsigned int column,
+							    float minValue, float maxValue, ElementMatch match);
+		void	SetFloodFillDepthLimit(bool useLimit, float depth);
+
         //aa15
         int GetNumberOfSubdomains();
         void setDisplay(QString displayMode, int domainIndex, QString FileName, QString FullFileName);
         QString GetDomainPath(int domainIndex);
+        bool    CompareSubdomainMaxeles(QString FullFileName, std::vector<MaxeleComparisonResult> *results);
 
 	private:
 
@@ -58,6 +72,8 @@ class Project : public QObject
 		QListWidget*		editSubdomainList;
 		FullDomain*		fullDomain;
 		FullDomainRunner*	fullDomainRunner;
+		bool			floodFillUseDepth;
+		float			floodFillDepth;
 		OpenGLPanel*		glPanel;
 		QProgressBar*		progressBar;
 		ProjectFile*		projectFile;
@@ -79,6 +95,7 @@ class Project : public QObject
 		void		OpenProjectFile(QString filePath);
 		void		PopulateProjectTree();
 		void		SetVisibleDomain(Domain *newDomain);
+		void		UseFullDomainAttributeTool(SelectionMode mode);
 
 		void	MatchFullCamera(SubDomain *targetSub);	// Matches subdomain camera to full domain camera
 		void	MatchSubCamera(SubDomain *targetSub);	// Matches full domain camera to subdomain camera
@@ -87,6 +104,7 @@ class Project : public QObject
 	public slots:
 
 		void	CreateNewSubdomain();
+		void	CreateNewSubdomainBatch();
 		void	EditProjectSettings();
 		void	RunFullDomain();
 		void	RunSubdomain(QString subdomain);
@@ -101,10 +119,18 @@ class Project : public QObject
 		void	DeselectFullDomainClickElements();
 		void	DeselectFullDomainPolygonElements();
 		void	DeselectFullDomainRectangleElements();
+		void	SelectFullDomainAttributeElements();
+		void	DeselectFullDomainAttributeElements();
+		void	SelectFullDomainFloodFillElements();
+		void	DeselectFullDomainFloodFillElements();
+		void	GrowFullDomainSelection();
+		void	GrowFullDomainSelection(unsigned int numRings);
+		void	EditFloodFillDepthLimit();
 
 		void	SelectSingleSubdomainNode();
 
 		void	ShowDisplayOptionsDialog();
+		void	ShowExtractBoundaryConditionsDialog();
 		void	ToggleQuadtreeVisible();
 
 		void	Undo();
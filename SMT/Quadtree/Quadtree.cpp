@@ -222,6 +222,17 @@ std::vector<std::vector<Element*>*> Quadtree::GetElementsThroughDepth(int depth,
 }
 
 
+/**
+ * @brief Returns the Quadtree's own copy of the element list
+ *
+ * The Element pointers handed out by the search functions point into this list.
+ */
+std::vector<Element>* Quadtree::GetElements()
+{
+	return &elementList;
+}
+
+
 void Quadtree::SetNodalValues(unsigned int nodeNumber, float x, float y, float z, float normX, float normY, float normZ,
 			      QString xDat, QString yDat, QString zDat)
 {
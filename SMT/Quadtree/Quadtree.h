@@ -66,6 +66,7 @@ class Quadtree
 		std::vector<Element*>	FindElementsInPolygon(std::vector<Point> polyLine);
 		std::vector<std::vector<Element*> *> GetElementsThroughDepth(int depth);
 		std::vector<std::vector<Element*> *> GetElementsThroughDepth(int depth, float l, float r, float b, float t);
+		std::vector<Element>*	GetElements();
 
 		void	SetNodalValues(unsigned int nodeNumber, float x, float y, float z, float normX, float normY, float normZ, QString xDat, QString yDat, QString zDat);
 	private:
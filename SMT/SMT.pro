@@ -6,6 +6,8 @@
 
 QT       += core gui opengl xml
 
+greaterThan(QT_MAJOR_VERSION, 4): QT += concurrent
+
 DEFINES += GLEW_STATIC
 
 TARGET = SMT
@@ -51,6 +53,10 @@ SOURCES += main.cpp\
     SubdomainTools/ClickTool.cpp \
     SubdomainTools/CircleTool.cpp \
     SubdomainTools/BoundaryFinder.cpp \
+    SubdomainTools/MeshAdjacency.cpp \
+    SubdomainTools/MeshRenumberer.cpp \
+    SubdomainTools/AttributeTool.cpp \
+    SubdomainTools/RegionGrower.cpp \
     Quadtree/RectangleSearchNew.cpp \
     Quadtree/QuadtreeSearch.cpp \
     Quadtree/Quadtree.cpp \
@@ -75,12 +81,14 @@ SOURCES += main.cpp\
     Project/Files/Maxele63.cpp \
     Project/Files/Fort067.cpp \
     Project/Files/Fort066.cpp \
+    Project/Files/Fort065.cpp \
     Project/Files/Fort64.cpp \
     Project/Files/Fort63.cpp \
     Project/Files/Fort022.cpp \
     Project/Files/Fort22.cpp \
     Project/Files/Fort021.cpp \
     Project/Files/Fort020.cpp \
+    Project/Files/Fort019.cpp \
     Project/Files/Fort015.cpp \
     Project/Files/Fort15.cpp \
     Project/Files/Fort14.cpp \
@@ -88,16 +96,30 @@ SOURCES += main.cpp\
     Project/Files/Workers/Fort14Reader.cpp \
     Adcirc/SubdomainRunner.cpp \
     Adcirc/BoundaryConditionsExtractor.cpp \
+    Adcirc/BoundaryPipeline.cpp \
+    Adcirc/MaxeleComparison.cpp \
     Dialogs/ProjectSettingsDialog.cpp \
     Dialogs/FullDomainRunOptionsDialog.cpp \
     Dialogs/DisplayOptionsDialog.cpp \
     Dialogs/CreateSubdomainDialog.cpp \
+    Dialogs/CreateSubdomainBatchDialog.cpp \
     Dialogs/CreateProjectDialog.cpp \
+    Dialogs/ExtractBoundaryConditionsDialog.cpp \
+    Dialogs/AttributeSelectionDialog.cpp \
     Adcirc/FullDomainRunner.cpp \
     Adcirc/SubdomainCreator.cpp \
     Layers/SelectionLayers/SubDomainSelectionLayer.cpp \
     Project/Files/Workers/Fort14Writer.cpp \
     Project/Files/Fort13.cpp \
+    Project/Files/Workers/Fort13Carver.cpp \
+    Project/Files/Workers/BoundaryRecordReader.cpp \
+    Project/Files/Workers/BoundaryFileWriter.cpp \
+    Project/Files/Workers/TimestepIndex.cpp \
+    Project/Files/Workers/TimeSeriesReader.cpp \
+    Project/Files/Workers/TimeSeriesAnimation.cpp \
+    Project/Files/Workers/GlobalOutputReader.cpp \
+    Project/Files/Workers/FileSync.cpp \
+    Project/Files/Workers/BoundaryBinaryFormat.cpp \
     Layers/OpenStreetMapLayer.cpp \
     OpenGL/Shaders/OpenStreetMapShader.cpp \
     OpenStreetMap/Tiles/TileCache.cpp \
@@ -149,6 +171,10 @@ HEADERS  += MainWindow.h \
     SubdomainTools/ClickTool.h \
     SubdomainTools/CircleTool.h \
     SubdomainTools/BoundaryFinder.h \
+    SubdomainTools/MeshAdjacency.h \
+    SubdomainTools/MeshRenumberer.h \
+    SubdomainTools/AttributeTool.h \
+    SubdomainTools/RegionGrower.h \
     adcData.h \
     Quadtree/RectangleSearchNew.h \
     Quadtree/QuadtreeSearch.h \
@@ -175,12 +201,14 @@ HEADERS  += MainWindow.h \
     Project/Files/Maxele63.h \
     Project/Files/Fort067.h \
     Project/Files/Fort066.h \
+    Project/Files/Fort065.h \
     Project/Files/Fort64.h \
     Project/Files/Fort63.h \
     Project/Files/Fort022.h \
     Project/Files/Fort22.h \
     Project/Files/Fort021.h \
     Project/Files/Fort020.h \
+    Project/Files/Fort019.h \
     Project/Files/Fort015.h \
     Project/Files/Fort15.h \
     Project/Files/Fort14.h \
@@ -188,16 +216,31 @@ HEADERS  += MainWindow.h \
     Project/Files/Workers/Fort14Reader.h \
     Adcirc/SubdomainRunner.h \
     Adcirc/BoundaryConditionsExtractor.h \
+    Adcirc/BoundaryPipeline.h \
+    Adcirc/MaxeleComparison.h \
     Dialogs/ProjectSettingsDialog.h \
     Dialogs/FullDomainRunOptionsDialog.h \
     Dialogs/DisplayOptionsDialog.h \
     Dialogs/CreateSubdomainDialog.h \
+    Dialogs/CreateSubdomainBatchDialog.h \
     Dialogs/CreateProjectDialog.h \
+    Dialogs/ExtractBoundaryConditionsDialog.h \
+    Dialogs/AttributeSelectionDialog.h \
     Adcirc/FullDomainRunner.h \
     Adcirc/SubdomainCreator.h \
     Layers/SelectionLayers/SubDomainSelectionLayer.h \
     Project/Files/Workers/Fort14Writer.h \
     Project/Files/Fort13.h \
+    Project/Files/Workers/Fort13Carver.h \
+    Project/Files/Workers/BoundaryRecordReader.h \
+    Project/Files/Workers/BoundaryFileWriter.h \
+    Project/Files/Workers/TimestepIndex.h \
+    Project/Files/Workers/TimeSeriesReader.h \
+    Project/Files/Workers/TimeSeriesAnimation.h \
+    Project/Files/Workers/GlobalOutputReader.h \
+    Project/Files/Workers/AsciiNumberParser.h \
+    Project/Files/Workers/FileSync.h \
+    Project/Files/Workers/BoundaryBinaryFormat.h \
     Layers/OpenStreetMapLayer.h \
     OpenGL/Shaders/OpenStreetMapShader.h \
     OpenStreetMap/Tiles/TileCache.h \
@@ -220,7 +263,10 @@ FORMS    += MainWindow.ui \
     Dialogs/FullDomainRunOptionsDialog.ui \
     Dialogs/DisplayOptionsDialog.ui \
     Dialogs/CreateSubdomainDialog.ui \
-    Dialogs/CreateProjectDialog.ui
+    Dialogs/CreateSubdomainBatchDialog.ui \
+    Dialogs/CreateProjectDialog.ui \
+    Dialogs/ExtractBoundaryConditionsDialog.ui \
+    Dialogs/AttributeSelectionDialog.ui
 
 RESOURCES += \
     icons.qrc \
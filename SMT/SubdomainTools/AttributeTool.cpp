@@ -0,0 +1,396 @@
+#include "AttributeTool.h"
+
+
+/*
+ * A range of candidate elements that is tested on one thread. Candidates come
+ * either from a clip shape search (candidates) or straight from the Quadtree's
+ * element list (elements).
+ */
+struct AttributeChunk
+{
+		Element* const		*candidates;
+		Element			*elements;
+		unsigned int		begin;
+		unsigned int		end;
+		AttributeSource		source;
+		const float		*nodeValues;
+		unsigned int		numNodeValues;
+		float			minValue;
+		float			maxValue;
+		ElementMatch		match;
+		std::vector<Element*>	matches;
+};
+
+
+static bool NodeMatches(const AttributeChunk &chunk, Node *node)
+{
+	float value;
+	if (chunk.source == DepthAttribute)
+	{
+		value = node->z;
+	}
+	else if (chunk.source == MaxeleAttribute)
+	{
+		value = node->maxele;
+	} else {
+		if (node->nodeNumber == 0 || node->nodeNumber > chunk.numNodeValues)
+			return false;
+		value = chunk.nodeValues[node->nodeNumber-1];
+	}
+	return value >= chunk.minValue && value <= chunk.maxValue;
+}
+
+
+static void TestElements(AttributeChunk &chunk)
+{
+	for (unsigned int i=chunk.begin; i<chunk.end; ++i)
+	{
+		Element *currElement = chunk.candidates ? chunk.candidates[i] : &chunk.elements[i];
+		if (!currElement)
+			continue;
+
+		int numMatches = NodeMatches(chunk, currElement->n1) +
+				 NodeMatches(chunk, currElement->n2) +
+				 NodeMatches(chunk, currElement->n3);
+
+		if ((chunk.match == AllNodesMatch && numMatches == 3) ||
+		    (chunk.match == AnyNodeMatches && numMatches > 0))
+			chunk.matches.push_back(currElement);
+	}
+}
+
+
+/**
+ * @brief A constructor that initializes the tool with default values
+ *
+ * By default, the tool selects every element whose nodes all have a depth
+ * between -FLT_MAX and FLT_MAX.
+ */
+AttributeTool::AttributeTool()
+{
+	fort14 = 0;
+	fort13 = 0;
+
+	source = DepthAttribute;
+	column = 0;
+	minValue = -FLT_MAX;
+	maxValue = FLT_MAX;
+	match = AllNodesMatch;
+
+	clipShape = NoClip;
+	clipValues[0] = clipValues[1] = clipValues[2] = clipValues[3] = 0.0;
+}
+
+
+AttributeTool::~AttributeTool()
+{
+
+}
+
+
+/**
+ * @brief The tool has nothing to draw
+ */
+void AttributeTool::Draw()
+{
+
+}
+
+
+/**
+ * @brief The tool draws nothing, so it doesn't need the camera
+ */
+void AttributeTool::SetCamera(GLCamera*)
+{
+
+}
+
+
+void AttributeTool::SetFort14(Fort14 *newFort14)
+{
+	fort14 = newFort14;
+}
+
+
+/**
+ * @brief The tool reads the fort.14 directly, so it doesn't need the terrain
+ */
+void AttributeTool::SetTerrainLayer(TerrainLayer*)
+{
+
+}
+
+
+void AttributeTool::SetViewportSize(float, float)
+{
+
+}
+
+
+void AttributeTool::MouseClick(QMouseEvent*)
+{
+
+}
+
+
+void AttributeTool::MouseMove(QMouseEvent*)
+{
+
+}
+
+
+void AttributeTool::MouseRelease(QMouseEvent*)
+{
+
+}
+
+
+void AttributeTool::MouseWheel(QWheelEvent*)
+{
+
+}
+
+
+void AttributeTool::KeyPress(QKeyEvent*)
+{
+
+}
+
+
+/**
+ * @brief Runs the test and emits ToolFinishedDrawing() right away
+ */
+void AttributeTool::UseTool()
+{
+	FindElements();
+	emit Message(QString::number(selectedElements.size()).append(" elements matched the attribute test"));
+	emit ToolFinishedDrawing();
+}
+
+
+/**
+ * @brief The tool only selects elements
+ */
+std::vector<Node*> AttributeTool::GetSelectedNodes()
+{
+	return std::vector<Node*>();
+}
+
+
+/**
+ * @brief Returns the elements that passed the last test run by UseTool()
+ */
+std::vector<Element*> AttributeTool::GetSelectedElements()
+{
+	return selectedElements;
+}
+
+
+/**
+ * @brief Sets the full domain fort.13 file used for nodal attribute tests
+ */
+void AttributeTool::SetFort13(Fort13 *newFort13)
+{
+	fort13 = newFort13;
+}
+
+
+/**
+ * @brief Sets the nodal value that is tested
+ * @param newSource Depth, fort.13 nodal attribute or maxele
+ * @param newAttributeName The name of the fort.13 attribute (only used for nodal attributes)
+ * @param newColumn Which value to use for attributes with more than one value per node
+ */
+void AttributeTool::SetAttribute(AttributeSource newSource, QString newAttributeName, unsigned int newColumn)
+{
+	source = newSource;
+	attributeName = newAttributeName;
+	column = newColumn;
+}
+
+
+/**
+ * @brief Sets the range of values (inclusive) that pass the test
+ *
+ * Use -FLT_MAX or FLT_MAX to leave one end of the range open.
+ */
+void AttributeTool::SetRange(float newMinValue, float newMaxValue)
+{
+	minValue = newMinValue;
+	maxValue = newMaxValue;
+}
+
+
+/**
+ * @brief Sets whether all or any of an element's nodes need to pass the test
+ */
+void AttributeTool::SetElementMatch(ElementMatch newMatch)
+{
+	match = newMatch;
+}
+
+
+/**
+ * @brief Limits the test to the elements inside a rectangle
+ *
+ * All coordinates are in the original coordinate system of the fort.14 file.
+ */
+void AttributeTool::SetClipRectangle(float l, float r, float b, float t)
+{
+	clipShape = RectangleClip;
+	clipValues[0] = l;
+	clipValues[1] = r;
+	clipValues[2] = b;
+	clipValues[3] = t;
+}
+
+
+/**
+ * @brief Limits the test to the elements inside a circle
+ *
+ * All coordinates are in the original coordinate system of the fort.14 file.
+ */
+void AttributeTool::SetClipCircle(float x, float y, float radius)
+{
+	clipShape = CircleClip;
+	clipValues[0] = x;
+	clipValues[1] = y;
+	clipValues[2] = radius;
+}
+
+
+/**
+ * @brief Limits the test to the elements inside a polygon
+ *
+ * All coordinates are in the original coordinate system of the fort.14 file.
+ */
+void AttributeTool::SetClipPolygon(std::vector<Point> polyLine)
+{
+	clipShape = PolygonClip;
+	clipPolygon = polyLine;
+}
+
+
+/**
+ * @brief Tests the whole domain again
+ */
+void AttributeTool::ClearClip()
+{
+	clipShape = NoClip;
+	clipPolygon.clear();
+}
+
+
+/**
+ * @brief Tests every candidate element in parallel
+ *
+ * Each thread collects the elements that pass in its own list, and the lists
+ * are joined in order afterwards.
+ */
+void AttributeTool::FindElements()
+{
+	selectedElements.clear();
+
+	if (!fort14)
+		return;
+
+	if (source == MaxeleAttribute && !fort14->HasMaxele())
+	{
+		emit Message(QString("<p style:color='red'><strong>Load a maxele.63 before selecting by maxele</strong></p>"));
+		return;
+	}
+
+	std::vector<float> nodeValues;
+	if (source == NodalAttributeValue && !BuildNodeValues(&nodeValues))
+	{
+		emit Message(QString("<p style:color='red'><strong>Unable to find nodal attribute ").append(attributeName).append("</strong></p>"));
+		return;
+	}
+
+	std::vector<Element*> candidates;
+	std::vector<Element> *allElements = 0;
+	unsigned int numCandidates = 0;
+	if (clipShape != NoClip)
+	{
+		if (!FindClipCandidates(&candidates))
+			return;
+		numCandidates = candidates.size();
+	} else {
+		allElements = fort14->GetQuadtreeElements();
+		if (!allElements)
+			return;
+		numCandidates = allElements->size();
+	}
+
+	if (numCandidates == 0)
+		return;
+
+	unsigned int numThreads = std::max(QThread::idealThreadCount(), 1);
+	unsigned int numChunks = std::min(4*numThreads, numCandidates/4096 + 1);
+	std::vector<AttributeChunk> chunks (numChunks);
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		chunks[i].candidates = candidates.empty() ? 0 : &candidates[0];
+		chunks[i].elements = allElements ? &(*allElements)[0] : 0;
+		chunks[i].begin = (quint64)numCandidates*i/numChunks;
+		chunks[i].end = (quint64)numCandidates*(i+1)/numChunks;
+		chunks[i].source = source;
+		chunks[i].nodeValues = nodeValues.empty() ? 0 : &nodeValues[0];
+		chunks[i].numNodeValues = nodeValues.size();
+		chunks[i].minValue = minValue;
+		chunks[i].maxValue = maxValue;
+		chunks[i].match = match;
+	}
+	QtConcurrent::blockingMap(chunks, TestElements);
+
+	unsigned int numMatches = 0;
+	for (unsigned int i=0; i<numChunks; ++i)
+		numMatches += chunks[i].matches.size();
+	selectedElements.reserve(numMatches);
+	for (unsigned int i=0; i<numChunks; ++i)
+		selectedElements.insert(selectedElements.end(), chunks[i].matches.begin(), chunks[i].matches.end());
+}
+
+
+/**
+ * @brief Expands the fort.13 attribute into one value per node
+ */
+bool AttributeTool::BuildNodeValues(std::vector<float> *nodeValues)
+{
+	if (!fort13 || attributeName.isEmpty())
+		return false;
+	return fort13->GetAttributeValues(attributeName, column, nodeValues);
+}
+
+
+/**
+ * @brief Uses the Quadtree to find the elements inside the clip shape
+ */
+bool AttributeTool::FindClipCandidates(std::vector<Element*> *candidates)
+{
+	if (clipShape == RectangleClip)
+	{
+		*candidates = fort14->FindElementsInRectangle(fort14->GetNormalizedX(clipValues[0]),
+							      fort14->GetNormalizedX(clipValues[1]),
+							      fort14->GetNormalizedY(clipValues[2]),
+							      fort14->GetNormalizedY(clipValues[3]));
+	}
+	else if (clipShape == CircleClip)
+	{
+		/* The domain is scaled by the same amount in x and y */
+		float radius = fort14->GetNormalizedX(clipValues[0] + clipValues[2]) - fort14->GetNormalizedX(clipValues[0]);
+		*candidates = fort14->FindElementsInCircle(fort14->GetNormalizedX(clipValues[0]),
+							   fort14->GetNormalizedY(clipValues[1]),
+							   radius);
+	}
+	else if (clipShape == PolygonClip)
+	{
+		std::vector<Point> normalizedPolygon;
+		for (std::vector<Point>::iterator it = clipPolygon.begin(); it != clipPolygon.end(); ++it)
+			normalizedPolygon.push_back(Point(fort14->GetNormalizedX(it->x), fort14->GetNormalizedY(it->y)));
+		*candidates = fort14->FindElementsInPolygon(normalizedPolygon);
+	} else {
+		return false;
+	}
+	return true;
+}
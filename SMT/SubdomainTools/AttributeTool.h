@@ -0,0 +1,113 @@
+#ifndef ATTRIBUTETOOL_H
+#define ATTRIBUTETOOL_H
+
+#include <QObject>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+#include "adcData.h"
+#include "OpenGL/GLCamera.h"
+#include "Layers/TerrainLayer.h"
+#include "SubdomainTools/SelectionTool.h"
+#include "Project/Files/Fort13.h"
+
+
+/**
+ * @brief The nodal values that an AttributeTool can test
+ */
+enum AttributeSource {DepthAttribute, NodalAttributeValue, MaxeleAttribute};
+
+
+/**
+ * @brief How the nodal test results are combined for an element
+ */
+enum ElementMatch {AllNodesMatch, AnyNodeMatches};
+
+
+/**
+ * @brief The shape that an AttributeTool search can be limited to
+ */
+enum ClipShape {NoClip, RectangleClip, CircleClip, PolygonClip};
+
+
+/**
+ * @brief A tool used to select Elements whose nodal values fall within a range
+ *
+ * The tested value can be the bathymetric depth, one of the full domain fort.13
+ * nodal attributes or the maxele value loaded into the fort.14. The search can be
+ * limited to a rectangle, circle or polygon, which is found through the Quadtree
+ * first. The remaining elements are tested in parallel.
+ *
+ * The tool doesn't need any mouse input. Set up the test and call UseTool()
+ * (usually through SelectionLayer::UseTool()), and ToolFinishedDrawing() is emitted
+ * as soon as the matching elements have been found.
+ *
+ */
+class AttributeTool : public SelectionTool
+{
+		Q_OBJECT
+	public:
+		AttributeTool();
+		~AttributeTool();
+
+		void	Draw();
+		void	SetCamera(GLCamera* cam);
+		void	SetFort14(Fort14 *newFort14);
+		void	SetTerrainLayer(TerrainLayer *layer);
+		void	SetViewportSize(float w, float h);
+
+		void	MouseClick(QMouseEvent *event);
+		void	MouseMove(QMouseEvent *event);
+		void	MouseRelease(QMouseEvent *event);
+		void	MouseWheel(QWheelEvent *event);
+		void	KeyPress(QKeyEvent *event);
+
+		void	UseTool();
+
+		std::vector<Node*>	GetSelectedNodes();
+		std::vector<Element*>	GetSelectedElements();
+
+		/* Test Setup */
+		void	SetFort13(Fort13 *newFort13);
+		void	SetAttribute(AttributeSource newSource, QString newAttributeName = QString(), unsigned int newColumn = 0);
+		void	SetRange(float newMinValue, float newMaxValue);
+		void	SetElementMatch(ElementMatch newMatch);
+		void	SetClipRectangle(float l, float r, float b, float t);
+		void	SetClipCircle(float x, float y, float radius);
+		void	SetClipPolygon(std::vector<Point> polyLine);
+		void	ClearClip();
+
+	private:
+
+		Fort14*		fort14;
+		Fort13*		fort13;
+
+		/* Test Parameters */
+		AttributeSource		source;		/**< Which nodal value is tested */
+		QString			attributeName;	/**< The fort.13 attribute, when source is NodalAttributeValue */
+		unsigned int		column;		/**< The fort.13 attribute value, for attributes with several values per node */
+		float			minValue;	/**< The smallest value that passes the test */
+		float			maxValue;	/**< The largest value that passes the test */
+		ElementMatch		match;		/**< How the nodes of an element are combined */
+
+		/* Clip Shape, in domain coordinates */
+		ClipShape		clipShape;
+		float			clipValues[4];	/**< l, r, b, t for rectangles or x, y, radius for circles */
+		std::vector<Point>	clipPolygon;
+
+		/* Selected Nodes/Elements */
+		std::vector<Element*>	selectedElements;	/**< The list of elements that passed the test */
+
+		void	FindElements();
+		bool	BuildNodeValues(std::vector<float> *nodeValues);
+		bool	FindClipCandidates(std::vector<Element*> *candidates);
+};
+
+#endif // ATTRIBUTETOOL_H
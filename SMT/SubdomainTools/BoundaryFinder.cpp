@@ -1,7 +1,253 @@
 #include "BoundaryFinder.h"
 
-BoundaryFinder::BoundaryFinder()
+
+/*
+ * Work items used by PerformBoundarySearch. Each one covers a contiguous
+ * range of the selection (or of the edge records) so that the passes can
+ * be handed to QtConcurrent::blockingMap.
+ */
+
+struct EdgeRecord
+{
+		quint64		key;		/**< (smaller node number << 32) | larger node number */
+		unsigned int	element;	/**< Index into the selection list */
+		unsigned int	side;		/**< 0 is n1-n2, 1 is n2-n3, 2 is n3-n1 */
+		bool operator< (const EdgeRecord &other) const {
+			return key < other.key;
+		}
+};
+
+struct EdgeChunk
+{
+		const std::vector<Element*>	*elements;
+		EdgeRecord			*records;
+		unsigned int			begin;
+		unsigned int			end;
+		float				minZ;
+		float				maxZ;
+		unsigned int			maxNode;
+};
+
+struct SortChunk
+{
+		EdgeRecord	*first;
+		EdgeRecord	*middle;
+		EdgeRecord	*last;
+};
+
+struct InnerNodeChunk
+{
+		const std::vector<Element*>	*elements;
+		const unsigned char		*nodeMarks;
+		unsigned int			begin;
+		unsigned int			end;
+		std::vector<unsigned int>	innerNodes;
+};
+
+static const quint64 NullEdgeKey = ~quint64(0);
+static const unsigned char SelectedNode = 1;
+static const unsigned char BoundaryNode = 2;
+static const unsigned char InMinZHeap = 1;
+static const unsigned char InMaxZHeap = 2;
+
+
+static quint64 PackEdge(unsigned int a, unsigned int b)
+{
+	if (a < b)
+		return (quint64(a) << 32) | b;
+	return (quint64(b) << 32) | a;
+}
+
+
+static void CollectEdges(EdgeChunk &chunk)
 {
+	chunk.minZ = 99999;
+	chunk.maxZ = -99999;
+	chunk.maxNode = 0;
+	for (unsigned int i=chunk.begin; i<chunk.end; ++i)
+	{
+		Element *currElement = (*chunk.elements)[i];
+		EdgeRecord *records = chunk.records + 3*i;
+		if (!currElement)
+		{
+			for (unsigned int side=0; side<3; ++side)
+			{
+				records[side].key = NullEdgeKey;
+				records[side].element = i;
+				records[side].side = side;
+			}
+			continue;
+		}
+
+		Node *nodes[3] = {currElement->n1, currElement->n2, currElement->n3};
+		for (unsigned int side=0; side<3; ++side)
+		{
+			records[side].key = PackEdge(nodes[side]->nodeNumber, nodes[(side+1)%3]->nodeNumber);
+			records[side].element = i;
+			records[side].side = side;
+
+			if (nodes[side]->z < chunk.minZ)
+				chunk.minZ = nodes[side]->z;
+			if (nodes[side]->z > chunk.maxZ)
+				chunk.maxZ = nodes[side]->z;
+			if (nodes[side]->nodeNumber > chunk.maxNode)
+				chunk.maxNode = nodes[side]->nodeNumber;
+		}
+	}
+}
+
+
+static void SortEdges(SortChunk &chunk)
+{
+	std::sort(chunk.first, chunk.last);
+}
+
+
+static void MergeEdges(SortChunk &chunk)
+{
+	std::inplace_merge(chunk.first, chunk.middle, chunk.last);
+}
+
+
+static void CollectInnerNodes(InnerNodeChunk &chunk)
+{
+	for (unsigned int i=chunk.begin; i<chunk.end; ++i)
+	{
+		Element *currElement = (*chunk.elements)[i];
+		if (!currElement)
+			continue;
+
+		unsigned int n[3] = {currElement->n1->nodeNumber, currElement->n2->nodeNumber, currElement->n3->nodeNumber};
+		int onBoundary = 0;
+		for (unsigned int vertex=0; vertex<3; ++vertex)
+			onBoundary += chunk.nodeMarks[n[vertex]] == BoundaryNode;
+
+		if (onBoundary > 0 && onBoundary < 3)
+			for (unsigned int vertex=0; vertex<3; ++vertex)
+				if (chunk.nodeMarks[n[vertex]] != BoundaryNode)
+					chunk.innerNodes.push_back(n[vertex]);
+	}
+}
+
+
+/**
+ * @brief Sorts the edge records by sorting equal slices on separate threads
+ * and then merging neighboring slices pairwise until one run is left
+ */
+static void ParallelSortEdges(std::vector<EdgeRecord> &records, unsigned int numSlices)
+{
+	if (records.empty())
+		return;
+
+	std::vector<EdgeRecord*> bounds;
+	for (unsigned int i=0; i<=numSlices; ++i)
+		bounds.push_back(&records[0] + (quint64)records.size()*i/numSlices);
+
+	std::vector<SortChunk> chunks;
+	for (unsigned int i=0; i<numSlices; ++i)
+	{
+		SortChunk chunk = {bounds[i], bounds[i+1], bounds[i+1]};
+		chunks.push_back(chunk);
+	}
+	QtConcurrent::blockingMap(chunks, SortEdges);
+
+	for (unsigned int width=1; width<numSlices; width*=2)
+	{
+		chunks.clear();
+		for (unsigned int i=0; i+width<numSlices; i+=2*width)
+		{
+			SortChunk chunk = {bounds[i], bounds[i+width], bounds[std::min(i+2*width, numSlices)]};
+			chunks.push_back(chunk);
+		}
+		QtConcurrent::blockingMap(chunks, MergeEdges);
+	}
+}
+
+
+/*
+ * Heap orderings for the depth heaps. The std heap functions keep the largest
+ * entry by the given ordering on top.
+ */
+static bool DeeperThan(const NodeDepth &first, const NodeDepth &second)
+{
+	return first.z > second.z;
+}
+
+
+static bool ShallowerThan(const NodeDepth &first, const NodeDepth &second)
+{
+	return first.z < second.z;
+}
+
+
+static bool EdgeStartsBefore(const BoundaryEdge &first, const BoundaryEdge &second)
+{
+	return first.from->nodeNumber < second.from->nodeNumber;
+}
+
+
+/**
+ * @brief Returns the clockwise angle (0 to 2 pi) swept from the reverse of the
+ * incoming edge to the outgoing edge, around the node they share
+ */
+static double ClockwiseTurn(const BoundaryEdge &incoming, const BoundaryEdge &outgoing)
+{
+	double backX = incoming.from->x - incoming.to->x;
+	double backY = incoming.from->y - incoming.to->y;
+	double outX = outgoing.to->x - outgoing.from->x;
+	double outY = outgoing.to->y - outgoing.from->y;
+	double angle = -atan2(backX*outY - backY*outX, backX*outX + backY*outY);
+	if (angle <= 0.0)
+		angle += 2.0*M_PI;
+	return angle;
+}
+
+
+BoundaryFinder::BoundaryFinder() :
+	elements(0),
+	adjacency(0),
+	selected(),
+	nodeUseCount(),
+	boundaryEdges(),
+	numBoundaryEdges(0),
+	numSelectedElements(0),
+	numSelectedNodes(0),
+	minZHeap(),
+	maxZHeap(),
+	nodeInHeaps(),
+	minZ(99999),
+	maxZ(-99999)
+{
+}
+
+
+/**
+ * @brief Constructor used for tracking a changing selection
+ * @param meshElements The full list of mesh Elements
+ * @param meshAdjacency The adjacency tables of the mesh
+ */
+BoundaryFinder::BoundaryFinder(std::vector<Element> *meshElements, MeshAdjacency *meshAdjacency) :
+	elements(meshElements),
+	adjacency(meshAdjacency),
+	selected(),
+	nodeUseCount(),
+	boundaryEdges(),
+	numBoundaryEdges(0),
+	numSelectedElements(0),
+	numSelectedNodes(0),
+	minZHeap(),
+	maxZHeap(),
+	nodeInHeaps(),
+	minZ(99999),
+	maxZ(-99999)
+{
+	if (elements && adjacency)
+	{
+		selected.assign(adjacency->GetNumElements(), 0);
+		nodeUseCount.assign(adjacency->GetNumNodes(), 0);
+		boundaryEdges.assign(3*adjacency->GetNumElements(), 0);
+		nodeInHeaps.assign(adjacency->GetNumNodes(), 0);
+	}
 }
 
 
@@ -10,175 +256,521 @@ BoundaryFinder::~BoundaryFinder()
 }
 
 
-void BoundaryFinder::PerformBoundarySearch(std::vector<Element *> elements, Boundaries *boundaryData)
+/**
+ * @brief Traces the boundaries of a list of selected elements from scratch
+ *
+ * Every element side is packed into a 64-bit key made from its two node
+ * numbers, and the keys are sorted in parallel. A key that appears exactly
+ * once belongs to a boundary edge. The boundary edges are then walked into
+ * closed loops, so holes in the selection are found in the same pass as the
+ * outer boundary.
+ *
+ * @param elements The list of all selected elements
+ * @param boundaryData The Boundaries object where the results will be stored
+ */
+void BoundaryFinder::PerformBoundarySearch(const std::vector<Element *> &elements, Boundaries *boundaryData)
 {
-	if (boundaryData && !boundaryData->boundariesFound)
+	if (!boundaryData || boundaryData->boundariesFound)
+		return;
+
+	boundaryData->innerBoundaryNodes.clear();
+	boundaryData->outerBoundaryNodes.clear();
+	boundaryData->boundaryLoops.clear();
+	boundaryData->numElements = elements.size();
+	boundaryData->numNodes = 0;
+
+	if (elements.empty())
+		return;
+
+	unsigned int numThreads = std::max(QThread::idealThreadCount(), 1);
+	unsigned int numChunks = std::min(4*numThreads, (unsigned int)elements.size()/4096 + 1);
+
+	/*
+	 * Pack each element side into an edge record while finding the depth
+	 * range and the largest node number of the selection
+	 */
+	std::vector<EdgeRecord> records (3*elements.size());
+	std::vector<EdgeChunk> edgeChunks (numChunks);
+	for (unsigned int i=0; i<numChunks; ++i)
 	{
-		/*
-		 * - elements is a list of all selected elements
-		 * - boundaryData is the Boundaries object where the results will be stored
-		 */
+		edgeChunks[i].elements = &elements;
+		edgeChunks[i].records = &records[0];
+		edgeChunks[i].begin = (quint64)elements.size()*i/numChunks;
+		edgeChunks[i].end = (quint64)elements.size()*(i+1)/numChunks;
+	}
+	QtConcurrent::blockingMap(edgeChunks, CollectEdges);
 
-		std::map<unsigned int, std::vector<unsigned int> > nodeAdjacencyOuter;
-		std::map<Edge, int> edgeCount;
-		std::set<unsigned int> selectedNodes;
-		boundaryData->innerBoundaryNodes.clear();
-		boundaryData->outerBoundaryNodes.clear();
-		boundaryData->numElements = elements.size();
+	unsigned int maxNode = 0;
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		boundaryData->minZ = std::min(boundaryData->minZ, edgeChunks[i].minZ);
+		boundaryData->maxZ = std::max(boundaryData->maxZ, edgeChunks[i].maxZ);
+		maxNode = std::max(maxNode, edgeChunks[i].maxNode);
+	}
+
+	/*
+	 * After sorting, both copies of an interior edge sit next to each other.
+	 * If an edge only appears once, it is a boundary edge. This assumes that
+	 * the are no elements in the interior of the selection that are not selected.
+	 */
+	ParallelSortEdges(records, numChunks);
 
-		/*
-		 * Count the number of times each edge appears in the selection
-		 */
+	std::vector<BoundaryEdge> edges;
+	unsigned int numUniqueEdges = 0;
+	for (unsigned int i=0; i<records.size() && records[i].key != NullEdgeKey;)
+	{
+		unsigned int j = i+1;
+		while (j<records.size() && records[j].key == records[i].key)
+			++j;
 
-		Element *currElement = 0;
-		for (std::vector<Element*>::iterator elementIterator = elements.begin();
-		     elementIterator != elements.end();
-		     ++elementIterator)
+		if (j == i+1)
+		{
+			Element *currElement = elements[records[i].element];
+			Node *nodes[3] = {currElement->n1, currElement->n2, currElement->n3};
+			edges.push_back(BoundaryEdge(nodes[records[i].side], nodes[(records[i].side+1)%3]));
+		}
+
+		++numUniqueEdges;
+		i = j;
+	}
+
+	/*
+	 * Count the selected nodes and flag the ones that are on the boundary
+	 */
+	std::vector<unsigned char> nodeMarks (maxNode+1, 0);
+	for (std::vector<Element*>::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		if (*it)
 		{
-			currElement = *elementIterator;
-			if (currElement)
+			nodeMarks[(*it)->n1->nodeNumber] = SelectedNode;
+			nodeMarks[(*it)->n2->nodeNumber] = SelectedNode;
+			nodeMarks[(*it)->n3->nodeNumber] = SelectedNode;
+		}
+	}
+	boundaryData->numNodes = std::count(nodeMarks.begin(), nodeMarks.end(), SelectedNode);
+
+	unsigned int numBoundaryNodes = 0;
+	for (std::vector<BoundaryEdge>::iterator it = edges.begin(); it != edges.end(); ++it)
+	{
+		if (nodeMarks[it->from->nodeNumber] != BoundaryNode)
+		{
+			nodeMarks[it->from->nodeNumber] = BoundaryNode;
+			++numBoundaryNodes;
+		}
+	}
+
+	if (numUniqueEdges <= 2 || numBoundaryNodes <= 2)
+		return;
+
+	TraceBoundaryLoops(edges, boundaryData);
+
+	/*
+	 * Create an unordered list of inner boundary nodes. These are the nodes of
+	 * selected elements that touch the boundary but are not on it themselves.
+	 */
+	std::vector<InnerNodeChunk> innerChunks (numChunks);
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		innerChunks[i].elements = &elements;
+		innerChunks[i].nodeMarks = &nodeMarks[0];
+		innerChunks[i].begin = edgeChunks[i].begin;
+		innerChunks[i].end = edgeChunks[i].end;
+	}
+	QtConcurrent::blockingMap(innerChunks, CollectInnerNodes);
+
+	std::vector<unsigned int> &innerNodes = boundaryData->innerBoundaryNodes;
+	for (unsigned int i=0; i<numChunks; ++i)
+		innerNodes.insert(innerNodes.end(), innerChunks[i].innerNodes.begin(), innerChunks[i].innerNodes.end());
+	std::sort(innerNodes.begin(), innerNodes.end());
+	innerNodes.erase(std::unique(innerNodes.begin(), innerNodes.end()), innerNodes.end());
+
+	boundaryData->boundariesFound = true;
+}
+
+
+
+/**
+ * @brief Adds elements to the tracked selection
+ *
+ * Only the sides of the new elements (and of their neighbors) are re-examined.
+ * Elements that are already selected are ignored.
+ *
+ * @param newElements The elements to add
+ */
+void BoundaryFinder::AddElements(const std::vector<Element*> &newElements)
+{
+	if (!IsTracking())
+		return;
+
+	for (std::vector<Element*>::const_iterator it = newElements.begin(); it != newElements.end(); ++it)
+	{
+		if (!*it)
+			continue;
+
+		unsigned int element = (*it)->elementNumber-1;
+		if (element >= selected.size() || selected[element])
+			continue;
+
+		selected[element] = 1;
+		++numSelectedElements;
+
+		for (unsigned int vertex=0; vertex<3; ++vertex)
+		{
+			unsigned int node = adjacency->GetNode(element, vertex);
+			if (nodeUseCount[node]++ == 0)
 			{
-				Edge edge1 (currElement->n1->nodeNumber, currElement->n2->nodeNumber);
-				Edge edge2 (currElement->n1->nodeNumber, currElement->n3->nodeNumber);
-				Edge edge3 (currElement->n2->nodeNumber, currElement->n3->nodeNumber);
-				if (edgeCount.count(edge1) == 0)
-					edgeCount[edge1] = 0;
-				if (edgeCount.count(edge2) == 0)
-					edgeCount[edge2] = 0;
-				if (edgeCount.count(edge3) == 0)
-					edgeCount[edge3] = 0;
-				edgeCount[edge1] += 1;
-				edgeCount[edge2] += 1;
-				edgeCount[edge3] += 1;
-
-				selectedNodes.insert(currElement->n1->nodeNumber);
-				selectedNodes.insert(currElement->n2->nodeNumber);
-				selectedNodes.insert(currElement->n3->nodeNumber);
-
-				if (currElement->n1->z < boundaryData->minZ)
-					boundaryData->minZ = currElement->n1->z;
-				else if (currElement->n1->z > boundaryData->maxZ)
-					boundaryData->maxZ = currElement->n1->z;
-				if (currElement->n2->z < boundaryData->minZ)
-					boundaryData->minZ = currElement->n2->z;
-				else if (currElement->n2->z > boundaryData->maxZ)
-					boundaryData->maxZ = currElement->n2->z;
-				if (currElement->n3->z < boundaryData->minZ)
-					boundaryData->minZ = currElement->n3->z;
-				else if (currElement->n3->z > boundaryData->maxZ)
-					boundaryData->maxZ = currElement->n3->z;
+				++numSelectedNodes;
+				AddNodeDepth(node, GetNode(element, vertex)->z);
 			}
 		}
 
-		boundaryData->numNodes = selectedNodes.size();
+		UpdateBoundaryEdges(element);
+	}
+}
+
+
+/**
+ * @brief Removes elements from the tracked selection
+ *
+ * Only the sides of the removed elements (and of their neighbors) are re-examined.
+ * Dropped nodes are left in the depth heaps until they reach the top.
+ *
+ * @param oldElements The elements to remove
+ */
+void BoundaryFinder::RemoveElements(const std::vector<Element*> &oldElements)
+{
+	if (!IsTracking())
+		return;
+
+	for (std::vector<Element*>::const_iterator it = oldElements.begin(); it != oldElements.end(); ++it)
+	{
+		if (!*it)
+			continue;
+
+		unsigned int element = (*it)->elementNumber-1;
+		if (element >= selected.size() || !selected[element])
+			continue;
+
+		selected[element] = 0;
+		--numSelectedElements;
 
-		if (edgeCount.size() > 2)
+		for (unsigned int vertex=0; vertex<3; ++vertex)
 		{
-			/*
-			 * If an edge only appears once, it is a boundary edge.
-			 * This assumes that the are no elements in the interior of the selection
-			 * that are not selected.
-			 */
-			for (std::map<Edge, int>::iterator it = edgeCount.begin(); it != edgeCount.end(); ++it)
+			unsigned int node = adjacency->GetNode(element, vertex);
+			if (--nodeUseCount[node] == 0)
+				--numSelectedNodes;
+		}
+
+		UpdateBoundaryEdges(element);
+	}
+}
+
+
+/**
+ * @brief Fills a Boundaries object using the tracked selection
+ *
+ * The boundary loops are found by walking the tracked boundary edges. Finding
+ * the edges is a scan of the flat edge flags that stops as soon as every
+ * boundary edge has been seen, and the rest of the work depends only on the
+ * length of the boundary.
+ *
+ * @param boundaryData The Boundaries object where the results will be stored
+ */
+void BoundaryFinder::FindBoundaries(Boundaries *boundaryData)
+{
+	if (!boundaryData || !IsTracking())
+		return;
+
+	UpdateZRange();
+
+	boundaryData->innerBoundaryNodes.clear();
+	boundaryData->outerBoundaryNodes.clear();
+	boundaryData->boundaryLoops.clear();
+	boundaryData->numElements = numSelectedElements;
+	boundaryData->numNodes = numSelectedNodes;
+	boundaryData->minZ = minZ;
+	boundaryData->maxZ = maxZ;
+	boundaryData->boundariesFound = false;
+
+	if (numBoundaryEdges <= 2)
+		return;
+
+	/*
+	 * Gather the flagged edges and build a sorted list of every node that sits
+	 * on a boundary edge
+	 */
+	std::vector<unsigned int> edgeList;
+	edgeList.reserve(numBoundaryEdges);
+	for (unsigned int edge=0; edge<boundaryEdges.size() && edgeList.size() < numBoundaryEdges; ++edge)
+		if (boundaryEdges[edge])
+			edgeList.push_back(edge);
+
+	std::vector<unsigned int> boundaryNodes;
+	boundaryNodes.reserve(2*edgeList.size());
+	for (std::vector<unsigned int>::iterator it = edgeList.begin(); it != edgeList.end(); ++it)
+	{
+		boundaryNodes.push_back(adjacency->GetNode(*it/3, *it%3));
+		boundaryNodes.push_back(adjacency->GetNode(*it/3, (*it%3+1)%3));
+	}
+	std::sort(boundaryNodes.begin(), boundaryNodes.end());
+	boundaryNodes.erase(std::unique(boundaryNodes.begin(), boundaryNodes.end()), boundaryNodes.end());
+
+	if (boundaryNodes.size() <= 2)
+		return;
+
+	/*
+	 * Walk the boundary edges into the outer boundary and any holes
+	 */
+	std::vector<BoundaryEdge> edges;
+	edges.reserve(edgeList.size());
+	for (std::vector<unsigned int>::iterator it = edgeList.begin(); it != edgeList.end(); ++it)
+		edges.push_back(BoundaryEdge(GetNode(*it/3, *it%3), GetNode(*it/3, (*it%3+1)%3)));
+	TraceBoundaryLoops(edges, boundaryData);
+
+	/*
+	 * Create an unordered list of inner boundary nodes. These are the nodes of
+	 * selected elements that touch the boundary but are not on it themselves.
+	 */
+	std::vector<unsigned int> innerNodes;
+	for (std::vector<unsigned int>::iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
+	{
+		const unsigned int *nodeElements = adjacency->GetNodeElements(*it);
+		unsigned int count = adjacency->GetNumNodeElements(*it);
+		for (unsigned int i=0; i<count; ++i)
+		{
+			unsigned int element = nodeElements[i];
+			if (!selected[element])
+				continue;
+
+			for (unsigned int vertex=0; vertex<3; ++vertex)
 			{
-				if (it->second == 1)
-				{
-					nodeAdjacencyOuter[it->first.n1].push_back(it->first.n2);
-					nodeAdjacencyOuter[it->first.n2].push_back(it->first.n1);
-				}
+				unsigned int node = adjacency->GetNode(element, vertex);
+				if (!std::binary_search(boundaryNodes.begin(), boundaryNodes.end(), node))
+					innerNodes.push_back(node+1);
 			}
+		}
+	}
+	std::sort(innerNodes.begin(), innerNodes.end());
+	innerNodes.erase(std::unique(innerNodes.begin(), innerNodes.end()), innerNodes.end());
+	boundaryData->innerBoundaryNodes = innerNodes;
 
+	boundaryData->boundariesFound = true;
+}
 
-			if (nodeAdjacencyOuter.size() > 2)
-			{
 
-				/*
-				 * Starting with the first node in the adjacency list, circle
-				 * around the edge of the selected elements, creating a list
-				 * of boundary nodes
-				 */
+bool BoundaryFinder::IsSelected(unsigned int elementNumber)
+{
+	if (elementNumber == 0 || elementNumber > selected.size())
+		return false;
+	return selected[elementNumber-1] != 0;
+}
 
-				unsigned int previousNode;
-				unsigned int currentNode = nodeAdjacencyOuter.begin()->first;
-				unsigned int nextNode = nodeAdjacencyOuter[currentNode][0];
 
+/**
+ * @brief Returns true if this finder was created for tracking a selection
+ */
+bool BoundaryFinder::IsTracking()
+{
+	return elements && adjacency && !selected.empty();
+}
 
-				for (unsigned int i=0; i<nodeAdjacencyOuter.size(); ++i)
-				{
-					// Push back current node
-					boundaryData->outerBoundaryNodes.push_back(currentNode);
 
-					// Set up next iteration
-					previousNode = currentNode;
-					currentNode = nextNode;
+/**
+ * @brief A side is on the boundary of the selection if its element is selected
+ * and the element on the other side is not
+ */
+bool BoundaryFinder::IsBoundaryEdge(unsigned int element, unsigned int side)
+{
+	if (!selected[element])
+		return false;
+	unsigned int neighbor = adjacency->GetNeighbor(element, side);
+	return neighbor == MeshAdjacency::NoNeighbor || !selected[neighbor];
+}
 
-					if (nodeAdjacencyOuter[currentNode][0] == previousNode)
-						nextNode = nodeAdjacencyOuter[currentNode][1];
-					else
-						nextNode = nodeAdjacencyOuter[currentNode][0];
-				}
 
+/**
+ * @brief Sets the boundary flag of one element side, keeping the count of
+ * boundary edges up to date
+ * @param edge The side, as 3*element+side
+ */
+void BoundaryFinder::SetBoundaryEdge(unsigned int edge, bool onBoundary)
+{
+	if (boundaryEdges[edge] == (unsigned char)onBoundary)
+		return;
+
+	boundaryEdges[edge] = onBoundary;
+	if (onBoundary)
+		++numBoundaryEdges;
+	else
+		--numBoundaryEdges;
+}
 
-				/*
-				 * Create an unordered list of inner boundary nodes
-				 */
 
-				std::set<unsigned int> innerBoundaryNodes;
+/**
+ * @brief Re-examines the three sides of an element that was just added or removed
+ *
+ * Each side is shared with at most one other element, so the shared side is
+ * re-examined from the neighbor's point of view as well.
+ */
+void BoundaryFinder::UpdateBoundaryEdges(unsigned int element)
+{
+	for (unsigned int side=0; side<3; ++side)
+	{
+		SetBoundaryEdge(3*element+side, IsBoundaryEdge(element, side));
 
-				Element *currElement = 0;
-				for (std::vector<Element*>::iterator elementIterator = elements.begin();
-				     elementIterator != elements.end();
-				     ++elementIterator)
-				{
-					currElement = *elementIterator;
-					if (currElement)
-					{
-						int n1 = currElement->n1->nodeNumber;
-						int n2 = currElement->n2->nodeNumber;
-						int n3 = currElement->n3->nodeNumber;
-						int n1i = nodeAdjacencyOuter.count(n1);
-						int n2i = nodeAdjacencyOuter.count(n2);
-						int n3i = nodeAdjacencyOuter.count(n3);
-						int sum = n1i+n2i+n3i;
-
-						if (sum > 0 && sum < 3)
-						{
-							if (n1i == 0)
-							{
-								innerBoundaryNodes.insert(n1);
-							}
-							if (n2i == 0)
-							{
-								innerBoundaryNodes.insert(n2);
-							}
-							if (n3i == 0)
-							{
-								innerBoundaryNodes.insert(n3);
-							}
-						}
-					}
-				}
+		unsigned int neighbor = adjacency->GetNeighbor(element, side);
+		if (neighbor != MeshAdjacency::NoNeighbor)
+		{
+			unsigned int neighborSide = adjacency->GetNeighborSide(element, side);
+			SetBoundaryEdge(3*neighbor+neighborSide, IsBoundaryEdge(neighbor, neighborSide));
+		}
+	}
+}
 
-				for (std::set<unsigned int>::iterator it = innerBoundaryNodes.begin();
-				     it != innerBoundaryNodes.end();
-				     ++it)
-				{
-					boundaryData->innerBoundaryNodes.push_back(*it);
-				}
 
-				boundaryData->boundariesFound = true;
+/**
+ * @brief Adds a newly selected node to the depth heaps
+ *
+ * A node that was dropped from the selection keeps its entries until they
+ * reach the top of a heap, so it is only pushed onto the heaps it has no
+ * entry in. Each heap holds at most one entry per node.
+ */
+void BoundaryFinder::AddNodeDepth(unsigned int node, float z)
+{
+	if (!(nodeInHeaps[node] & InMinZHeap))
+	{
+		minZHeap.push_back(NodeDepth(z, node));
+		std::push_heap(minZHeap.begin(), minZHeap.end(), DeeperThan);
+		nodeInHeaps[node] |= InMinZHeap;
+	}
+	if (!(nodeInHeaps[node] & InMaxZHeap))
+	{
+		maxZHeap.push_back(NodeDepth(z, node));
+		std::push_heap(maxZHeap.begin(), maxZHeap.end(), ShallowerThan);
+		nodeInHeaps[node] |= InMaxZHeap;
+	}
+}
+
+
+/**
+ * @brief Finds the depth range of the selection from the tops of the depth heaps
+ *
+ * Entries of nodes that are no longer selected are popped off as they reach
+ * the top, so each removal is paid for once.
+ */
+void BoundaryFinder::UpdateZRange()
+{
+	while (!minZHeap.empty() && nodeUseCount[minZHeap.front().node] == 0)
+	{
+		nodeInHeaps[minZHeap.front().node] &= ~InMinZHeap;
+		std::pop_heap(minZHeap.begin(), minZHeap.end(), DeeperThan);
+		minZHeap.pop_back();
+	}
+	while (!maxZHeap.empty() && nodeUseCount[maxZHeap.front().node] == 0)
+	{
+		nodeInHeaps[maxZHeap.front().node] &= ~InMaxZHeap;
+		std::pop_heap(maxZHeap.begin(), maxZHeap.end(), ShallowerThan);
+		maxZHeap.pop_back();
+	}
+
+	minZ = minZHeap.empty() ? 99999 : minZHeap.front().z;
+	maxZ = maxZHeap.empty() ? -99999 : maxZHeap.front().z;
+}
+
 
-			} else {
-				boundaryData->boundariesFound = false;
+/**
+ * @brief Walks a set of directed boundary edges into closed loops
+ *
+ * The edges are sorted by their starting node, which turns them into a flat
+ * adjacency array. Every edge that has not been walked yet starts a new loop.
+ * The loop enclosing the largest area is the outer boundary and is stored
+ * first in boundaryLoops; the others are holes in the selection.
+ *
+ * @param edges The boundary edges, oriented in the winding direction of their elements
+ * @param boundaryData The Boundaries object where the loops will be stored
+ */
+void BoundaryFinder::TraceBoundaryLoops(std::vector<BoundaryEdge> &edges, Boundaries *boundaryData)
+{
+	std::sort(edges.begin(), edges.end(), EdgeStartsBefore);
+
+	std::vector<unsigned char> used (edges.size(), 0);
+	std::vector<std::vector<unsigned int> > &loops = boundaryData->boundaryLoops;
+	unsigned int outerLoop = 0;
+	double outerArea = -1.0;
+
+	for (unsigned int first=0; first<edges.size(); ++first)
+	{
+		if (used[first])
+			continue;
+
+		loops.push_back(std::vector<unsigned int>());
+		std::vector<unsigned int> &loop = loops.back();
+		unsigned int startNode = edges[first].from->nodeNumber;
+		unsigned int current = first;
+		double area = 0.0;
+
+		while (true)
+		{
+			used[current] = 1;
+			const BoundaryEdge &edge = edges[current];
+			loop.push_back(edge.from->nodeNumber);
+			area += (double)edge.from->x*edge.to->y - (double)edge.to->x*edge.from->y;
+
+			if (edge.to->nodeNumber == startNode)
+				break;
+
+			/*
+			 * Find an edge leaving the end of this one that has not been walked yet.
+			 * Where two parts of the boundary touch at a single node, take the edge
+			 * with the smallest clockwise turn from the incoming edge, which keeps
+			 * the walk on the part of the selection it is already bordering.
+			 */
+			std::vector<BoundaryEdge>::iterator it = std::lower_bound(edges.begin(), edges.end(),
+										  BoundaryEdge(edge.to, edge.to),
+										  EdgeStartsBefore);
+			unsigned int next = edges.size();
+			double smallestTurn = 0.0;
+			for (; it != edges.end() && it->from->nodeNumber == edge.to->nodeNumber; ++it)
+			{
+				if (used[it-edges.begin()])
+					continue;
+				double turn = ClockwiseTurn(edge, *it);
+				if (next == edges.size() || turn < smallestTurn)
+				{
+					next = it-edges.begin();
+					smallestTurn = turn;
+				}
 			}
+			if (next == edges.size())
+				break;
+			current = next;
+		}
 
-		} else {
-			boundaryData->boundariesFound = false;
+		if (fabs(area) > outerArea)
+		{
+			outerArea = fabs(area);
+			outerLoop = loops.size()-1;
 		}
 	}
+
+	if (!loops.empty())
+	{
+		loops[outerLoop].swap(loops[0]);
+		boundaryData->outerBoundaryNodes = loops[0];
+	}
 }
 
 
+Node* BoundaryFinder::GetNode(unsigned int element, unsigned int vertex)
+{
+	Element &currElement = (*elements)[element];
+	if (vertex == 0)
+		return currElement.n1;
+	else if (vertex == 1)
+		return currElement.n2;
+	return currElement.n3;
+}
+
 /////////////    Pretty good code for ordered inner boundary    ///////////////
 //
 //				/*
@@ -2,49 +2,100 @@
 #define BOUNDARYFINDER_H
 
 #include <vector>
-#include <map>
-#include <set>
 #include <algorithm>
+#include <cmath>
+
+#include <QThread>
+#include <QtConcurrentMap>
 
 #include "adcData.h"
+#include "SubdomainTools/MeshAdjacency.h"
+
+/**
+ * @brief A directed boundary edge, oriented in the winding direction of the
+ * selected element it belongs to
+ */
+struct BoundaryEdge
+{
+		Node	*from;
+		Node	*to;
+		BoundaryEdge() : from(0), to(0) {}
+		BoundaryEdge(Node *first, Node *second) : from(first), to(second) {}
+};
+
 
-struct Edge
+/**
+ * @brief The depth of a selected node, as stored in the depth heaps of a
+ * BoundaryFinder
+ */
+struct NodeDepth
 {
-		unsigned int n1;
-		unsigned int n2;
-		Edge() : n1(0), n2(0) {}
-		Edge(unsigned int first, unsigned int second)
-		{
-			if (first < second)
-			{
-				n1 = first;
-				n2 = second;
-			} else {
-				n1 = second;
-				n2 = first;
-			}
-		}
-		bool operator== (const Edge &e1) const{
-			return (n1 == e1.n1 && n2 == e1.n2);
-		}
-		bool operator< (const Edge &e1) const{
-			if (n1 == e1.n1)
-				return n2 < e1.n2;
-			return n1 < e1.n1;
-		}
+		float		z;
+		unsigned int	node;
+		NodeDepth() : z(0.0), node(0) {}
+		NodeDepth(float depth, unsigned int nodeIndex) : z(depth), node(nodeIndex) {}
 };
 
 
+/**
+ * @brief Finds the boundary of a set of selected elements
+ *
+ * Can be used in two ways:
+ *
+ * - PerformBoundarySearch() traces the boundary of an arbitrary list of
+ *   elements from scratch. Edges are packed into 64-bit keys and sorted in
+ *   parallel, so large selections use every core and no ordered maps.
+ * - When constructed with the mesh's MeshAdjacency, the finder keeps track
+ *   of a selection that changes over time. AddElements() and RemoveElements()
+ *   only touch the edges, nodes and depths of the elements passed in, and
+ *   FindBoundaries() walks the tracked boundary edges without looking at
+ *   the interior of the selection.
+ *
+ */
 class BoundaryFinder
 {
 	public:
 		/* Constructor */
 		BoundaryFinder();
+		BoundaryFinder(std::vector<Element> *meshElements, MeshAdjacency *meshAdjacency);
 		~BoundaryFinder();
 
 		/* The Callable Search Function */
-		void	PerformBoundarySearch(std::vector<Element*> elements, Boundaries *boundaryData);
+		void	PerformBoundarySearch(const std::vector<Element*> &elements, Boundaries *boundaryData);
+
+		/* Incremental Selection Tracking */
+		void	AddElements(const std::vector<Element*> &newElements);
+		void	RemoveElements(const std::vector<Element*> &oldElements);
+		void	FindBoundaries(Boundaries *boundaryData);
+		bool	IsSelected(unsigned int elementNumber);
+		bool	IsTracking();
+
+	private:
+
+		std::vector<Element>*		elements;
+		MeshAdjacency*			adjacency;
+
+		std::vector<unsigned char>	selected;	/**< Selection flag for every mesh element */
+		std::vector<unsigned int>	nodeUseCount;	/**< Number of selected elements using each node */
+		std::vector<unsigned char>	boundaryEdges;	/**< Boundary flag for every element side, at 3*element+side */
+		unsigned int			numBoundaryEdges;
+		unsigned int			numSelectedElements;
+		unsigned int			numSelectedNodes;
+
+		/* Depth Range */
+		std::vector<NodeDepth>		minZHeap;	/**< Selected nodes with the shallowest on top, plus stale entries */
+		std::vector<NodeDepth>		maxZHeap;	/**< Selected nodes with the deepest on top, plus stale entries */
+		std::vector<unsigned char>	nodeInHeaps;	/**< Which heaps hold an entry for each node */
+		float				minZ;
+		float				maxZ;
 
+		bool		IsBoundaryEdge(unsigned int element, unsigned int side);
+		void		SetBoundaryEdge(unsigned int edge, bool onBoundary);
+		void		UpdateBoundaryEdges(unsigned int element);
+		void		AddNodeDepth(unsigned int node, float z);
+		void		UpdateZRange();
+		void		TraceBoundaryLoops(std::vector<BoundaryEdge> &edges, Boundaries *boundaryData);
+		Node*		GetNode(unsigned int element, unsigned int vertex);
 };
 
 #endif // BOUNDARYFINDER_H
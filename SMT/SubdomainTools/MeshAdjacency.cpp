@@ -0,0 +1,188 @@
+#include "MeshAdjacency.h"
+
+const unsigned int MeshAdjacency::NoNeighbor;
+
+
+/**
+ * @brief Builds all topology tables for the given mesh
+ * @param elements The full list of mesh Elements, ordered by element number
+ * @param numNodes The number of Nodes in the mesh
+ */
+MeshAdjacency::MeshAdjacency(std::vector<Element> *elements, unsigned int numNodes) :
+	numElements(0),
+	numNodes(numNodes),
+	elementNodes(),
+	elementNeighbors(),
+	nodeElementOffsets(),
+	nodeElements()
+{
+	if (elements)
+	{
+		numElements = elements->size();
+		elementNodes.resize(3*numElements);
+		for (unsigned int i=0; i<numElements; ++i)
+		{
+			Element &currElement = (*elements)[i];
+			elementNodes[3*i+0] = currElement.n1->nodeNumber-1;
+			elementNodes[3*i+1] = currElement.n2->nodeNumber-1;
+			elementNodes[3*i+2] = currElement.n3->nodeNumber-1;
+		}
+
+		BuildNodeElements();
+		BuildNeighbors();
+	}
+}
+
+
+MeshAdjacency::~MeshAdjacency()
+{
+}
+
+
+unsigned int MeshAdjacency::GetNumElements()
+{
+	return numElements;
+}
+
+
+unsigned int MeshAdjacency::GetNumNodes()
+{
+	return numNodes;
+}
+
+
+/**
+ * @brief Returns the 0-based node index of one of an element's vertices
+ * @param element The 0-based element index
+ * @param vertex The vertex (0, 1 or 2)
+ */
+unsigned int MeshAdjacency::GetNode(unsigned int element, unsigned int vertex)
+{
+	return elementNodes[3*element+vertex];
+}
+
+
+/**
+ * @brief Returns the flat array of 3 node indices per element
+ */
+const unsigned int* MeshAdjacency::GetElementNodes()
+{
+	if (elementNodes.empty())
+		return 0;
+	return &elementNodes[0];
+}
+
+
+/**
+ * @brief Returns the element on the other side of one of an element's sides
+ * @param element The 0-based element index
+ * @param side The side (0, 1 or 2)
+ * @return The 0-based index of the neighboring element, or NoNeighbor if the
+ * side is on the mesh boundary
+ */
+unsigned int MeshAdjacency::GetNeighbor(unsigned int element, unsigned int side)
+{
+	return elementNeighbors[3*element+side];
+}
+
+
+/**
+ * @brief Returns the side of the neighboring element that is shared with
+ * the given element side
+ * @return The side (0, 1 or 2) of the neighbor, or NoNeighbor
+ */
+unsigned int MeshAdjacency::GetNeighborSide(unsigned int element, unsigned int side)
+{
+	unsigned int neighbor = elementNeighbors[3*element+side];
+	if (neighbor != NoNeighbor)
+	{
+		for (unsigned int i=0; i<3; ++i)
+			if (elementNeighbors[3*neighbor+i] == element)
+				return i;
+	}
+	return NoNeighbor;
+}
+
+
+unsigned int MeshAdjacency::GetNumNodeElements(unsigned int node)
+{
+	return nodeElementOffsets[node+1] - nodeElementOffsets[node];
+}
+
+
+/**
+ * @brief Returns the list of elements that use a node
+ *
+ * Use GetNumNodeElements() to get the length of the list.
+ *
+ * @param node The 0-based node index
+ */
+const unsigned int* MeshAdjacency::GetNodeElements(unsigned int node)
+{
+	if (nodeElements.empty())
+		return 0;
+	return &nodeElements[nodeElementOffsets[node]];
+}
+
+
+/**
+ * @brief Builds the node to element lists with a counting pass followed
+ * by a fill pass
+ */
+void MeshAdjacency::BuildNodeElements()
+{
+	nodeElementOffsets.assign(numNodes+1, 0);
+	for (unsigned int i=0; i<3*numElements; ++i)
+		++nodeElementOffsets[elementNodes[i]+1];
+	for (unsigned int i=0; i<numNodes; ++i)
+		nodeElementOffsets[i+1] += nodeElementOffsets[i];
+
+	std::vector<unsigned int> fillPosition (nodeElementOffsets.begin(), nodeElementOffsets.end()-1);
+	nodeElements.resize(3*numElements);
+	for (unsigned int i=0; i<3*numElements; ++i)
+		nodeElements[fillPosition[elementNodes[i]]++] = i/3;
+}
+
+
+/**
+ * @brief Finds the neighbor across each element side by searching the
+ * (short) element list of the side's first node for another element
+ * that contains the side's second node
+ */
+void MeshAdjacency::BuildNeighbors()
+{
+	elementNeighbors.assign(3*numElements, NoNeighbor);
+	for (unsigned int i=0; i<numElements; ++i)
+	{
+		for (unsigned int side=0; side<3; ++side)
+		{
+			if (elementNeighbors[3*i+side] != NoNeighbor)
+				continue;
+
+			unsigned int a = elementNodes[3*i+side];
+			unsigned int b = elementNodes[3*i+(side+1)%3];
+			for (unsigned int j=nodeElementOffsets[a]; j<nodeElementOffsets[a+1]; ++j)
+			{
+				unsigned int other = nodeElements[j];
+				if (other == i)
+					continue;
+
+				// Find the side of the other element that connects a and b
+				for (unsigned int otherSide=0; otherSide<3; ++otherSide)
+				{
+					unsigned int c = elementNodes[3*other+otherSide];
+					unsigned int d = elementNodes[3*other+(otherSide+1)%3];
+					if ((c == a && d == b) || (c == b && d == a))
+					{
+						elementNeighbors[3*i+side] = other;
+						elementNeighbors[3*other+otherSide] = i;
+						break;
+					}
+				}
+
+				if (elementNeighbors[3*i+side] != NoNeighbor)
+					break;
+			}
+		}
+	}
+}
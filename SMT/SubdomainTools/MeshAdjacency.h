@@ -0,0 +1,57 @@
+#ifndef MESHADJACENCY_H
+#define MESHADJACENCY_H
+
+#include <vector>
+
+#include "adcData.h"
+
+
+/**
+ * @brief Flat topology tables for a full mesh
+ *
+ * Stores the connectivity of a mesh as contiguous index arrays so that
+ * selection operations can walk the mesh without chasing Element/Node
+ * pointers or building ordered maps:
+ *
+ * - The three (0-based) node indices of every element
+ * - The element across each of the three sides of every element
+ * - The list of elements that use each node (compressed row storage)
+ *
+ * Side 0 of an element is the edge n1-n2, side 1 is n2-n3 and side 2 is n3-n1.
+ *
+ * Element and node indices are the ADCIRC element/node numbers minus one,
+ * which means Element pointers from any copy of the mesh (e.g. the Quadtree's)
+ * can be used to index into these tables.
+ *
+ */
+class MeshAdjacency
+{
+	public:
+		MeshAdjacency(std::vector<Element> *elements, unsigned int numNodes);
+		~MeshAdjacency();
+
+		static const unsigned int	NoNeighbor = 0xFFFFFFFF;
+
+		unsigned int		GetNumElements();
+		unsigned int		GetNumNodes();
+		unsigned int		GetNode(unsigned int element, unsigned int vertex);
+		const unsigned int*	GetElementNodes();
+		unsigned int		GetNeighbor(unsigned int element, unsigned int side);
+		unsigned int		GetNeighborSide(unsigned int element, unsigned int side);
+		unsigned int		GetNumNodeElements(unsigned int node);
+		const unsigned int*	GetNodeElements(unsigned int node);
+
+	private:
+
+		unsigned int			numElements;
+		unsigned int			numNodes;
+		std::vector<unsigned int>	elementNodes;		/**< 3 node indices per element */
+		std::vector<unsigned int>	elementNeighbors;	/**< 3 neighboring element indices per element */
+		std::vector<unsigned int>	nodeElementOffsets;	/**< Offsets into nodeElements for each node */
+		std::vector<unsigned int>	nodeElements;		/**< Elements that use each node */
+
+		void	BuildNodeElements();
+		void	BuildNeighbors();
+};
+
+#endif // MESHADJACENCY_H
@@ -0,0 +1,371 @@
+#include "MeshRenumberer.h"
+
+
+static const unsigned int NoPosition = 0xFFFFFFFF;
+
+
+/*
+ * Runs a breadth-first search from one node, marking every node it reaches with
+ * the stamp. Returns the number of levels and leaves the nodes of the last
+ * level in lastLevel.
+ */
+static unsigned int FindLevels(const std::vector<unsigned int> &offsets, const std::vector<unsigned int> &adjacency,
+			       unsigned int start, std::vector<unsigned int> &marks, unsigned int stamp,
+			       std::vector<unsigned int> *lastLevel)
+{
+	std::vector<unsigned int> level (1, start);
+	std::vector<unsigned int> nextLevel;
+	unsigned int numLevels = 0;
+	marks[start] = stamp;
+	while (!level.empty())
+	{
+		++numLevels;
+		nextLevel.clear();
+		for (std::vector<unsigned int>::iterator it=level.begin(); it != level.end(); ++it)
+		{
+			for (unsigned int i=offsets[*it]; i<offsets[*it+1]; ++i)
+			{
+				if (marks[adjacency[i]] != stamp)
+				{
+					marks[adjacency[i]] = stamp;
+					nextLevel.push_back(adjacency[i]);
+				}
+			}
+		}
+		if (nextLevel.empty())
+			lastLevel->swap(level);
+		level.swap(nextLevel);
+	}
+	return numLevels;
+}
+
+
+/*
+ * Converts a point on a 2^16 x 2^16 grid to its distance along a Hilbert curve
+ */
+static quint64 HilbertDistance(quint32 x, quint32 y)
+{
+	quint64 distance = 0;
+	for (quint32 side = 1u << 15; side > 0; side /= 2)
+	{
+		quint32 rx = (x & side) > 0;
+		quint32 ry = (y & side) > 0;
+		distance += (quint64)side * side * ((3 * rx) ^ ry);
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = side - 1 - (x & (side - 1));
+				y = side - 1 - (y & (side - 1));
+			}
+			std::swap(x, y);
+		}
+	}
+	return distance;
+}
+
+
+/**
+ * @brief Constructor
+ * @param nodes The subdomain nodes, which are reordered in place
+ * @param elements The subdomain elements, which are reordered in place
+ */
+MeshRenumberer::MeshRenumberer(std::vector<Node*> *nodes, std::vector<Element*> *elements) :
+	nodes(nodes),
+	elements(elements),
+	elementNodes(),
+	adjacencyOffsets(),
+	adjacency(),
+	bandwidthBefore(0),
+	bandwidthAfter(0)
+{
+}
+
+
+MeshRenumberer::~MeshRenumberer()
+{
+}
+
+
+/**
+ * @brief Reorders the node and element lists
+ * @param ordering The new node order
+ * @return false if an element uses a node that isn't in the node list
+ */
+bool MeshRenumberer::Renumber(NodeOrdering ordering)
+{
+	if (!nodes || !elements || nodes->empty() || !BuildElementNodes())
+		return false;
+
+	std::vector<unsigned int> positions (nodes->size());
+	for (unsigned int i=0; i<positions.size(); ++i)
+		positions[i] = i;
+	bandwidthBefore = FindBandwidth(positions);
+
+	std::vector<unsigned int> order;
+	if (ordering == CuthillMcKeeOrdering)
+		FindCuthillMcKeeOrder(&order);
+	else if (ordering == HilbertOrdering)
+		FindHilbertOrder(&order);
+	else
+		order = positions;
+
+	for (unsigned int i=0; i<order.size(); ++i)
+		positions[order[i]] = i;
+	bandwidthAfter = FindBandwidth(positions);
+
+	ApplyOrder(order);
+	return true;
+}
+
+
+unsigned int MeshRenumberer::GetBandwidthBefore()
+{
+	return bandwidthBefore;
+}
+
+
+unsigned int MeshRenumberer::GetBandwidthAfter()
+{
+	return bandwidthAfter;
+}
+
+
+/**
+ * @brief Converts the nodes of every element to positions in the node list
+ */
+bool MeshRenumberer::BuildElementNodes()
+{
+	unsigned int maxNode = 0;
+	for (std::vector<Node*>::iterator it=nodes->begin(); it != nodes->end(); ++it)
+		maxNode = std::max(maxNode, (*it)->nodeNumber);
+
+	std::vector<unsigned int> nodePositions (maxNode+1, NoPosition);
+	for (unsigned int i=0; i<nodes->size(); ++i)
+		nodePositions[(*nodes)[i]->nodeNumber] = i;
+
+	elementNodes.resize(3*elements->size());
+	for (unsigned int i=0; i<elements->size(); ++i)
+	{
+		Node *elementNodeList[3] = {(*elements)[i]->n1, (*elements)[i]->n2, (*elements)[i]->n3};
+		for (unsigned int j=0; j<3; ++j)
+		{
+			unsigned int nodeNumber = elementNodeList[j]->nodeNumber;
+			if (nodeNumber > maxNode || nodePositions[nodeNumber] == NoPosition)
+				return false;
+			elementNodes[3*i+j] = nodePositions[nodeNumber];
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @brief Builds the list of neighboring nodes of every node (compressed row storage)
+ */
+void MeshRenumberer::BuildAdjacency()
+{
+	unsigned int numNodes = nodes->size();
+
+	// Every element adds its two other nodes to each of its nodes
+	std::vector<unsigned int> offsets (numNodes+1, 0);
+	for (unsigned int i=0; i<elementNodes.size(); ++i)
+		offsets[elementNodes[i]+1] += 2;
+	for (unsigned int i=0; i<numNodes; ++i)
+		offsets[i+1] += offsets[i];
+
+	std::vector<unsigned int> neighbors (offsets[numNodes]);
+	std::vector<unsigned int> fill (offsets.begin(), offsets.end()-1);
+	for (unsigned int i=0; i<elementNodes.size(); i+=3)
+	{
+		for (unsigned int j=0; j<3; ++j)
+		{
+			unsigned int node = elementNodes[i+j];
+			neighbors[fill[node]++] = elementNodes[i+(j+1)%3];
+			neighbors[fill[node]++] = elementNodes[i+(j+2)%3];
+		}
+	}
+
+	// Remove the duplicates from each node's list
+	adjacencyOffsets.assign(numNodes+1, 0);
+	adjacency.clear();
+	adjacency.reserve(neighbors.size()/2);
+	for (unsigned int i=0; i<numNodes; ++i)
+	{
+		std::vector<unsigned int>::iterator first = neighbors.begin()+offsets[i];
+		std::vector<unsigned int>::iterator last = neighbors.begin()+offsets[i+1];
+		std::sort(first, last);
+		adjacency.insert(adjacency.end(), first, std::unique(first, last));
+		adjacencyOffsets[i+1] = adjacency.size();
+	}
+}
+
+
+/**
+ * @brief Finds a node on the edge of the seed's part of the mesh
+ *
+ * Uses the George-Liu search for a pseudo-peripheral node: move to the node with
+ * the fewest neighbors in the last level of a breadth-first search for as long as
+ * that makes the search deeper.
+ */
+unsigned int MeshRenumberer::FindStartNode(unsigned int seed, std::vector<unsigned int> &levels, unsigned int *stamp)
+{
+	std::vector<unsigned int> lastLevel;
+	unsigned int start = seed;
+	unsigned int depth = FindLevels(adjacencyOffsets, adjacency, start, levels, ++(*stamp), &lastLevel);
+
+	for (unsigned int iteration=0; iteration<8; ++iteration)
+	{
+		unsigned int candidate = lastLevel[0];
+		for (std::vector<unsigned int>::iterator it=lastLevel.begin(); it != lastLevel.end(); ++it)
+			if (adjacencyOffsets[*it+1]-adjacencyOffsets[*it] < adjacencyOffsets[candidate+1]-adjacencyOffsets[candidate])
+				candidate = *it;
+
+		unsigned int candidateDepth = FindLevels(adjacencyOffsets, adjacency, candidate, levels, ++(*stamp), &lastLevel);
+		if (candidateDepth <= depth)
+			break;
+		start = candidate;
+		depth = candidateDepth;
+	}
+	return start;
+}
+
+
+/**
+ * @brief Finds the reverse Cuthill-McKee order of the nodes
+ *
+ * Each connected part of the mesh is walked breadth-first from a peripheral node,
+ * visiting the neighbors of every node in order of increasing degree. The
+ * combined order is then reversed.
+ */
+void MeshRenumberer::FindCuthillMcKeeOrder(std::vector<unsigned int> *order)
+{
+	BuildAdjacency();
+
+	unsigned int numNodes = nodes->size();
+	std::vector<unsigned char> visited (numNodes, 0);
+	std::vector<unsigned int> levels (numNodes, 0);
+	std::vector<std::pair<unsigned int, unsigned int> > neighbors;
+	unsigned int stamp = 0;
+
+	order->clear();
+	order->reserve(numNodes);
+	for (unsigned int seed=0; seed<numNodes; ++seed)
+	{
+		if (visited[seed])
+			continue;
+
+		unsigned int start = FindStartNode(seed, levels, &stamp);
+		visited[start] = 1;
+		unsigned int next = order->size();
+		order->push_back(start);
+
+		// The order list doubles as the search queue
+		while (next < order->size())
+		{
+			unsigned int node = (*order)[next++];
+			neighbors.clear();
+			for (unsigned int i=adjacencyOffsets[node]; i<adjacencyOffsets[node+1]; ++i)
+			{
+				unsigned int neighbor = adjacency[i];
+				if (!visited[neighbor])
+				{
+					visited[neighbor] = 1;
+					neighbors.push_back(std::make_pair(adjacencyOffsets[neighbor+1]-adjacencyOffsets[neighbor], neighbor));
+				}
+			}
+			std::sort(neighbors.begin(), neighbors.end());
+			for (unsigned int i=0; i<neighbors.size(); ++i)
+				order->push_back(neighbors[i].second);
+		}
+	}
+
+	std::reverse(order->begin(), order->end());
+}
+
+
+/**
+ * @brief Finds the order of the nodes along a Hilbert curve through the
+ * bounding box of the subdomain
+ */
+void MeshRenumberer::FindHilbertOrder(std::vector<unsigned int> *order)
+{
+	float minX = (*nodes)[0]->x, maxX = minX;
+	float minY = (*nodes)[0]->y, maxY = minY;
+	for (std::vector<Node*>::iterator it=nodes->begin(); it != nodes->end(); ++it)
+	{
+		minX = std::min(minX, (*it)->x);
+		maxX = std::max(maxX, (*it)->x);
+		minY = std::min(minY, (*it)->y);
+		maxY = std::max(maxY, (*it)->y);
+	}
+
+	// Use the same scale in both directions so the curve isn't stretched
+	double extent = std::max(maxX - minX, maxY - minY);
+	double scale = extent > 0.0 ? 65535.0 / extent : 0.0;
+
+	std::vector<std::pair<quint64, unsigned int> > distances (nodes->size());
+	for (unsigned int i=0; i<nodes->size(); ++i)
+	{
+		quint32 gridX = (quint32)(((*nodes)[i]->x - minX) * scale);
+		quint32 gridY = (quint32)(((*nodes)[i]->y - minY) * scale);
+		distances[i] = std::make_pair(HilbertDistance(std::min(gridX, 65535u), std::min(gridY, 65535u)), i);
+	}
+	std::sort(distances.begin(), distances.end());
+
+	order->resize(nodes->size());
+	for (unsigned int i=0; i<distances.size(); ++i)
+		(*order)[i] = distances[i].second;
+}
+
+
+/**
+ * @brief Finds the largest difference between the new positions of two nodes
+ * of the same element
+ */
+unsigned int MeshRenumberer::FindBandwidth(const std::vector<unsigned int> &positions)
+{
+	unsigned int bandwidth = 0;
+	for (unsigned int i=0; i<elementNodes.size(); i+=3)
+	{
+		unsigned int a = positions[elementNodes[i]];
+		unsigned int b = positions[elementNodes[i+1]];
+		unsigned int c = positions[elementNodes[i+2]];
+		bandwidth = std::max(bandwidth, std::max(a, std::max(b, c)) - std::min(a, std::min(b, c)));
+	}
+	return bandwidth;
+}
+
+
+/**
+ * @brief Reorders the node list, then sorts the elements by their lowest and
+ * highest node positions
+ */
+void MeshRenumberer::ApplyOrder(const std::vector<unsigned int> &order)
+{
+	std::vector<unsigned int> positions (order.size());
+	std::vector<Node*> newNodes (order.size());
+	for (unsigned int i=0; i<order.size(); ++i)
+	{
+		positions[order[i]] = i;
+		newNodes[i] = (*nodes)[order[i]];
+	}
+	nodes->swap(newNodes);
+
+	std::vector<std::pair<quint64, unsigned int> > keys (elements->size());
+	for (unsigned int i=0; i<elements->size(); ++i)
+	{
+		unsigned int a = positions[elementNodes[3*i]];
+		unsigned int b = positions[elementNodes[3*i+1]];
+		unsigned int c = positions[elementNodes[3*i+2]];
+		quint64 lowest = std::min(a, std::min(b, c));
+		quint64 highest = std::max(a, std::max(b, c));
+		keys[i] = std::make_pair((lowest << 32) | highest, i);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<Element*> newElements (elements->size());
+	for (unsigned int i=0; i<keys.size(); ++i)
+		newElements[i] = (*elements)[keys[i].second];
+	elements->swap(newElements);
+}
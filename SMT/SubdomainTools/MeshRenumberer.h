@@ -0,0 +1,67 @@
+#ifndef MESHRENUMBERER_H
+#define MESHRENUMBERER_H
+
+#include <vector>
+#include <algorithm>
+
+#include <QtGlobal>
+
+#include "adcData.h"
+
+
+/**
+ * @brief The order that subdomain nodes are numbered in
+ */
+enum NodeOrdering {FullDomainOrdering, CuthillMcKeeOrdering, HilbertOrdering};
+
+
+/**
+ * @brief Reorders the nodes and elements of a subdomain before it is numbered
+ *
+ * Subdomain node numbers are assigned in list order, so reordering the node list
+ * changes how far apart the nodes of each element end up in ADCIRC's arrays:
+ *
+ * - CuthillMcKeeOrdering walks the mesh breadth-first from a node on the edge of
+ *   the mesh (reverse Cuthill-McKee), which keeps the bandwidth of the system
+ *   matrix small.
+ * - HilbertOrdering sorts the nodes along a Hilbert curve through their
+ *   coordinates, so nodes that are close together get close numbers.
+ *
+ * The elements are then sorted by their lowest node position. The bandwidth
+ * (largest difference between the positions of two nodes of the same element)
+ * is measured before and after so it can be reported.
+ *
+ * Only the order of the two lists changes, so every file that is numbered
+ * through the py.140 and py.141 tables built from them stays consistent.
+ *
+ */
+class MeshRenumberer
+{
+	public:
+		MeshRenumberer(std::vector<Node*> *nodes, std::vector<Element*> *elements);
+		~MeshRenumberer();
+
+		bool		Renumber(NodeOrdering ordering);
+		unsigned int	GetBandwidthBefore();
+		unsigned int	GetBandwidthAfter();
+
+	private:
+
+		std::vector<Node*>*		nodes;
+		std::vector<Element*>*		elements;
+		std::vector<unsigned int>	elementNodes;		/**< 3 positions in the node list per element */
+		std::vector<unsigned int>	adjacencyOffsets;	/**< Offsets into adjacency for each node */
+		std::vector<unsigned int>	adjacency;		/**< Nodes that share an element with each node */
+		unsigned int			bandwidthBefore;
+		unsigned int			bandwidthAfter;
+
+		bool		BuildElementNodes();
+		void		BuildAdjacency();
+		unsigned int	FindStartNode(unsigned int seed, std::vector<unsigned int> &levels, unsigned int *stamp);
+		void		FindCuthillMcKeeOrder(std::vector<unsigned int> *order);
+		void		FindHilbertOrder(std::vector<unsigned int> *order);
+		unsigned int	FindBandwidth(const std::vector<unsigned int> &positions);
+		void		ApplyOrder(const std::vector<unsigned int> &order);
+};
+
+#endif // MESHRENUMBERER_H
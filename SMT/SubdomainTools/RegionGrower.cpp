@@ -0,0 +1,227 @@
+#include "RegionGrower.h"
+
+
+static const unsigned char UnselectedMark = 0;
+static const unsigned char SelectedMark = 1;
+static const unsigned char VisitedMark = 2;
+
+
+/*
+ * A slice of the current frontier. Each chunk only reads the marks and writes
+ * the elements it could enter into its own candidate list.
+ */
+struct FrontierChunk
+{
+		const unsigned int		*frontier;
+		unsigned int			begin;
+		unsigned int			end;
+		MeshAdjacency			*adjacency;
+		Element				*elements;
+		const unsigned char		*marks;
+		unsigned char			enterMark;
+		bool				throughNodes;
+		bool				useDepthLimit;
+		float				depthLimit;
+		bool				belowLimit;
+		std::vector<unsigned int>	candidates;
+};
+
+
+static bool PassesDepthLimit(const FrontierChunk &chunk, unsigned int element)
+{
+	if (!chunk.useDepthLimit)
+		return true;
+	const Element &currElement = chunk.elements[element];
+	return (currElement.n1->z < chunk.depthLimit) == chunk.belowLimit &&
+	       (currElement.n2->z < chunk.depthLimit) == chunk.belowLimit &&
+	       (currElement.n3->z < chunk.depthLimit) == chunk.belowLimit;
+}
+
+
+static void FindCandidates(FrontierChunk &chunk)
+{
+	for (unsigned int i=chunk.begin; i<chunk.end; ++i)
+	{
+		unsigned int element = chunk.frontier[i];
+		if (chunk.throughNodes)
+		{
+			for (unsigned int vertex=0; vertex<3; ++vertex)
+			{
+				unsigned int node = chunk.adjacency->GetNode(element, vertex);
+				const unsigned int *nodeElements = chunk.adjacency->GetNodeElements(node);
+				unsigned int count = chunk.adjacency->GetNumNodeElements(node);
+				for (unsigned int j=0; j<count; ++j)
+					if (chunk.marks[nodeElements[j]] == chunk.enterMark && PassesDepthLimit(chunk, nodeElements[j]))
+						chunk.candidates.push_back(nodeElements[j]);
+			}
+		} else {
+			for (unsigned int side=0; side<3; ++side)
+			{
+				unsigned int neighbor = chunk.adjacency->GetNeighbor(element, side);
+				if (neighbor != MeshAdjacency::NoNeighbor && chunk.marks[neighbor] == chunk.enterMark && PassesDepthLimit(chunk, neighbor))
+					chunk.candidates.push_back(neighbor);
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Constructor
+ * @param meshAdjacency The adjacency tables of the mesh
+ * @param meshElements The element list that results will point into
+ */
+RegionGrower::RegionGrower(MeshAdjacency *meshAdjacency, std::vector<Element> *meshElements) :
+	adjacency(meshAdjacency),
+	elements(meshElements),
+	marks()
+{
+}
+
+
+RegionGrower::~RegionGrower()
+{
+}
+
+
+/**
+ * @brief Finds the elements within a number of node rings of a selection
+ * @param selection The currently selected elements
+ * @param numRings The number of rings to grow by
+ * @return The elements that would be added to the selection, sorted by element number
+ */
+std::vector<Element*> RegionGrower::GrowRings(const std::vector<Element*> &selection, unsigned int numRings)
+{
+	std::vector<unsigned int> region;
+	if (!IsReady() || selection.empty() || numRings == 0)
+		return ToElements(region);
+
+	MarkSelection(selection);
+
+	std::vector<unsigned int> frontier;
+	frontier.reserve(selection.size());
+	for (std::vector<Element*>::const_iterator it = selection.begin(); it != selection.end(); ++it)
+		if (*it && (*it)->elementNumber-1 < marks.size())
+			frontier.push_back((*it)->elementNumber-1);
+
+	for (unsigned int ring=0; ring<numRings && !frontier.empty(); ++ring)
+		ExpandFrontier(&frontier, true, UnselectedMark, false, 0.0, false, &region);
+
+	return ToElements(region);
+}
+
+
+/**
+ * @brief Finds the connected region around a seed element
+ *
+ * The region only contains elements with the same selection state as the seed
+ * and spreads across element sides, so it stops at the boundary of the existing
+ * selection. With a depth limit, it also stops at elements that have a node on
+ * the other side of the depth contour than the seed element's center.
+ *
+ * @param seed The element that was clicked
+ * @param selection The currently selected elements
+ * @param useDepthLimit Whether the depth contour should stop the fill
+ * @param depthLimit The depth of the contour
+ * @return The elements in the region, including the seed, sorted by element number
+ */
+std::vector<Element*> RegionGrower::FloodFill(Element *seed, const std::vector<Element*> &selection, bool useDepthLimit, float depthLimit)
+{
+	std::vector<unsigned int> region;
+	if (!IsReady() || !seed || seed->elementNumber == 0 || seed->elementNumber > marks.size())
+		return ToElements(region);
+
+	MarkSelection(selection);
+
+	unsigned int seedIndex = seed->elementNumber-1;
+	unsigned char enterMark = marks[seedIndex];
+	bool belowLimit = (seed->n1->z + seed->n2->z + seed->n3->z)/3.0 < depthLimit;
+
+	marks[seedIndex] = VisitedMark;
+	region.push_back(seedIndex);
+
+	std::vector<unsigned int> frontier (1, seedIndex);
+	while (!frontier.empty())
+		ExpandFrontier(&frontier, false, enterMark, useDepthLimit, depthLimit, belowLimit, &region);
+
+	return ToElements(region);
+}
+
+
+bool RegionGrower::IsReady()
+{
+	if (!adjacency || !elements || elements->size() != adjacency->GetNumElements())
+		return false;
+	marks.assign(adjacency->GetNumElements(), UnselectedMark);
+	return true;
+}
+
+
+void RegionGrower::MarkSelection(const std::vector<Element*> &selection)
+{
+	for (std::vector<Element*>::const_iterator it = selection.begin(); it != selection.end(); ++it)
+		if (*it && (*it)->elementNumber-1 < marks.size())
+			marks[(*it)->elementNumber-1] = SelectedMark;
+}
+
+
+/**
+ * @brief Replaces the frontier with the elements that can be entered from it
+ *
+ * Neighbors are looked up in parallel. The candidate lists may contain the
+ * same element more than once, so elements are claimed afterwards in a single
+ * sequential pass that also appends them to the region.
+ */
+void RegionGrower::ExpandFrontier(std::vector<unsigned int> *frontier, bool throughNodes, unsigned char enterMark,
+				  bool useDepthLimit, float depthLimit, bool belowLimit, std::vector<unsigned int> *region)
+{
+	unsigned int numThreads = std::max(QThread::idealThreadCount(), 1);
+	unsigned int numChunks = std::min(4*numThreads, (unsigned int)frontier->size()/1024 + 1);
+
+	std::vector<FrontierChunk> chunks (numChunks);
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		chunks[i].frontier = &(*frontier)[0];
+		chunks[i].begin = (quint64)frontier->size()*i/numChunks;
+		chunks[i].end = (quint64)frontier->size()*(i+1)/numChunks;
+		chunks[i].adjacency = adjacency;
+		chunks[i].elements = &(*elements)[0];
+		chunks[i].marks = &marks[0];
+		chunks[i].enterMark = enterMark;
+		chunks[i].throughNodes = throughNodes;
+		chunks[i].useDepthLimit = useDepthLimit;
+		chunks[i].depthLimit = depthLimit;
+		chunks[i].belowLimit = belowLimit;
+	}
+
+	if (numChunks == 1)
+		FindCandidates(chunks[0]);
+	else
+		QtConcurrent::blockingMap(chunks, FindCandidates);
+
+	frontier->clear();
+	for (unsigned int i=0; i<numChunks; ++i)
+	{
+		std::vector<unsigned int> &candidates = chunks[i].candidates;
+		for (std::vector<unsigned int>::iterator it = candidates.begin(); it != candidates.end(); ++it)
+		{
+			if (marks[*it] == enterMark)
+			{
+				marks[*it] = VisitedMark;
+				frontier->push_back(*it);
+				region->push_back(*it);
+			}
+		}
+	}
+}
+
+
+std::vector<Element*> RegionGrower::ToElements(std::vector<unsigned int> &region)
+{
+	std::sort(region.begin(), region.end());
+	std::vector<Element*> result;
+	result.reserve(region.size());
+	for (std::vector<unsigned int>::iterator it = region.begin(); it != region.end(); ++it)
+		result.push_back(&(*elements)[*it]);
+	return result;
+}
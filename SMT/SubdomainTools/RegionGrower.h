@@ -0,0 +1,56 @@
+#ifndef REGIONGROWER_H
+#define REGIONGROWER_H
+
+#include <vector>
+#include <algorithm>
+
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include "adcData.h"
+#include "SubdomainTools/MeshAdjacency.h"
+
+
+/**
+ * @brief Grows a selection through the topology of the mesh
+ *
+ * Supports two operations that can't be done with the geometric tools:
+ *
+ * - GrowRings() finds the elements within N rings of a selection, where one
+ *   ring is every element that shares a node with the elements found so far.
+ * - FloodFill() finds the connected region of elements around a seed element
+ *   that have the same selection state as the seed. It stops at the existing
+ *   selection boundary, at the edge of the mesh and, optionally, at a depth
+ *   contour.
+ *
+ * Both are breadth-first expansions. Each frontier is split into chunks that
+ * look up their neighbors on separate threads, and the new elements are then
+ * claimed in a single pass, so no locking is needed.
+ *
+ * Elements are returned as pointers into the element list passed to the
+ * constructor, which should be the list that the other selection tools use.
+ *
+ */
+class RegionGrower
+{
+	public:
+		RegionGrower(MeshAdjacency *meshAdjacency, std::vector<Element> *meshElements);
+		~RegionGrower();
+
+		std::vector<Element*>	GrowRings(const std::vector<Element*> &selection, unsigned int numRings);
+		std::vector<Element*>	FloodFill(Element *seed, const std::vector<Element*> &selection, bool useDepthLimit, float depthLimit);
+
+	private:
+
+		MeshAdjacency*			adjacency;
+		std::vector<Element>*		elements;
+		std::vector<unsigned char>	marks;		/**< State of every element during an expansion */
+
+		bool	IsReady();
+		void	MarkSelection(const std::vector<Element*> &selection);
+		void	ExpandFrontier(std::vector<unsigned int> *frontier, bool throughNodes, unsigned char enterMark,
+				       bool useDepthLimit, float depthLimit, bool belowLimit, std::vector<unsigned int> *region);
+		std::vector<Element*>	ToElements(std::vector<unsigned int> &region);
+};
+
+#endif // REGIONGROWER_H
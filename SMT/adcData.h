@@ -92,6 +92,7 @@ struct Boundaries
 		bool				boundariesFound;
 		std::vector<unsigned int>	innerBoundaryNodes;
 		std::vector<unsigned int>	outerBoundaryNodes;
+		std::vector<std::vector<unsigned int> >	boundaryLoops;	/**< Every closed boundary loop, outer loop first */
 
 		/*
 		 * These values actually apply to an entire selection
@@ -106,6 +107,7 @@ struct Boundaries
 			boundariesFound(false),
 			innerBoundaryNodes(),
 			outerBoundaryNodes(),
+			boundaryLoops(),
 			numNodes(0),
 			numElements(0),
 			minZ(99999),
@@ -113,6 +115,39 @@ struct Boundaries
 };
 
 
+/**
+ * @brief One node's record in a timestep of a full domain boundary condition file
+ * (fort.065, fort.066 or fort.067)
+ *
+ * The data points into the reader's buffer and includes the record's final newline.
+ */
+struct BoundaryRecord
+{
+		unsigned int	node;		/**< The full domain node number of the record */
+		const char*	data;
+		unsigned int	length;
+};
+
+
+/**
+ * @brief One timestep of a full domain boundary condition file
+ *
+ * A view into the reader's buffer, which is only valid until the next timestep
+ * is read. Records are in file order.
+ */
+struct BoundaryTimestep
+{
+		const char*			timeLine;	/**< The time line of the timestep, without its newline */
+		unsigned int			timeLineLength;
+		std::vector<BoundaryRecord>	records;
+
+		BoundaryTimestep() :
+			timeLine(0),
+			timeLineLength(0),
+			records() {}
+};
+
+
 /**
  * @brief Types of actions that the user can perform
  *
@@ -128,7 +163,7 @@ enum ActionType {DisplayAction, SelectionAction};
  * Types of tools that the user can use.
  *
  */
-enum ToolType {ClickToolType, CircleToolType, RectangleToolType, PolygonToolType};
+enum ToolType {ClickToolType, CircleToolType, RectangleToolType, PolygonToolType, AttributeToolType, FloodFillToolType};
 
 
 /**